@@ -0,0 +1,118 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "benchmarkreport.h"
+
+/* Constructor */
+BenchmarkReport::BenchmarkReport(int threads)
+{
+    /* Assign threads count */
+    this->threads_count = threads;
+}
+
+/* Function to add a benchmark result (work is the amount of unit per iteration, samples in nanoseconds) */
+void BenchmarkReport::add(QString name,
+                          QString size,
+                          QString unit,
+                          double work,
+                          QVector<qint64> samples)
+{
+    /* Check samples */
+    if( samples.isEmpty() )
+        return;
+
+    /* Sort samples */
+    std::sort( samples.begin(), samples.end() );
+
+    /* Compute mean time */
+    double total = 0.0;
+    foreach(qint64 sample, samples)
+        total += sample;
+    double mean = total / samples.size();
+
+    /* Compute time percentiles (in milliseconds) */
+    QJsonObject times;
+    times["min"] = samples.first() / 1e6;
+    times["mean"] = mean / 1e6;
+    times["p50"] = BenchmarkReport::percentile( samples, 0.50 ) / 1e6;
+    times["p90"] = BenchmarkReport::percentile( samples, 0.90 ) / 1e6;
+    times["p99"] = BenchmarkReport::percentile( samples, 0.99 ) / 1e6;
+    times["max"] = samples.last() / 1e6;
+
+    /* Compute throughput (unit per second, median and best iterations) */
+    QJsonObject throughput;
+    throughput["p50"] = work / ( BenchmarkReport::percentile( samples, 0.50 ) / 1e9 );
+    throughput["best"] = work / ( qMax( samples.first(), (qint64) 1 ) / 1e9 );
+
+    /* Append result */
+    QJsonObject result;
+    result["name"] = name;
+    result["size"] = size;
+    result["unit"] = unit;
+    result["work"] = work;
+    result["iterations"] = samples.size();
+    result["time_ms"] = times;
+    result["throughput"] = throughput;
+    this->results.append( result );
+}
+
+/* Function to get the report as JSON */
+QByteArray BenchmarkReport::toJson()
+{
+    /* Report root */
+    QJsonObject report;
+    report["suite"] = QString("yafdb-bench");
+    report["date"] = QDateTime::currentDateTimeUtc().toString( Qt::ISODate );
+    report["cpu"] = QSysInfo::currentCpuArchitecture();
+    report["threads"] = this->threads_count;
+    report["results"] = this->results;
+
+    /* Return document */
+    return QJsonDocument( report ).toJson();
+}
+
+/* Function to get a nearest rank percentile of sorted samples */
+qint64 BenchmarkReport::percentile(const QVector<qint64> &sorted, double rank)
+{
+    /* Compute nearest rank index */
+    int index = qBound( 0, (int) ceil( rank * sorted.size() ) - 1, sorted.size() - 1 );
+
+    /* Return value */
+    return sorted.at( index );
+}
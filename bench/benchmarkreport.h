@@ -0,0 +1,87 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+/* Includes */
+#include <QString>
+#include <QVector>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QThread>
+#include <QSysInfo>
+#include <QDateTime>
+#include <algorithm>
+#include <cmath>
+
+/* Main class */
+class BenchmarkReport
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    BenchmarkReport(int threads);
+
+    /* Function to add a benchmark result (work is the amount of unit per iteration, samples in nanoseconds) */
+    void add(QString name,
+             QString size,
+             QString unit,
+             double work,
+             QVector<qint64> samples);
+
+    /* Function to get the report as JSON */
+    QByteArray toJson();
+
+    /* Function to get a nearest rank percentile of sorted samples */
+    static qint64 percentile(const QVector<qint64> &sorted, double rank);
+
+/* Private functions / variables */
+private:
+
+    /* Threads count used by benchmarks */
+    int threads_count;
+
+    /* Results */
+    QJsonArray results;
+};
+
+#endif // BENCHMARKREPORT_H
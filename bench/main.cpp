@@ -0,0 +1,517 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFile>
+#include <iostream>
+
+#include <opencv/cv.h>
+#include <opencv/highgui.h>
+
+#include "benchmarkreport.h"
+#include "panoramaviewer.h"
+#include "panoramacache.h"
+#include "objectrect.h"
+#include "ymlparser.h"
+#include "jpegdecoder.h"
+#include "utils.h"
+
+/* Synthetic view size (objects projection and rendered frames) */
+static const int bench_view_width = 1280;
+static const int bench_view_height = 720;
+
+/* Number of objects cropped / exported per panorama */
+static const int bench_crop_objects = 100;
+
+/* Function to create a synthetic panorama (smoothed noise, compresses like real footage) */
+IplImage* createPanorama(int width, int height)
+{
+    /* Create image */
+    IplImage* image = cvCreateImage( cvSize( width, height ), IPL_DEPTH_8U, 3 );
+
+    /* Fill with deterministic noise */
+    CvRNG rng = cvRNG( 0x59414644 );
+    cvRandArr( &rng, image, CV_RAND_UNI, cvScalarAll( 0 ), cvScalarAll( 255 ) );
+
+    /* Smooth noise */
+    cvSmooth( image, image, CV_GAUSSIAN, 9, 9 );
+
+    /* Return image */
+    return image;
+}
+
+/* Function to create a synthetic annotation set (objects spread over the sphere) */
+QList<ObjectRect*> createObjects(int count)
+{
+    /* Objects container */
+    QList<ObjectRect*> objects;
+
+    /* Deterministic positions */
+    qsrand( count );
+
+    /* Create objects */
+    for (int i = 0; i < count; i++)
+    {
+        /* Initialize object */
+        ObjectRect* object = new ObjectRect();
+        object->setId( i + 1 );
+        object->setObjectType( ( i % 2 ) ? ObjectType::Face : ObjectType::NumberPlate );
+        object->setAutomaticStatus( ObjectAutomaticStatus::Valid );
+        object->setManualStatus( ObjectManualStatus::Valid );
+        object->setBlurred( true );
+
+        /* Projection parameters (60 degrees view centered on object) */
+        float azimuth = ( ( qrand() % 3600 ) / 10.0 ) * ( LG_PI / 180.0 );
+        float elevation = ( ( qrand() % 1200 ) / 10.0 - 60.0 ) * ( LG_PI / 180.0 );
+        object->setProjectionParametters( azimuth, elevation, 60.0 * ( LG_PI / 180.0 ), bench_view_width, bench_view_height );
+
+        /* Square object at view center (32 to 160 pixels) */
+        float side = 32 + qrand() % 128;
+        float x = ( bench_view_width - side ) / 2.0;
+        float y = ( bench_view_height - side ) / 2.0;
+        object->setPoints( QPointF( x, y ), QPointF( x + side, y ), QPointF( x + side, y + side ), QPointF( x, y + side ) );
+        object->setProjectionPoints();
+
+        /* Append object */
+        objects.append( object );
+    }
+
+    /* Return objects */
+    return objects;
+}
+
+/* Function to get a size label */
+QString sizeLabel(int width, int height)
+{
+    /* Return label */
+    return QString("%1x%2").arg( width ).arg( height );
+}
+
+/* Benchmark IplImage to QImage conversion */
+void benchConvert(BenchmarkReport &report, IplImage* image, int iterations, int threads)
+{
+    /* Samples container */
+    QVector<qint64> samples;
+    QElapsedTimer timer;
+
+    /* Iterate */
+    for (int i = 0; i < iterations; i++)
+    {
+        timer.start();
+        QImage* converted = IplImage2QImage( image, threads );
+        samples.append( timer.nsecsElapsed() );
+        delete converted;
+    }
+
+    /* Add result */
+    report.add( "convert", sizeLabel( image->width, image->height ), "Mpix/s", ( (double) image->width * image->height ) / 1e6, samples );
+}
+
+/* Benchmark JPEG decoding, OpenCV and restart markers strips */
+void benchDecode(BenchmarkReport &report, IplImage* image, QString directory, int iterations, int threads)
+{
+    /* Encode panorama, then re-encode it with restart markers */
+    QString path = directory + "/panorama.jpeg";
+    QString restart_path = directory + "/panorama_restart.jpeg";
+    int params[] = { CV_IMWRITE_JPEG_QUALITY, 95, 0 };
+    if( !cvSaveImage( path.toStdString().c_str(), image, params ) || !JpegDecoder::addRestartMarkers( path, restart_path ) )
+    {
+        std::cerr << "[ERROR] Unable to write JPEG panorama" << std::endl;
+        return;
+    }
+
+    /* Samples containers */
+    QVector<qint64> samples;
+    QVector<qint64> restart_samples;
+    QElapsedTimer timer;
+
+    /* Iterate */
+    for (int i = 0; i < iterations; i++)
+    {
+        /* OpenCV decoder */
+        timer.start();
+        IplImage* decoded = cvLoadImage( path.toStdString().c_str(), CV_LOAD_IMAGE_UNCHANGED );
+        samples.append( timer.nsecsElapsed() );
+        cvReleaseImage( &decoded );
+
+        /* Parallel strips decoder */
+        timer.start();
+        decoded = JpegDecoder::load( restart_path, threads );
+        restart_samples.append( timer.nsecsElapsed() );
+        cvReleaseImage( &decoded );
+    }
+
+    /* Add results */
+    report.add( "decode", sizeLabel( image->width, image->height ), "Mpix/s", ( (double) image->width * image->height ) / 1e6, samples );
+    report.add( "decode_restart", sizeLabel( image->width, image->height ), "Mpix/s", ( (double) image->width * image->height ) / 1e6, restart_samples );
+}
+
+/* Benchmark pyramid building (panorama loading) */
+PanoramaCache* benchPyramid(BenchmarkReport &report, IplImage* image, int iterations, int threads)
+{
+    /* Samples container */
+    QVector<qint64> samples;
+    QElapsedTimer timer;
+
+    /* Last built pyramid (kept for projections) */
+    PanoramaCache* cache = NULL;
+
+    /* Iterate */
+    for (int i = 0; i < iterations; i++)
+    {
+        delete cache;
+        timer.start();
+        cache = new PanoramaCache();
+        cache->load( image, threads );
+        samples.append( timer.nsecsElapsed() );
+    }
+
+    /* Add result */
+    report.add( "pyramid", sizeLabel( image->width, image->height ), "Mpix/s", ( (double) image->width * image->height ) / 1e6, samples );
+
+    /* Return pyramid */
+    return cache;
+}
+
+/* Benchmark viewer frames projection (draft and refined frames, as rendered on panning) */
+void benchProject(BenchmarkReport &report, PanoramaCache* cache, int iterations, int threads)
+{
+    /* Frames (draft is reduced four times) */
+    QImage draft( bench_view_width / 4, bench_view_height / 4, QImage::Format_RGB32 );
+    QImage frame( bench_view_width, bench_view_height, QImage::Format_RGB32 );
+
+    /* Samples containers */
+    QVector<qint64> draft_samples;
+    QVector<qint64> frame_samples;
+    QElapsedTimer timer;
+
+    /* View aperture */
+    float aperture = 100.0 * ( LG_PI / 180.0 );
+
+    /* Iterate (view is rotated on each iteration, as when panning) */
+    for (int i = 0; i < iterations; i++)
+    {
+        /* View azimuth */
+        float azimuth = ( i * 7.0 ) * ( LG_PI / 180.0 );
+
+        /* Draft frame */
+        timer.start();
+        cache->project( &draft, azimuth, 0.0, aperture, cache->selectLevel( draft.width(), aperture ), threads, ProjectionInterpolation::Nearest, NULL, false );
+        draft_samples.append( timer.nsecsElapsed() );
+
+        /* Refined frame */
+        timer.start();
+        cache->project( &frame, azimuth, 0.0, aperture, cache->selectLevel( frame.width(), aperture ), threads, ProjectionInterpolation::Bilinear );
+        frame_samples.append( timer.nsecsElapsed() );
+    }
+
+    /* Add results */
+    report.add( "project_draft", sizeLabel( cache->width(), cache->height() ), "Mpix/s", ( (double) draft.width() * draft.height() ) / 1e6, draft_samples );
+    report.add( "project_frame", sizeLabel( cache->width(), cache->height() ), "Mpix/s", ( (double) frame.width() * frame.height() ) / 1e6, frame_samples );
+}
+
+/* Benchmark objects crops (batch views tiles) */
+void benchCrop(BenchmarkReport &report, PanoramaViewer* pano, QList<ObjectRect*> objects, int iterations)
+{
+    /* Samples container */
+    QVector<qint64> samples;
+    QElapsedTimer timer;
+
+    /* Iterate */
+    for (int i = 0; i < iterations; i++)
+    {
+        timer.start();
+        foreach(ObjectRect* object, objects)
+            pano->cropObject( object );
+        samples.append( timer.nsecsElapsed() );
+    }
+
+    /* Add result */
+    report.add( "crop", sizeLabel( pano->image_info.width, pano->image_info.height ), "objects/s", objects.size(), samples );
+}
+
+/* Benchmark objects exports (projection and encoding to disk) */
+void benchExport(BenchmarkReport &report, image_info_struct image_info, QList<ObjectRect*> objects, QString path, int iterations)
+{
+    /* Samples container */
+    QVector<qint64> samples;
+    QElapsedTimer timer;
+
+    /* Iterate */
+    for (int i = 0; i < iterations; i++)
+    {
+        timer.start();
+        foreach(ObjectRect* object, objects)
+            exportRect( object, image_info, QString("%1/%2.png").arg( path ).arg( object->getId() ) );
+        samples.append( timer.nsecsElapsed() );
+    }
+
+    /* Add result */
+    report.add( "export", sizeLabel( image_info.width, image_info.height ), "objects/s", objects.size(), samples );
+}
+
+/* Benchmark objects mapping to a view (viewer render) */
+void benchMapTo(BenchmarkReport &report, QList<ObjectRect*> objects, int iterations)
+{
+    /* Samples container */
+    QVector<qint64> samples;
+    QElapsedTimer timer;
+
+    /* Iterate (view is rotated on each iteration) */
+    for (int i = 0; i < iterations; i++)
+    {
+        /* View azimuth */
+        float azimuth = ( i * 7.0 ) * ( LG_PI / 180.0 );
+
+        timer.start();
+        foreach(ObjectRect* object, objects)
+            object->mapTo( bench_view_width, bench_view_height, azimuth, 0.0, 100.0 * ( LG_PI / 180.0 ) );
+        samples.append( timer.nsecsElapsed() );
+    }
+
+    /* Add result */
+    report.add( "mapto", QString::number( objects.size() ), "objects/s", objects.size(), samples );
+}
+
+/* Benchmark YML writing and loading */
+void benchYML(BenchmarkReport &report, QList<ObjectRect*> objects, QString path, int iterations)
+{
+    /* YML parser */
+    YMLParser parser;
+
+    /* Samples containers */
+    QVector<qint64> write_samples;
+    QVector<qint64> load_samples;
+    QElapsedTimer timer;
+
+    /* Iterate */
+    for (int i = 0; i < iterations; i++)
+    {
+        /* Write YML */
+        timer.start();
+        parser.writeYML( objects, path );
+        write_samples.append( timer.nsecsElapsed() );
+
+        /* Load YML */
+        timer.start();
+        QList<ObjectRect*> loaded = parser.loadYML( path, YMLType::Validator );
+        load_samples.append( timer.nsecsElapsed() );
+
+        /* Release loaded objects */
+        qDeleteAll( loaded );
+    }
+
+    /* YML size (in megabytes) */
+    double megabytes = QFileInfo( path ).size() / ( 1024.0 * 1024.0 );
+
+    /* Add results */
+    report.add( "yml_write", QString::number( objects.size() ), "MB/s", megabytes, write_samples );
+    report.add( "yml_load", QString::number( objects.size() ), "MB/s", megabytes, load_samples );
+    report.add( "yml_load_objects", QString::number( objects.size() ), "objects/s", objects.size(), load_samples );
+}
+
+/* Program entry point */
+int main(int argc, char *argv[])
+{
+    /* Run without display */
+    if( qgetenv( "QT_QPA_PLATFORM" ).isEmpty() )
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+
+    /* Main application container (viewer widget is required for crops) */
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Yafdb-Bench");
+    QCoreApplication::setApplicationVersion("0.1");
+
+    /* Command line parser object */
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Yafdb-Validator headless benchmarks");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    /* Iterations */
+    QCommandLineOption iterationsOption(QStringList() << "n" << "iterations",
+            QCoreApplication::translate("main", "Iterations per benchmark."),
+            QCoreApplication::translate("main", "count (default 10)"));
+    parser.addOption(iterationsOption);
+
+    /* Panorama sizes */
+    QCommandLineOption sizesOption(QStringList() << "p" << "panoramas",
+            QCoreApplication::translate("main", "Synthetic panoramas widths (height is half width)."),
+            QCoreApplication::translate("main", "widths (default 2048,4096,8192)"));
+    parser.addOption(sizesOption);
+
+    /* Annotation sets sizes */
+    QCommandLineOption objectsOption(QStringList() << "a" << "annotations",
+            QCoreApplication::translate("main", "Synthetic annotation sets sizes."),
+            QCoreApplication::translate("main", "counts (default 100,1000,10000)"));
+    parser.addOption(objectsOption);
+
+    /* Threads */
+    QCommandLineOption threadsOption(QStringList() << "t" << "threads",
+            QCoreApplication::translate("main", "Threads count."),
+            QCoreApplication::translate("main", "count (default ideal threads count)"));
+    parser.addOption(threadsOption);
+
+    /* Output */
+    QCommandLineOption outputOption(QStringList() << "o" << "output",
+            QCoreApplication::translate("main", "JSON report path (default standard output)."),
+            QCoreApplication::translate("main", "file path"));
+    parser.addOption(outputOption);
+
+    /* Process given arguments */
+    parser.process(app);
+
+    /* Parse settings */
+    int iterations = parser.isSet(iterationsOption) ? qMax( 1, parser.value(iterationsOption).toInt() ) : 10;
+    int threads = parser.isSet(threadsOption) ? qMax( 1, parser.value(threadsOption).toInt() ) : QThread::idealThreadCount();
+    QStringList widths = ( parser.isSet(sizesOption) ? parser.value(sizesOption) : QString("2048,4096,8192") ).split( ",", QString::SkipEmptyParts );
+    QStringList counts = ( parser.isSet(objectsOption) ? parser.value(objectsOption) : QString("100,1000,10000") ).split( ",", QString::SkipEmptyParts );
+
+    /* Temporary files directory */
+    QTemporaryDir temp;
+    if( !temp.isValid() )
+    {
+        std::cerr << "[ERROR] Unable to create temporary directory" << std::endl;
+        return 1;
+    }
+
+    /* Report */
+    BenchmarkReport report( threads );
+
+    /* Viewer (crops use its size) */
+    PanoramaViewer pano( 0, false );
+    pano.setup( bench_view_width, bench_view_height, 1.0, 20.0, 100.0, 100.0, threads );
+
+    /* Crops / exports annotation set */
+    QList<ObjectRect*> crop_objects = createObjects( bench_crop_objects );
+
+    /* Panoramas benchmarks */
+    foreach(const QString &width_string, widths)
+    {
+        /* Panorama size */
+        int width = width_string.toInt();
+        int height = width / 2;
+        if( width < 2 )
+            continue;
+
+        /* Info output */
+        std::cerr << "Panorama " << sizeLabel( width, height ).toStdString() << "..." << std::endl;
+
+        /* Create panorama */
+        IplImage* image = createPanorama( width, height );
+
+        /* Decoding, conversion and pyramid */
+        benchDecode( report, image, temp.path(), iterations, threads );
+        benchConvert( report, image, iterations, threads );
+        PanoramaCache* cache = benchPyramid( report, image, iterations, threads );
+
+        /* Frames projection */
+        benchProject( report, cache, iterations, threads );
+
+        /* Crops (viewer takes ownership of pyramid) */
+        panorama_prefetch_struct panorama;
+        panorama.path = sizeLabel( width, height );
+        panorama.cache = cache;
+        panorama.width = width;
+        panorama.height = height;
+        panorama.channels = 4;
+        pano.setPanorama( panorama );
+        benchCrop( report, &pano, crop_objects, iterations );
+
+        /* Exports (from full resolution image) */
+        image_info_struct image_info;
+        image_info.image = IplImage2QImage( image, threads );
+        image_info.cache = NULL;
+        image_info.width = width;
+        image_info.height = height;
+        image_info.channels = 4;
+        benchExport( report, image_info, crop_objects, temp.path(), iterations );
+
+        /* Release images */
+        delete image_info.image;
+        cvReleaseImage( &image );
+    }
+
+    /* Annotation sets benchmarks */
+    foreach(const QString &count_string, counts)
+    {
+        /* Annotation set size */
+        int count = count_string.toInt();
+        if( count < 1 )
+            continue;
+
+        /* Info output */
+        std::cerr << "Annotations " << count << "..." << std::endl;
+
+        /* Create objects */
+        QList<ObjectRect*> objects = createObjects( count );
+
+        /* Mapping and YML I/O */
+        benchMapTo( report, objects, iterations );
+        benchYML( report, objects, temp.path() + "/objects.yml", iterations );
+
+        /* Release objects */
+        qDeleteAll( objects );
+    }
+
+    /* Release crops objects */
+    qDeleteAll( crop_objects );
+
+    /* Write report */
+    QByteArray json = report.toJson();
+    if( parser.isSet(outputOption) )
+    {
+        /* Write report file */
+        QFile file( parser.value(outputOption) );
+        if( !file.open( QIODevice::WriteOnly ) || file.write( json ) != json.size() )
+        {
+            std::cerr << "[ERROR] Unable to write report " << parser.value(outputOption).toStdString() << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << json.constData();
+    }
+
+    /* Return result */
+    return 0;
+}
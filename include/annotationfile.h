@@ -0,0 +1,177 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef ANNOTATIONFILE_H
+#define ANNOTATIONFILE_H
+
+/* Includes */
+#include <QString>
+#include <QList>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QDir>
+
+#include "objectrect.h"
+#include "trace.h"
+
+/* Annotation file header (version 1) */
+struct annotation_header_struct{
+
+    /* File magic ("YFDB") */
+    char magic[4];
+
+    /* Format version */
+    quint32 version;
+
+    /* Byte order marker (0x01020304 in writer byte order) */
+    quint32 byte_order;
+
+    /* Size of an object record */
+    quint32 record_size;
+
+    /* Number of top level object records */
+    quint32 objects;
+
+    /* Number of children object records */
+    quint32 childrens;
+
+    /* Size of the source image path (UTF-8, padded to 8 bytes in file) */
+    quint32 source_size;
+
+    /* Reserved (zero) */
+    quint32 reserved;
+
+    /* Size and modification time (ms since epoch) of the mirrored YML (-1 if none) */
+    qint64 yml_size;
+    qint64 yml_modified;
+};
+
+/* Annotation file object record */
+struct annotation_record_struct{
+
+    /* Projection points (x, y) */
+    double points[8];
+
+    /* Projection parameters (azimuth, elevation, aperture, width, height) */
+    float params[5];
+
+    /* Object type, sub-type and statuses (See ObjectType, ObjectSubType, ObjectAutomaticStatus and ObjectManualStatus structs) */
+    qint8 type;
+    qint8 sub_type;
+    qint8 automatic_status;
+    qint8 manual_status;
+
+    /* Blur tag */
+    quint8 blurred;
+
+    /* Reserved (zero) */
+    quint8 reserved[7];
+};
+
+/* Annotation file children table entry (childrens of a top level object) */
+struct annotation_childrens_struct{
+    quint32 first;
+    quint32 count;
+};
+
+/* Parsed binary annotation data (pointers into the parsed buffer) */
+struct annotation_view_struct{
+
+    /* File header */
+    annotation_header_struct header;
+
+    /* Source image path */
+    QString source_image;
+
+    /* Top level records, followed by childrens records */
+    const annotation_record_struct* records;
+
+    /* Childrens table (one entry per top level record) */
+    const annotation_childrens_struct* childrens;
+};
+
+/* Main class */
+class AnnotationFile
+{
+
+/* Public functions / variables */
+public:
+
+    /* Function to get the binary sidecar path of a YML file */
+    static QString sidecarPath(QString yml_path);
+
+    /* Function to get the YML path of a binary sidecar */
+    static QString ymlPath(QString sidecar_path);
+
+    /* Function to determine if a YML file has an up to date binary sidecar */
+    static bool isCurrent(QString yml_path);
+
+    /* Function to write objects atomically to a binary annotation file (yml_path is the mirrored YML, if any) */
+    static bool write(QList<ObjectRect*> objects, QString path, QString yml_path = QString());
+
+    /* Function to serialize objects in memory (snapshot, not stamped) */
+    static QByteArray serialize(QList<ObjectRect*> objects);
+
+    /* Function to parse serialized objects (returns false on invalid data) */
+    static bool parse(const uchar* data, qint64 size, annotation_view_struct &view);
+
+    /* Function to write serialized objects atomically to a binary annotation file (yml_path is the mirrored YML, if any) */
+    static bool writeData(QByteArray data, QString path, QString yml_path = QString());
+
+    /* Function to read objects from a binary annotation file (returns false on invalid file) */
+    static bool read(QString path, QList<ObjectRect*> &out_list);
+
+/* Private functions / variables */
+private:
+
+    /* Function to fill a record from an object */
+    static void writeRecord(ObjectRect* object, annotation_record_struct &record);
+
+    /* Function to create an object from a record */
+    static ObjectRect* readRecord(const annotation_record_struct &record);
+
+    /* Function to read header of a binary annotation file (returns false on invalid header) */
+    static bool readHeader(QFile &file, annotation_header_struct &header);
+
+    /* Function to check magic, version, byte order and records size of a header */
+    static bool checkHeader(const annotation_header_struct &header);
+};
+
+#endif // ANNOTATIONFILE_H
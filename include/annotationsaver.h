@@ -0,0 +1,138 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef ANNOTATIONSAVER_H
+#define ANNOTATIONSAVER_H
+
+/* Includes */
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <iostream>
+
+#include "objectrect.h"
+#include "ymlparser.h"
+#include "annotationfile.h"
+
+/* Save request structure */
+struct annotation_save_request_struct{
+
+    /* Destination YML path */
+    QString path;
+
+    /* Objects snapshot (see AnnotationFile::serialize), empty to remove destination */
+    QByteArray snapshot;
+
+    /* Write binary sidecar too */
+    bool sidecar;
+};
+
+/* Main class */
+class AnnotationSaver : public QThread
+{
+    Q_OBJECT
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    explicit AnnotationSaver(QObject *parent = 0);
+
+    /* Destructor (pending requests are completed) */
+    ~AnnotationSaver();
+
+    /* Function to get the autosave snapshot path of a YML file */
+    static QString autosavePath(QString yml_path);
+
+    /* Function to queue a save of specified objects, superseding any pending request on the same path */
+    void save(QList<ObjectRect*> objects, QString path, bool sidecar = false);
+
+    /* Function to queue a save of an objects snapshot, superseding any pending request on the same path */
+    void save(QByteArray snapshot, QString path, bool sidecar = false);
+
+    /* Function to queue a removal, superseding any pending request on the same path */
+    void remove(QString path);
+
+    /* Function to complete pending requests and stop the save loop */
+    void finish();
+
+/* Signals */
+signals:
+
+    /* Function to report a completed request */
+    void saved(QString path, bool success);
+
+/* Protected functions / variables */
+protected:
+
+    /* Save loop */
+    void run();
+
+/* Private functions / variables */
+private:
+
+    /* Requests lock and condition */
+    QMutex mutex;
+    QWaitCondition condition;
+
+    /* Pending requests (one per path, in queue order) */
+    QList<annotation_save_request_struct> pending;
+
+    /* Save loop termination flag */
+    bool stopping;
+
+    /* Function to queue a request */
+    void enqueue(const annotation_save_request_struct &request);
+
+    /* Function to wait for the next request, returns false on termination */
+    bool nextRequest(annotation_save_request_struct &request);
+
+    /* Function to drop a pending request on specified path */
+    void dropPending(QString path);
+
+    /* Function to process a request, returns false on failure */
+    static bool process(const annotation_save_request_struct &request, YMLParser &parser);
+};
+
+#endif // ANNOTATIONSAVER_H
@@ -0,0 +1,131 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef BATCHEXPORTER_H
+#define BATCHEXPORTER_H
+
+/* Includes */
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QRegExp>
+
+#include <iostream>
+
+#include "exporter.h"
+#include "decodecache.h"
+#include "ymlparser.h"
+
+/* Batch export pair (panorama and its validated YML) */
+struct batch_export_pair_struct{
+    QString image_path;
+    QString yml_path;
+};
+
+/* Batch decoded panorama structure */
+struct batch_decoded_struct{
+    batch_export_pair_struct pair;
+    image_info_struct image_info;
+    QList<ObjectRect*> rects;
+};
+
+/* Main class */
+class BatchExporter : public QThread
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    BatchExporter(QString export_path, float zoom_level, int threads);
+
+    /* Destructor */
+    ~BatchExporter();
+
+    /* Function to read pairs from a manifest file (one "image yml" pair per line) */
+    static QList<batch_export_pair_struct> readManifest(QString path);
+
+    /* Function to find pairs in a yafdb blurring directory (as scripts/yafdb-batch-validate does) */
+    static QList<batch_export_pair_struct> scanDirectory(QString path);
+
+    /* Function to export all objects of specified pairs, returns number of failed pairs */
+    int exportPairs(QList<batch_export_pair_struct> pairs);
+
+/* Protected functions / variables */
+protected:
+
+    /* Decoding thread main function */
+    void run();
+
+/* Private functions / variables */
+private:
+
+    /* Objects exporter (shared workers pool) */
+    Exporter* exporter;
+
+    /* Pairs to decode */
+    QList<batch_export_pair_struct> pairs;
+
+    /* Decoded panoramas queue */
+    QQueue<batch_decoded_struct> decoded;
+
+    /* Maximum number of decoded panoramas waiting for export */
+    int queue_depth;
+
+    /* Number of threads */
+    int threads_count;
+
+    /* Queue lock and conditions */
+    QMutex queue_mutex;
+    QWaitCondition queue_filled;
+    QWaitCondition queue_drained;
+
+    /* Function to get next decoded panorama (blocks until decoded) */
+    batch_decoded_struct nextDecoded();
+};
+
+#endif // BATCHEXPORTER_H
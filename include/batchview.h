@@ -46,11 +46,14 @@
 #include <QMessageBox>
 #include <QLayoutItem>
 #include <QMouseEvent>
+#include <QTimer>
 
-#include "flowlayout.h"
 #include "objectrect.h"
 #include "objectitem.h"
+#include "objectgrid.h"
 #include "panoramaviewer.h"
+#include "thumbnailloader.h"
+#include "trace.h"
 
 /* Batch modes struct */
 struct BatchMode
@@ -144,6 +147,15 @@ private slots:
     void unSelectAll();
     void invertSelection();
 
+    /* Slot for generated thumbnails */
+    void thumbnailReady_slot(int index, QImage image);
+
+    /* Slot to prioritize thumbnails of visible tiles */
+    void updateVisibleThumbnails();
+
+    /* Slot to open a tile in an edition window */
+    void editItem_slot(int index);
+
 /* Private functions / variables */
 private:
 
@@ -156,17 +168,15 @@ private:
     /* Main PanoramaViewer container */
     PanoramaViewer* pano;
 
-    /* Main layout container to store/display tiles */
-    FlowLayout * MainLayout;
-
-    /* Main tiles list */
+    /* Main tiles list (owned, displayed by the objects grid) */
     QList<ObjectItem*> elements;
 
-    /* List of id's to be removed */
-    QList<int> toremove_ids;
+    /* Asynchronous thumbnails generator */
+    ThumbnailLoader* thumbnails;
 
-    /* List of allocated tiles */
-    QList<ObjectItem*> item_list;
+    /* Thumbnail job index of each tile (-1 if none) and tile of each job */
+    QVector<int> item_jobs;
+    QVector<int> job_items;
 
     /* Key statuses container structure */
     struct pressed_keys_struct{
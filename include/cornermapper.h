@@ -0,0 +1,110 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef CORNERMAPPER_H
+#define CORNERMAPPER_H
+
+/* Includes */
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QPointF>
+
+#include <inter-all.h>
+#include <gnomonic-all.h>
+
+#include "objectrect.h"
+
+/* Rotation matrices of a gnomonic center */
+struct corner_rotation_struct{
+    double r2e[3][3];
+    double e2r[3][3];
+};
+
+/* Main class */
+class CornerMapper
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    CornerMapper();
+
+    /* Function to map all objects corners to a view, objects points are updated if requested */
+    void map(const QList<ObjectRect*> &rects,
+             float width,
+             float height,
+             float azimuth,
+             float elevation,
+             float aperture,
+             bool update_points = true);
+
+    /* Function to know if the 4 corners of an object were visible in the last mapped view */
+    bool isVisible(int index);
+
+/* Private functions / variables */
+private:
+
+    /* Rotation matrices cache, indexed by packed (azimuth, elevation) */
+    QHash<quint64, corner_rotation_struct> rotations;
+
+    /* Objects corners in their own projection (structure of arrays, 4 corners per object) */
+    QVector<double> r_x;
+    QVector<double> r_y;
+
+    /* Objects corners in the view */
+    QVector<double> c_x;
+    QVector<double> c_y;
+
+    /* Objects to view matrices (9 coefficients per object) */
+    QVector<double> matrices;
+
+    /* Objects projections centers and pixel sizes */
+    QVector<double> r_cx;
+    QVector<double> r_cy;
+    QVector<double> r_pixel;
+
+    /* Objects visibility */
+    QVector<char> visible;
+
+    /* Function to get (cached) rotation matrices of a gnomonic center */
+    const corner_rotation_struct &rotation(float azimuth, float elevation);
+};
+
+#endif // CORNERMAPPER_H
@@ -0,0 +1,136 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef DECODECACHE_H
+#define DECODECACHE_H
+
+/* Includes */
+#include <QString>
+#include <QImage>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QThread>
+#include <iostream>
+
+#include <opencv/cv.h>
+
+#include "jpegdecoder.h"
+#include "panoramacache.h"
+#include "trace.h"
+#include "utils.h"
+
+/* Decoded images cache entries format version */
+#define DECODE_CACHE_VERSION 1
+
+/* Age of leftover temporary files removed on eviction (seconds, interrupted stores) */
+#define DECODE_CACHE_PART_AGE 3600
+
+/* Decoded images cache entry header (pixels follow at data offset) */
+struct decode_cache_header_struct{
+
+    /* Entry magic ("YFDC") and format version */
+    char magic[4];
+    qint32 version;
+
+    /* Image dimensions */
+    qint32 width;
+    qint32 height;
+
+    /* Source image channels count (as decoded) */
+    qint32 channels;
+
+    /* Pixels format (QImage::Format) and row size in bytes */
+    qint32 format;
+    qint32 bytes_per_line;
+
+    /* Offset of pixels (page aligned) */
+    qint64 data_offset;
+};
+
+/* Main class */
+class DecodeCache
+{
+
+/* Public functions / variables */
+public:
+
+    /* Function to enable the cache in specified directory, entries are evicted above size limit (in bytes) */
+    static void setup(QString directory, qint64 limit);
+
+    /* Function to check if the cache is enabled */
+    static bool enabled();
+
+    /* Function to load a decoded image, memory mapped from the cache when present, decoded and stored otherwise (NULL on failure) */
+    static QImage* load(QString path, int threads, int* channels = NULL);
+
+    /* Function to load the pyramid levels of an image, each level mapped from the cache when present, built and stored otherwise (empty on failure) */
+    static QList<QImage> loadPyramid(QString path, int threads, int* channels = NULL);
+
+/* Private functions / variables */
+private:
+
+    /* Cache directory (empty if disabled) */
+    static QString directory;
+
+    /* Cache size limit (in bytes) */
+    static qint64 limit;
+
+    /* Function to get the cache entry path of an image (content hash and modification time) */
+    static QString entryPath(QString path);
+
+    /* Function to load a decoded image from specified entry (cache is bypassed if entry is empty) */
+    static QImage* loadEntry(QString path, QString entry, int threads, int* channels);
+
+    /* Function to get the cache entry path of a pyramid level */
+    static QString levelPath(QString entry, int level);
+
+    /* Function to map a cache entry as a read-only image (NULL if missing or invalid) */
+    static QImage* map(QString entry, int* channels);
+
+    /* Function to store a decoded image as a cache entry (atomically) */
+    static bool store(QString entry, const QImage* image, int channels, int threads);
+
+    /* Function to remove least recently used entries above size limit (except kept entry and its levels) and leftover temporary files */
+    static void evict(QString keep);
+};
+
+#endif // DECODECACHE_H
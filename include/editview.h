@@ -48,6 +48,7 @@
 #include "g2g_point.h"
 #include "objectrect.h"
 #include "panoramaviewer.h"
+#include "ymlparser.h"
 
 /* Edit modes struct */
 struct EditMode
@@ -4,6 +4,88 @@
 #include <inter-all.h>
 #include <gnomonic-all.h>
 
+/*! \brief Equirectangular to gnomonic transformation
+ *
+ *  Precomputed rotation matrix and pixel size of a gnomonic projection (see
+ *  etg_transform_init)
+ */
+
+typedef struct etg_transform_struct {
+
+    /* Equirectangular to rectilinear rotation */
+    double m[3][3];
+
+    /* Equirectangular image size */
+    double e_width;
+    double e_height;
+
+    /* Rectilinear image size and pixel size */
+    double c_width;
+    double c_height;
+    double c_pixel;
+
+} etg_transform;
+
+/*! \brief Equirectangular to gnomonic transformation initialization
+ *
+ *  This function computes the rotation matrix and pixel size of a gnomonic
+ *  projection once, so that etg_points can convert any number of points of
+ *  the equirectangular image in its rectilinear image. The structure is only
+ *  read afterwards, so that the conversion can be called concurrently
+ *
+ *  \param  t        Transformation structure to initialize
+ *  \param  e_width  Width, in pixels, of the equirectangular image
+ *  \param  e_height Height, in pixels, of the equirectangular image
+ *  \param  c_width  Width, in pixels, of the rectilinear image
+ *  \param  c_height Height, in pixels, of the rectilinear image
+ *  \param  c_azim   Azimuth of gnomonic center
+ *  \param  c_elev   Elevation of gnomonic center
+ *  \param  c_appe   Apperture of the gnomonic projection
+ */
+
+void etg_transform_init(
+
+    etg_transform * const t,
+    double          const e_width,
+    double          const e_height,
+    double          const c_width,
+    double          const c_height,
+    double          const c_azim,
+    double          const c_elev,
+    double          const c_appe
+
+);
+
+/*! \brief Equirectangular to gnomonic batched coordinates converter
+ *
+ *  This function converts the coordinates of an array of points of the
+ *  equirectangular image in the rectilinear image of a transformation.
+ *  Results are the ones of etg_point
+ *
+ *  \param  t        Transformation initialized with etg_transform_init
+ *  \param  count    Number of points
+ *  \param  e_x      X positions, in pixels, of the points in equirectangular mapping
+ *  \param  e_y      Y positions, in pixels, of the points in equirectangular mapping
+ *  \param  c_x      X positions of the points in rectilinear image
+ *  \param  c_y      Y positions of the points in rectilinear image
+ *  \param  c_v      First order visibility of the points (Optionnal)
+ *
+ *  \return Returns the number of points passing the first order visibility
+ *  test
+ */
+
+int etg_points(
+
+    etg_transform const * const t,
+    int               const count,
+    double    const * const e_x,
+    double    const * const e_y,
+    double          * const c_x,
+    double          * const c_y,
+    int             * const c_v = NULL
+
+);
+
 /*! \brief Equirectangular to gnomonic coordinates converter
  *
  *  This function converts the coordinates of a point seen on the reference
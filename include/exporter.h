@@ -0,0 +1,163 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+/* Includes */
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QRect>
+#include <QDir>
+#include <QFile>
+#include <QBuffer>
+#include <QMutex>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include "objectrect.h"
+#include "utils.h"
+
+/* Export source image structure (shared by the objects of one image) */
+struct export_source_struct{
+    QImage image;
+    image_info_struct image_info;
+    QAtomicInt pending;
+};
+
+/* Main class */
+class Exporter
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    Exporter(QString export_path, float zoom_level, int threads, int max_images = 2);
+
+    /* Destructor (waits for pending exports) */
+    ~Exporter();
+
+    /* Function to get the output directory of an object */
+    QString objectPath(ObjectRect* rect);
+
+    /* Function to queue objects export from a decoded image (blocks while max_images images are being exported) */
+    int exportObjects(const image_info_struct &image_info, QList<ObjectRect*> rects);
+
+    /* Function to wait for queued exports */
+    void wait();
+
+    /* Function to get number of exported objects */
+    int exported();
+
+    /* Function to get number of failed exports */
+    int failed();
+
+    /* Function to project, encode and write an object (called from pool threads) */
+    void writeObject(const image_info_struct &image_info, ObjectRect* rect, QString path);
+
+    /* Function to release an exported image slot (called from pool threads) */
+    void releaseImage(export_source_struct* source);
+
+/* Private functions / variables */
+private:
+
+    /* Export settings */
+    QString export_path;
+    float zoom_level;
+
+    /* Workers pool */
+    QThreadPool pool;
+
+    /* Images being exported slots */
+    QSemaphore images;
+
+    /* Next free output ID */
+    QAtomicInt next_id;
+
+    /* Directories already created and scanned for IDs */
+    QSet<QString> directories;
+
+    /* Directories lock */
+    QMutex directories_mutex;
+
+    /* Exports counters */
+    QAtomicInt exported_count;
+    QAtomicInt failed_count;
+
+    /* Function to create directories and reserve IDs above existing files */
+    void prepareDirectories(const QStringList &paths);
+};
+
+/* Export worker runnable */
+class ExportTask : public QRunnable
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    ExportTask(Exporter* exporter, export_source_struct* source, ObjectRect* rect, QString path);
+
+    /* Destructor */
+    ~ExportTask();
+
+    /* Run function */
+    void run();
+
+/* Private functions / variables */
+private:
+
+    /* Parent exporter */
+    Exporter* exporter;
+
+    /* Shared source image */
+    export_source_struct* source;
+
+    /* Object copy */
+    ObjectRect* rect;
+
+    /* Output directory */
+    QString path;
+};
+
+#endif // EXPORTER_H
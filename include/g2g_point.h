@@ -42,6 +42,95 @@
 #include <inter-all.h>
 #include <gnomonic-all.h>
 
+/*! \brief Gnomonic to gnomonic transformation
+ *
+ *  Precomputed rotation matrices and pixel sizes of a pair of gnomonic
+ *  projections (see g2g_transform_init)
+ */
+
+typedef struct g2g_transform_struct {
+
+    /* Reference to equirectangular and equirectangular to secondary rotations */
+    double r_m[3][3];
+    double c_m[3][3];
+
+    /* Reference image size and pixel size */
+    double r_width;
+    double r_height;
+    double r_pixel;
+
+    /* Secondary image size and pixel size */
+    double c_width;
+    double c_height;
+    double c_pixel;
+
+} g2g_transform;
+
+/*! \brief Gnomonic to gnomonic transformation initialization
+     *
+     *  This function computes the rotation matrices and pixel sizes of a pair of
+     *  gnomonic projections once, so that g2g_points can convert any number of
+     *  points between them
+     *
+     *  \param  t        Transformation structure to initialize
+     *  \param  r_width  Width, in pixels, of the reference rectilinear image
+     *  \param  r_height Height, in pixels, of the reference rectilinear image
+     *  \param  r_azim   Azimuth of reference gnomonic center
+     *  \param  r_elev   Elevation of reference gnomonic center
+     *  \param  r_appe   Apperture of the reference gnomonic projection
+     *  \param  c_width  Width, in pixels, of the secondary rectilinear image
+     *  \param  c_height Height, in pixels, of the secondary rectilinear image
+     *  \param  c_azim   Azimuth of secondary gnomonic center
+     *  \param  c_elev   Elevation of secondary gnomonic center
+     *  \param  c_appe   Apperture of the secondary gnomonic projection
+     */
+
+void g2g_transform_init(
+
+    g2g_transform * const t,
+    double          const r_width,
+    double          const r_height,
+    double          const r_azim,
+    double          const r_elev,
+    double          const r_appe,
+    double          const c_width,
+    double          const c_height,
+    double          const c_azim,
+    double          const c_elev,
+    double          const c_appe
+
+);
+
+/*! \brief Gnomonic to gnomonic batched coordinates converter
+     *
+     *  This function converts the coordinates of an array of points seen in the
+     *  reference rectilinear image of a transformation in the frame of its
+     *  secondary rectilinear image. Results are the ones of g2g_point
+     *
+     *  \param  t        Transformation initialized with g2g_transform_init
+     *  \param  count    Number of points
+     *  \param  r_x      X positions of the points in reference rectilinear image
+     *  \param  r_y      Y positions of the points in reference rectilinear image
+     *  \param  c_x      X positions of the points in secondary rectilinear image (Optionnal)
+     *  \param  c_y      Y positions of the points in secondary rectilinear image (Optionnal)
+     *  \param  c_v      First order visibility of the points (Optionnal)
+     *
+     *  \return Returns the number of points passing the first order visibility
+     *  test
+     */
+
+int g2g_points(
+
+    g2g_transform const * const t,
+    int               const count,
+    double    const * const r_x,
+    double    const * const r_y,
+    double          * const c_x = NULL,
+    double          * const c_y = NULL,
+    int             * const c_v = NULL
+
+);
+
 /*! \brief Gnomonic to gnomonic coordinates converter
      *
      *  This function converts the coordinates of a point seen in a rectilinear
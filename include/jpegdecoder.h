@@ -0,0 +1,118 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef JPEGDECODER_H
+#define JPEGDECODER_H
+
+/* Includes */
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include <QSaveFile>
+#include <QByteArray>
+#include <QAtomicInt>
+#include <iostream>
+
+#include <opencv/cv.h>
+#include <opencv/highgui.h>
+
+#include "trace.h"
+
+/* JPEG stream layout structure (baseline sequential, single scan) */
+struct jpeg_layout_struct{
+
+    /* Image dimensions and components count */
+    int width;
+    int height;
+    int components;
+
+    /* MCU dimensions (in pixels) and MCUs grid */
+    int mcu_width;
+    int mcu_height;
+    int mcus_x;
+    int mcus_y;
+
+    /* Restart interval (in MCUs, 0 if none) */
+    int restart_interval;
+
+    /* Smallest MCU rows count ending on a restart marker */
+    int restart_rows;
+
+    /* MCU rows decoded around strips (vertical chroma upsampling context) */
+    int context_rows;
+
+    /* Offset of frame height field */
+    qint64 height_offset;
+
+    /* Size of headers (offset of entropy coded data) */
+    qint64 header_size;
+
+    /* Offsets of restart markers */
+    QVector<qint64> restarts;
+
+    /* Offset of entropy coded data end */
+    qint64 data_end;
+};
+
+/* Main class */
+class JpegDecoder
+{
+
+/* Public functions / variables */
+public:
+
+    /* Function to load an image, JPEGs with restart markers are decoded in parallel strips (falls back on OpenCV) */
+    static IplImage* load(QString path, int threads);
+
+    /* Function to decode a JPEG in parallel strips split on restart markers (NULL if not possible) */
+    static IplImage* decode(QString path, int threads);
+
+    /* Function to re-encode a JPEG losslessly with one restart marker per MCU row (enables parallel decoding) */
+    static bool addRestartMarkers(QString path, QString destination);
+
+    /* Function to read the layout of a JPEG stream (returns false if not a single scan baseline JPEG) */
+    static bool parse(const uchar* data, qint64 size, jpeg_layout_struct &layout);
+
+/* Private functions / variables */
+private:
+
+    /* Function to decode a strip of MCU rows into its rows of destination image */
+    static bool decodeStrip(const uchar* data, const jpeg_layout_struct &layout, int first_row, int rows, IplImage* image);
+};
+
+#endif // JPEGDECODER_H
@@ -40,10 +40,19 @@
 #define MAIN_H
 
 #include <QApplication>
+#include <QScopedPointer>
 
 #include "mainwindow.h"
 #include "batchview.h"
 #include "ymlparser.h"
+#include "exporter.h"
+#include "batchexporter.h"
+#include "ymlconverter.h"
+#include "annotationfile.h"
+#include "validationsession.h"
+#include "jpegdecoder.h"
+#include "decodecache.h"
+#include "trace.h"
 
 /* Application working modes struct */
 struct ApplicationMode
@@ -57,7 +66,19 @@ struct ApplicationMode
         Exporter = 1,
 
         /* Start the YML converter */
-        YMLConverter = 2
+        YMLConverter = 2,
+
+        /* Start the multi-panoramas tiles exporter */
+        BatchExporter = 3,
+
+        /* Start the YML / binary sidecar converter */
+        Sidecar = 4,
+
+        /* Start the validator on all panoramas of a yafdb blurring directory */
+        Session = 5,
+
+        /* Start the lossless JPEG restart markers re-encoder */
+        JpegRestart = 6
     };
 };
 
@@ -45,10 +45,15 @@
 #include <QThread>
 #include <QLabel>
 #include <QPalette>
+#include <QTimer>
+#include <QPointer>
 #include <iostream>
 
 #include "panoramaviewer.h"
 #include "batchview.h"
+#include "annotationsaver.h"
+#include "panoramaprefetcher.h"
+#include "validationsession.h"
 
 /* Default class container */
 namespace Ui {
@@ -64,7 +69,10 @@ class MainWindow : public QMainWindow
 public:
 
     /* Constructor */
-    explicit MainWindow(QWidget *parent, QString sourceImagePath, QString detectorYMLPath, QString destinationYMLPath);
+    explicit MainWindow(QWidget *parent, QString sourceImagePath, QString detectorYMLPath, QString destinationYMLPath, qint64 cacheBudget, bool sidecar = false, int autosaveInterval = 120);
+
+    /* Constructor (session mode, all panoramas of a session are validated in this window) */
+    explicit MainWindow(QWidget *parent, ValidationSession* session, qint64 cacheBudget, bool sidecar = false, int autosaveInterval = 120);
 
     /* Destructor */
     ~MainWindow();
@@ -74,6 +82,9 @@ public:
         QString sourceImagePath;
         QString detectorYMLPath;
         QString destinationYMLPath;
+        qint64 cacheBudget;
+        bool sidecar;
+        int autosaveInterval;
     } options;
 
 /* Private slots */
@@ -98,6 +109,16 @@ private slots:
     void refreshLabels();
     void updateScaleSlider(int value);
     void onESC();
+    void onQuit();
+
+    /* Autosave snapshot */
+    void autosave();
+
+    /* Function to complete pending saves (application exit) */
+    void finishSaves();
+
+    /* Slot for completed background saves, completes pending close */
+    void saveCompleted(QString path, bool success);
 
 /* Private functions / variables */
 private:
@@ -112,6 +133,85 @@ private:
     QString good_color;
     QString warn_color;
 
+    /* Labels color states (-1 = unset, 0 = good, 1 = warn) */
+    struct label_states_struct{
+        int untyped;
+        int faces;
+        int plates;
+        int preinvalidated;
+    } label_states;
+
+    /* Background YML saves */
+    AnnotationSaver* saver;
+
+    /* Autosave timer */
+    QTimer* autosave_timer;
+
+    /* Last autosave snapshot (unchanged objects are not saved again) */
+    QByteArray autosave_snapshot;
+
+    /* Pending close state (close is completed once destination save is reported) */
+    struct closing_struct{
+
+        /* Destination YML being saved (empty if none) */
+        QString path;
+
+        /* Whether saved session item is marked as validated */
+        bool validate;
+
+        /* Saved session item timestamp */
+        QString timestamp;
+
+        /* Whether next close is accepted without asking (save completed) */
+        bool accepted;
+    } closing;
+
+    /* Session state container (session mode only) */
+    struct session_struct{
+
+        /* Validation session (NULL if not in session mode) */
+        ValidationSession* session;
+
+        /* Current item index */
+        int index;
+
+        /* Next panoramas loader */
+        PanoramaPrefetcher* prefetcher;
+
+        /* Objects snapshot after loading (to detect changes) */
+        QByteArray snapshot;
+
+        /* Whether validated YML did not exist when item was opened */
+        bool created;
+
+        /* Whether the session is being quit (current item is not advanced) */
+        bool quitting;
+    } session;
+
+    /* Function to initialize background saves and autosave timer */
+    void initializeSaves();
+
+    /* Function to start autosave of current destination YML */
+    void startAutosave();
+
+    /* Function to load objects from current YML files */
+    void loadObjects();
+
+    /* Function to switch to specified session item (returns false if its panorama cannot be loaded) */
+    bool openItem(int index);
+
+    /* Function to ask for saving current session item and mark it as validated (returns false if cancelled) */
+    bool closeItem();
+
+    /* Function to open next session item, unless session is quit (returns false if none was opened) */
+    bool nextItem();
+
+    /* Function to close views referencing current panorama objects */
+    void closeViews();
+
+    /* Function to set label color, stylesheet is only updated when state changes */
+    void setLabelState(QLabel* label, int &state, bool warn);
+
 /* Protected elements */
 protected:
 
@@ -0,0 +1,168 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef OBJECTGRID_H
+#define OBJECTGRID_H
+
+/* Includes */
+#include <QAbstractScrollArea>
+#include <QScrollBar>
+#include <QPainter>
+#include <QPixmap>
+#include <QCache>
+#include <QVector>
+#include <QList>
+#include <QMouseEvent>
+#include <QWheelEvent>
+
+#include "objectitem.h"
+
+/* Main class */
+class ObjectGrid : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    explicit ObjectGrid(QWidget *parent = 0);
+
+    /* Function to append an item (not owned), returns its index */
+    int appendItem(ObjectItem* item);
+
+    /* Function to get items count */
+    int count();
+
+    /* Function to get a specified item */
+    ObjectItem* item(int index);
+
+    /* Function to set cells size */
+    void setCellSize(int size);
+
+    /* Selection setter/getter */
+    void setSelected(int index, bool value);
+    bool isSelected(int index);
+
+    /* Selection operations */
+    void selectAll();
+    void unSelectAll();
+    void invertSelection();
+
+    /* Function to get indexes of items currently on screen */
+    QList<int> visibleItems();
+
+    /* Function called by items on change */
+    void itemChanged(int index, bool layout);
+
+/* Signals */
+signals:
+
+    /* Signal emitted when items on screen change */
+    void visibleItemsChanged();
+
+    /* Signal emitted when an item edition is requested */
+    void editRequested(int index);
+
+/* Protected functions / variables */
+protected:
+
+    /* Paint event */
+    void paintEvent(QPaintEvent *event);
+
+    /* Resize event */
+    void resizeEvent(QResizeEvent *event);
+
+    /* Scroll handler */
+    void scrollContentsBy(int dx, int dy);
+
+    /* Mouse press event */
+    void mousePressEvent(QMouseEvent *event);
+
+    /* Mouse double click event */
+    void mouseDoubleClickEvent(QMouseEvent *event);
+
+    /* Mouse wheel event */
+    void wheelEvent(QWheelEvent *event);
+
+/* Private functions / variables */
+private:
+
+    /* Items (not owned) */
+    QVector<ObjectItem*> items;
+
+    /* Flat selection states */
+    QVector<char> selected;
+
+    /* Indexes of displayed (not removed) items */
+    QVector<int> shown;
+
+    /* Cells geometry */
+    int cell_size;
+    int margin;
+    int spacing;
+    int border_size;
+
+    /* Scaled thumbnails of recently painted cells */
+    QCache<int, QPixmap> pixmaps;
+
+    /* Type and blur icons */
+    QPixmap icon_face;
+    QPixmap icon_plate;
+    QPixmap icon_blur;
+
+    /* Function to get number of columns */
+    int columns();
+
+    /* Function to get the range of displayed positions on screen */
+    void visibleRange(int &first, int &last);
+
+    /* Function to get displayed item at a viewport position, -1 if none */
+    int itemAt(QPoint pos);
+
+    /* Function to rebuild displayed items list */
+    void updateShown();
+
+    /* Function to update scroll bar range */
+    void updateScrollBar();
+
+    /* Function to paint a cell */
+    void paintCell(QPainter &painter, QRect cell, int index);
+};
+
+#endif // OBJECTGRID_H
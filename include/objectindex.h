@@ -0,0 +1,120 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef OBJECTINDEX_H
+#define OBJECTINDEX_H
+
+/* Includes */
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <qmath.h>
+
+#include <inter-all.h>
+#include <gnomonic-all.h>
+
+#include "objectrect.h"
+
+/* Grid size (longitude x latitude cells) */
+#define OBJECT_INDEX_LON_CELLS 72
+#define OBJECT_INDEX_LAT_CELLS 36
+
+/* Indexed object structure */
+struct object_index_entry_struct{
+    ObjectRect* rect;
+    double x;
+    double y;
+    double z;
+    double radius;
+};
+
+/* Main class */
+class ObjectIndex
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    ObjectIndex();
+
+    /* Function to get objects that may be seen in a view, returns true if the index was rebuilt */
+    bool query(const QList<ObjectRect*> &rects,
+               float width,
+               float height,
+               float azimuth,
+               float elevation,
+               float aperture,
+               QList<ObjectRect*> &candidates);
+
+    /* Function to force index rebuild on next query (objects added or removed) */
+    void invalidate();
+
+    /* Function to re-bucket a single reprojected object (attached objects call it when moved or resized) */
+    void update(ObjectRect* rect);
+
+/* Private functions / variables */
+private:
+
+    /* Grid cells (objects bucketed by center direction) */
+    QVector< QVector<object_index_entry_struct> > cells;
+
+    /* Objects without valid direction (always candidates) */
+    QList<ObjectRect*> unbounded;
+
+    /* Objects cells (-1 for unbounded objects) */
+    QHash<ObjectRect*, int> locations;
+
+    /* Largest object angular radius */
+    double max_radius;
+
+    /* Objects count the index was built with */
+    int count;
+    bool valid;
+
+    /* Function to build index */
+    void build(const QList<ObjectRect*> &rects);
+
+    /* Function to insert an object in its center cell */
+    void insert(ObjectRect* rect);
+
+    /* Function to get cell index of a direction */
+    int cell(int lon, int lat);
+};
+
+#endif // OBJECTINDEX_H
@@ -40,42 +40,39 @@
 #define OBJECTITEM_H
 
 /* Includes */
-#include <QWidget>
 #include <QImage>
-#include <QPixmap>
-#include <QMouseEvent>
+#include <QSize>
 #include "objectrect.h"
-#include "panoramaviewer.h"
+#include "trace.h"
 
-namespace Ui {
-class ObjectItem;
-}
+/* Item view (grid) container */
+class ObjectGrid;
 
 /* Main class */
-class ObjectItem : public QWidget
+class ObjectItem
 {
-    Q_OBJECT
 
 /* Public functions / variables */
 public:
 
-    /* Constructors */
-    explicit ObjectItem(QWidget *parent = 0);
-    explicit ObjectItem(QWidget *parent, PanoramaViewer* pano, ObjectRect* rect);
+    /* Constructor */
+    explicit ObjectItem(ObjectRect* rect);
 
     /* Destructor */
     ~ObjectItem();
 
-    /* Set source image */
-    bool setImage(QImage image);
+    /* Source image setter/getter */
+    void setImage(QImage image);
+    QImage getImage();
+
+    /* Set placeholder aspect (displayed until an image is set) */
+    void setPlaceholder(QSize size);
+    QSize getPlaceholder();
 
     /* ID setter/getter */
     void setId(int id);
     int  getId();
 
-    /* Function to change the tile size */
-    void setSize(QSize size);
-
     /* Item type setter/getter */
     void setItemType(int type);
     int  getItemType();
@@ -88,35 +85,33 @@ public:
     void setBlurred(bool value);
     bool isBlurred();
 
-    /* Selected flag setter/getter */
-    void setSelected(bool value);
-    bool isSelected();
-
     /* Function to assign a parent ObjectRect to item */
     void setParentRect(ObjectRect* rect);
 
     /* Function to get parent ObjectRect */
     ObjectRect* getParentRect();
 
-    /* Function to assign parent PanoramaViewer */
-    void setPano(PanoramaViewer* pano);
+    /* Function to attach item to its view */
+    void setView(ObjectGrid* view, int index);
 
     /* Function to remove item */
     void remove(bool value);
 
-    /* Manual state setter */
+    /* Manual state setter/getter */
     void setItemManualState(int state);
+    int  getItemManualState();
 
-    /* Automatic state setter */
+    /* Automatic state setter/getter */
     void setItemAutomaticState(int state);
+    int  getItemAutomaticState();
 
     /* Automatic status setter/getter */
-    void setAutomaticStatus(QString value);
-    QString getAutomaticStatus();
+    void setAutomaticStatus(int value);
+    int getAutomaticStatus();
 
     /* Manual status setter/getter */
-    void setManualStatus(QString value);
-    QString getManualStatus();
+    void setManualStatus(int value);
+    int getManualStatus();
 
     /* Function to determine if object is valid */
     bool isValid();
@@ -127,9 +122,6 @@ public:
 /* Private functions / variables */
 private:
 
-    /* Main UI container */
-    Ui::ObjectItem *ui;
-
     /* Item ID container */
     int id;
 
@@ -145,12 +137,6 @@ private:
     /* Item manual state container */
     int manual_state;
 
-    /* Item border size container */
-    int border_size;
-
-    /* Selected status container */
-    bool selected;
-
     /* Valid status container */
     bool valid;
 
@@ -163,27 +149,24 @@ private:
     /* Item tile image */
     QImage image;
 
+    /* Item placeholder aspect */
+    QSize placeholder;
+
     /* Manual status container */
-    QString manualStatus;
+    int manualStatus;
 
     /* Automatic status container */
-    QString autoStatus;
+    int autoStatus;
 
     /* Parent rect copy container */
     ObjectRect* parent_rect_copy;
 
-    /* Parent PanoramaViewer container */
-    PanoramaViewer* parent_pano;
-
-/* Protected elements */
-protected:
-
-    /* Mouse press event */
-    void mousePressEvent(QMouseEvent *ev);
-
-    /* Mouse double click event */
-    void mouseDoubleClickEvent ( QMouseEvent * event );
+    /* Item view and index in view */
+    ObjectGrid* view;
+    int view_index;
 
+    /* Function to notify view of a change */
+    void changed(bool layout = false);
 };
 
 #endif // OBJECTITEM_H
@@ -99,6 +99,28 @@ struct ObjectSubType
     };
 };
 
+/* Forward declarations */
+class ObjectStats;
+class ObjectIndex;
+
+/* Object manual status struct */
+struct ObjectManualStatus
+{
+    enum Type
+    {
+        None = 0, Valid = 1, Invalid = 2
+    };
+};
+
+/* Object automatic (detector filters) status struct */
+struct ObjectAutomaticStatus
+{
+    enum Type
+    {
+        None = 0, Valid = 1, Ratio = 2, Size = 3, RatioSize = 4, MissingOption = 5
+    };
+};
+
 /* Main class */
 class ObjectRect : public QGraphicsPolygonItem
 {
@@ -109,6 +131,15 @@ public:
     /* Constructor */
     ObjectRect();
 
+    /* Destructor */
+    ~ObjectRect();
+
+    /* Function to attach object to a statistics model (counted while attached) */
+    void setStatistics(ObjectStats* stats);
+
+    /* Function to attach object to a spatial index (object is re-bucketed when reprojected) */
+    void setIndex(ObjectIndex* index);
+
     /* Childrens container */
     QList<ObjectRect*> childrens;
 
@@ -233,12 +264,12 @@ public:
     bool isBlurred();
 
     /* Manual status setter/getter */
-    void setManualStatus(QString value);
-    QString getManualStatus();
+    void setManualStatus(int value);
+    int getManualStatus();
 
     /* Automatic status setter/getter */
-    void setAutomaticStatus(QString value);
-    QString getAutomaticStatus();
+    void setAutomaticStatus(int value);
+    int getAutomaticStatus();
 
     /* Resize setter/getter */
     void setResizeEnabled(bool value);
@@ -282,6 +313,12 @@ private:
     /* Brush container */
     QBrush* brush;
 
+    /* Attached statistics model */
+    ObjectStats* stats;
+
+    /* Attached spatial index */
+    ObjectIndex* index;
+
     /* Projection parameters structure */
     struct projection_parameters_struct{
         float azimuth;
@@ -299,8 +336,8 @@ private:
         int sub_type;
         bool blurred;
         bool validated;
-        QString manual_status;
-        QString automatic_status;
+        int manual_status;
+        int automatic_status;
     } info;
 
     /* Function to render object */
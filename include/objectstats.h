@@ -0,0 +1,90 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef OBJECTSTATS_H
+#define OBJECTSTATS_H
+
+/* Includes */
+#include "objectrect.h"
+
+/* Main class */
+class ObjectStats
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    ObjectStats();
+
+    /* Function to count an object */
+    void add(ObjectRect* rect);
+
+    /* Function to uncount an object */
+    void remove(ObjectRect* rect);
+
+    /* Counters getters */
+    int untyped();
+    int faces();
+    int facesValidated();
+    int plates();
+    int platesValidated();
+    int preInvalidated();
+    int preInvalidatedValidated();
+    int toBlur();
+
+/* Private functions / variables */
+private:
+
+    /* Counters structure */
+    struct counters_struct{
+        int untyped;
+        int faces;
+        int faces_validated;
+        int plates;
+        int plates_validated;
+        int preinvalidated;
+        int preinvalidated_validated;
+        int toblur;
+    } counters;
+
+    /* Function to apply an object contribution to counters */
+    void apply(ObjectRect* rect, int delta);
+};
+
+#endif // OBJECTSTATS_H
@@ -0,0 +1,173 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef PANORAMACACHE_H
+#define PANORAMACACHE_H
+
+/* Includes */
+#include <QImage>
+#include <QCache>
+#include <QMutex>
+#include <QVector>
+#include <QList>
+#include <QRect>
+#include <QDir>
+#include <QFile>
+
+#include <opencv/cv.h>
+#include <opencv/highgui.h>
+
+#include "projection.h"
+
+/* Coarsest pyramid level width */
+#define PANORAMA_CACHE_COARSEST_WIDTH 512
+
+/* Maximal size of a resident level (in bytes), larger levels are file backed and sampled through tiles */
+#define PANORAMA_CACHE_RESIDENT_LIMIT ((qint64) 64 * 1024 * 1024)
+
+/* Pyramid level structure */
+struct panorama_level_struct{
+
+    /* Level dimensions */
+    int width;
+    int height;
+
+    /* Tiles grid dimensions */
+    int tiles_x;
+    int tiles_y;
+
+    /* Level sampled through cached tiles (pixels are file backed) */
+    bool tiled;
+
+    /* Level pixels (32 bits, kept uncompressed so samples match the source exactly) */
+    QImage image;
+};
+
+/* Main class */
+class PanoramaCache
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    PanoramaCache();
+
+    /* Function to build the image pyramid from a decoded image */
+    void load(IplImage* image, int threads);
+
+    /* Function to assign prebuilt pyramid levels (32 bits, full resolution first, pixels are shared) */
+    void load(const QList<QImage> &levels);
+
+    /* Function to build the pyramid levels of a 32 bits image (full resolution first, shared) */
+    static QList<QImage> pyramid(const QImage &full);
+
+    /* Function to get the number of pyramid levels of an image width */
+    static int depth(int width);
+
+    /* Function to allocate a 32 bits level, levels above resident limit are backed by an unlinked temporary file */
+    static QImage allocate(int width, int height);
+
+    /* Function to set the tiles memory budget (in bytes) */
+    void setMemoryBudget(qint64 bytes);
+
+    /* Function to get the tiles memory budget (in bytes) */
+    qint64 memoryBudget();
+
+    /* Function to get the resident pixels memory usage (in bytes) */
+    qint64 memoryUsage();
+
+    /* Full resolution dimensions getters */
+    int width();
+    int height();
+
+    /* Function to get number of pyramid levels */
+    int levels();
+
+    /* Function to select the coarsest level meeting a view resolution */
+    int selectLevel(int dest_width, float aperture);
+
+    /* Function to project a gnomonic view from specified level (returns false when cancelled) */
+    bool project(QImage* dest,
+                 float azimuth,
+                 float elevation,
+                 float aperture,
+                 int level,
+                 int threads,
+                 int interpolation = ProjectionInterpolation::Bilinear,
+                 const QAtomicInt* cancel = NULL,
+                 bool cache_map = true);
+
+    /* Function to project a window of a gnomonic view into a window sized image */
+    bool projectWindow(QImage* dest,
+                       int view_width,
+                       int view_height,
+                       const QRect &window,
+                       float azimuth,
+                       float elevation,
+                       float aperture,
+                       int level,
+                       int threads,
+                       int interpolation = ProjectionInterpolation::Bilinear,
+                       const QAtomicInt* cancel = NULL,
+                       bool cache_map = true);
+
+/* Private functions / variables */
+private:
+
+    /* Pyramid levels */
+    QVector<panorama_level_struct> levels_list;
+
+    /* Tiles LRU cache (cost in kilobytes) */
+    QCache<int, QImage> tiles_cache;
+
+    /* Tiles cache lock */
+    QMutex tiles_mutex;
+
+    /* Tile size (power of two) and its shift */
+    int tile_size;
+    int tile_shift;
+
+    /* Function to copy a specified tile from level pixels */
+    QImage copyTile(int level, int index);
+
+    /* Function to get level tiles, copying missing ones from level pixels */
+    void fetchTiles(int level, QVector<char> &needed, QVector<QImage> &tiles, int threads);
+};
+
+#endif // PANORAMACACHE_H
@@ -0,0 +1,146 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef PANORAMAPREFETCHER_H
+#define PANORAMAPREFETCHER_H
+
+/* Includes */
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QString>
+#include <QImage>
+#include <QImageReader>
+#include <iostream>
+
+#include <opencv/cv.h>
+#include <opencv/highgui.h>
+
+#include "panoramacache.h"
+#include "jpegdecoder.h"
+#include "decodecache.h"
+#include "trace.h"
+
+/* Loaded panorama structure */
+struct panorama_prefetch_struct{
+
+    /* Image path */
+    QString path;
+
+    /* Image pyramid (NULL if image could not be loaded), owned by the taker */
+    PanoramaCache* cache;
+
+    /* Image details */
+    int width;
+    int height;
+    int channels;
+};
+
+/* Main class */
+class PanoramaPrefetcher : public QThread
+{
+    Q_OBJECT
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    explicit PanoramaPrefetcher(QObject *parent = 0);
+
+    /* Destructor (unclaimed panorama is released) */
+    ~PanoramaPrefetcher();
+
+    /* Function to load a panorama (decoded in calling thread) */
+    static panorama_prefetch_struct load(QString path, int threads);
+
+    /* Function to load a reduced resolution preview of a JPEG panorama, decoded in DCT domain (NULL cache if not worth it) */
+    static panorama_prefetch_struct loadPreview(QString path, int threads, int view_width);
+
+    /* Function to set the loading parameters (threads count) */
+    void setup(int threads);
+
+    /* Function to queue a panorama loading, superseding any pending one */
+    void prefetch(QString path);
+
+    /* Function to take a panorama, waiting for its prefetch or loading it if it was not requested */
+    panorama_prefetch_struct take(QString path);
+
+    /* Function to release a loaded or pending panorama which is not needed anymore */
+    void discard(QString path);
+
+    /* Function to stop the loading loop */
+    void stop();
+
+/* Signals */
+signals:
+
+    /* Function to report a loaded panorama (ready to be taken) */
+    void loaded(QString path);
+
+/* Protected functions / variables */
+protected:
+
+    /* Loading loop */
+    void run();
+
+/* Private functions / variables */
+private:
+
+    /* Requests lock and conditions */
+    QMutex mutex;
+    QWaitCondition condition;
+    QWaitCondition done;
+
+    /* Pending and in-flight paths */
+    QString pending;
+    QString loading;
+
+    /* Loaded panorama waiting to be taken */
+    panorama_prefetch_struct ready;
+
+    /* Loading parameters */
+    int threads_count;
+
+    /* Loading loop termination flag */
+    bool stopping;
+
+    /* Function to release the loaded panorama */
+    void release();
+};
+
+#endif // PANORAMAPREFETCHER_H
@@ -0,0 +1,151 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef PANORAMARENDERER_H
+#define PANORAMARENDERER_H
+
+/* Includes */
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QImage>
+#include <QVector>
+
+#include "panoramacache.h"
+#include "trace.h"
+
+/* Render request structure */
+struct panorama_render_request_struct{
+
+    /* Source panorama */
+    PanoramaCache* cache;
+
+    /* View orientation and aperture */
+    float azimuth;
+    float elevation;
+    float aperture;
+
+    /* Full quality frame dimensions */
+    int width;
+    int height;
+
+    /* Number of threads */
+    int threads;
+
+    /* Request generation (increasing) */
+    int generation;
+};
+
+/* Main class */
+class PanoramaRenderer : public QThread
+{
+    Q_OBJECT
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    explicit PanoramaRenderer(QObject *parent = 0);
+
+    /* Destructor */
+    ~PanoramaRenderer();
+
+    /* Function to request a new frame, superseding any pending one */
+    void request(const panorama_render_request_struct &request);
+
+    /* Function to set the maximal pixels count of draft frames */
+    void setDraftPixels(int pixels);
+
+    /* Function to set the idle delay before refining a frame (in milliseconds) */
+    void setRefineDelay(int msecs);
+
+    /* Function to drop pending request and wait for in-flight frame (its panorama can be released afterwards) */
+    void sync();
+
+/* Signals */
+signals:
+
+    /* Function to deliver a rendered frame */
+    void frameReady(QImage frame, int generation, bool final);
+
+/* Protected functions / variables */
+protected:
+
+    /* Render loop */
+    void run();
+
+/* Private functions / variables */
+private:
+
+    /* Requests lock and condition */
+    QMutex mutex;
+    QWaitCondition condition;
+
+    /* Latest pending request */
+    panorama_render_request_struct pending;
+    bool has_pending;
+
+    /* Request in-flight flag and its completion condition */
+    bool busy;
+    QWaitCondition idle;
+
+    /* Render loop termination flag */
+    bool stopping;
+
+    /* In-flight refinement cancellation flag */
+    QAtomicInt cancel;
+
+    /* Maximal pixels count of draft frames */
+    int draft_pixels;
+
+    /* Idle delay before refinement */
+    int refine_delay;
+
+    /* Frames pools (draft and refined), reused while the view size is unchanged */
+    QVector<QImage> draft_pool;
+    QVector<QImage> frame_pool;
+
+    /* Function to get a pool frame no longer referenced by the viewer */
+    QImage* acquireFrame(QVector<QImage> &pool, int width, int height);
+
+    /* Function to wait for the next request, returns false on termination */
+    bool nextRequest(panorama_render_request_struct &request);
+};
+
+#endif // PANORAMARENDERER_H
@@ -45,17 +45,26 @@
 #include <QScrollBar>
 #include <QImage>
 #include <QPixmap>
+#include <QPainter>
 #include <QGraphicsView>
 #include <QGraphicsScene>
 #include <QGraphicsProxyWidget>
 #include <QWheelEvent>
 #include <QMouseEvent>
+#include <QSet>
 
 #include <inter-all.h>
 #include <gnomonic-all.h>
 
 #include "g2g_point.h"
 #include "objectrect.h"
+#include "panoramacache.h"
+#include "panoramarenderer.h"
+#include "panoramaprefetcher.h"
+#include "cornermapper.h"
+#include "objectindex.h"
+#include "objectstats.h"
+#include "trace.h"
 #include "utils.h"
 
 /* Visibility groups struct */
@@ -78,6 +87,9 @@ public:
     /* Constructor */
     explicit PanoramaViewer(QWidget *parent = 0, bool connectSlots = true);
 
+    /* Destructor */
+    ~PanoramaViewer();
+
     /* Variable to store all image informations */
     image_info_struct image_info;
 
@@ -87,6 +99,12 @@ public:
     /* Main ObjectRect id indexes */
     int rect_list_id_index;
 
+    /* Function to append an object to main ObjectRect list (objects are counted in statistics and indexed) */
+    void appendObject(ObjectRect* rect);
+
+    /* Function to get objects statistics */
+    ObjectStats* statistics();
+
     /* Main setup function */
     void setup(int width,
                int height,
@@ -96,9 +114,21 @@ public:
                float zoom_def,
                int threads);
 
-    /* Function to load specified image */
+    /* Function to load specified image (a reduced preview is shown until full resolution is decoded) */
     void loadImage(QString path);
 
+    /* Function to show a loaded panorama, replacing current one (takes ownership of its cache) */
+    void setPanorama(const panorama_prefetch_struct &panorama);
+
+    /* Function to remove and delete all objects */
+    void clearObjects();
+
+    /* Function to get the panorama tiles cache memory budget (in bytes) */
+    qint64 cacheBudget();
+
+    /* Function to set the panorama tiles cache memory budget (in bytes) */
+    void setCacheBudget(qint64 bytes);
+
     /* Function to set zoom level */
     void setZoom(float zoom);
 
@@ -145,6 +175,12 @@ public:
     /* Function to crop an object and return its tile */
     QImage cropObject(ObjectRect* rect);
 
+    /* Function to replace shown preview by full resolution panorama (waits for its decoding) */
+    void requireFullResolution();
+
+    /* Function to get object selection in its crop view (view is widget sized) */
+    QRect cropSelection(ObjectRect* rect);
+
     /* Function to get current scene */
     QGraphicsScene* getScene();
 
@@ -181,6 +217,12 @@ public slots:
     /* Slot for main window scale slider update */
     void updateScaleSlider_slot(int value);
 
+    /* Slot for background rendered frames */
+    void frameReady_slot(QImage frame, int generation, bool final);
+
+    /* Slot for background decoded full resolution panoramas */
+    void panoramaLoaded_slot(QString path);
+
 /* Private functions / variables */
 private:
 
@@ -196,11 +238,30 @@ private:
     /* Main PanoramaViewer scene */
     QGraphicsScene* scene;
 
-    /* Destination image to be shown */
-    QImage dest_image;
+    /* Destination image (scene) size */
+    QSize dest_size;
+
+    /* Background frames renderer */
+    PanoramaRenderer* renderer;
+
+    /* Background full resolution loader (while preview is shown) */
+    PanoramaPrefetcher* loader;
+
+    /* Replaced preview pyramids (views created meanwhile may reference them) */
+    QList<PanoramaCache*> retired_caches;
+
+    /* Whether the shown panorama is the preview (full resolution not taken yet) */
+    bool preview_shown;
 
-    /* Destination image to be shown in pixmap format */
-    QPixmap dest_image_map;
+    /* Last requested/displayed frames generations */
+    int render_generation;
+    int frame_generation;
+
+    /* Last frame request time (trace time, -1 if not traced) */
+    qint64 request_time;
+
+    /* Frame times overlay (shown when tracing) */
+    QGraphicsSimpleTextItem* trace_overlay;
 
     /* Main image path */
     QString image_path;
@@ -208,6 +269,9 @@ private:
     /* Main threads count */
     int threads_count;
 
+    /* Panorama tiles cache memory budget */
+    qint64 cache_budget;
+
     /* Zoom settings */
     float zoom_min;
     float zoom_max;
@@ -224,9 +288,6 @@ private:
     bool createEnabled;
     bool editEnabled;
 
-    /* Main pixmap initialized value storage */
-    bool pixmap_initialized;
-
     /* Variables to store previous sizes on window resize */
     int previous_height;
     int previous_width;
@@ -237,9 +298,30 @@ private:
     /* Current visibility group */
     int vis_group;
 
-    /* Last rendered pixmap */
+    /* Persistent panorama pixmap item */
     QGraphicsPixmapItem* last_pixmap;
 
+    /* Persistent pixmap buffers (draft and refined frames) */
+    QPixmap frame_pixmaps[2];
+
+    /* Objects corners mapper */
+    CornerMapper corners;
+
+    /* Objects spatial index */
+    ObjectIndex object_index;
+
+    /* Objects near current view (in corners mapper order) */
+    QList<ObjectRect*> view_rects;
+
+    /* Objects currently shown */
+    QSet<ObjectRect*> shown_rects;
+
+    /* Hide all objects on next visibility update */
+    bool hide_all;
+
+    /* Objects statistics (types / statuses counters) */
+    ObjectStats stats;
+
     /* Main sight container */
     QGraphicsRectItem* sight;
 
@@ -306,8 +388,17 @@ private:
                          QPointF p3,
                          QPointF p4);
 
-    /* Function to apply visibility groups */
-    void applyVisGroup();
+    /* Function to apply visibility groups (objects corners are mapped unless already done) */
+    void applyVisGroup(bool mapped = false);
+
+    /* Function to get objects near current view from spatial index */
+    void queryView();
+
+    /* Function to show specified objects and hide previously shown ones */
+    void showObjects(const QSet<ObjectRect*> &visible);
+
+    /* Function to update frame times overlay */
+    void updateTraceOverlay();
 
 /* Signals */
 signals:
@@ -0,0 +1,161 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef PROJECTION_H
+#define PROJECTION_H
+
+/* Includes */
+#include <QImage>
+#include <QAtomicInt>
+
+#include <inter-all.h>
+#include <gnomonic-all.h>
+
+/* Fractional bits of fixed point coordinates */
+#define PROJECTION_FIXED_SHIFT 8
+#define PROJECTION_FIXED_ONE   ( 1 << PROJECTION_FIXED_SHIFT )
+#define PROJECTION_FIXED_MASK  ( PROJECTION_FIXED_ONE - 1 )
+
+/* Projection interpolation struct */
+struct ProjectionInterpolation
+{
+    enum Type
+    {
+        Nearest = 0, Bilinear = 1
+    };
+};
+
+/*! \brief Gnomonic viewport source coordinates
+ *
+ *  This function computes, for each pixel of a window of a rectilinear
+ *  image, the position of its source point in the equirectangular image. Coordinates
+ *  are stored as interleaved (x, y) pairs in fixed point format, with
+ *  PROJECTION_FIXED_SHIFT fractional bits. The conventions are the same as
+ *  the g2g_point and etg_point functions.
+ *
+ *  \param  coords   Destination coordinates buffer (2 * w_width * w_height)
+ *  \param  e_width  Width, in pixels, of the equirectangular image
+ *  \param  e_height Height, in pixels, of the equirectangular image
+ *  \param  c_width  Width, in pixels, of the rectilinear image
+ *  \param  c_height Height, in pixels, of the rectilinear image
+ *  \param  w_x      Window left position in the rectilinear image
+ *  \param  w_y      Window top position in the rectilinear image
+ *  \param  w_width  Window width, in pixels
+ *  \param  w_height Window height, in pixels
+ *  \param  c_azim   Azimuth of gnomonic center
+ *  \param  c_elev   Elevation of gnomonic center
+ *  \param  c_appe   Apperture of the gnomonic projection
+ *  \param  threads  Number of threads
+ *  \param  cancel   Optional flag, rows are skipped once it is set
+ */
+
+void projection_coordinates(
+
+    qint32 * const coords,
+    int      const e_width,
+    int      const e_height,
+    int      const c_width,
+    int      const c_height,
+    int      const w_x,
+    int      const w_y,
+    int      const w_width,
+    int      const w_height,
+    double   const c_azim,
+    double   const c_elev,
+    double   const c_appe,
+    int      const threads,
+    QAtomicInt const * const cancel = NULL
+
+);
+
+/*! \brief Equirectangular image sampling
+ *
+ *  This function fills a rectilinear RGB32 image by sampling a contiguous
+ *  equirectangular RGB32 image at the coordinates computed by
+ *  projection_coordinates, using nearest or bilinear interpolation.
+ *
+ *  \param  coords   Source coordinates buffer
+ *  \param  e_bits   Equirectangular image pixels
+ *  \param  e_width  Width, in pixels, of the equirectangular image
+ *  \param  e_height Height, in pixels, of the equirectangular image
+ *  \param  e_stride Equirectangular image stride, in pixels
+ *  \param  c_bits   Rectilinear image (or window) pixels
+ *  \param  c_width  Width, in pixels, of the rectilinear image (or window)
+ *  \param  c_height Height, in pixels, of the rectilinear image (or window)
+ *  \param  c_stride Rectilinear image stride, in pixels
+ *  \param  interp   Interpolation method (ProjectionInterpolation)
+ *  \param  threads  Number of threads
+ *  \param  cancel   Optional flag, rows are skipped once it is set
+ */
+
+void projection_gather(
+
+    qint32 const * const coords,
+    QRgb   const * const e_bits,
+    int            const e_width,
+    int            const e_height,
+    int            const e_stride,
+    QRgb         * const c_bits,
+    int            const c_width,
+    int            const c_height,
+    int            const c_stride,
+    int            const interp,
+    int            const threads,
+    QAtomicInt const * const cancel = NULL
+
+);
+
+/* Function to interpolate four pixels with 8 bits fixed point weights */
+inline QRgb projection_bilinear(QRgb p00, QRgb p10, QRgb p01, QRgb p11, int wx, int wy)
+{
+    /* Compute corners weights */
+    int w00 = ( 256 - wx ) * ( 256 - wy );
+    int w10 = wx * ( 256 - wy );
+    int w01 = ( 256 - wx ) * wy;
+    int w11 = wx * wy;
+
+    /* Interpolate channels */
+    int r = ( qRed( p00 ) * w00 + qRed( p10 ) * w10 + qRed( p01 ) * w01 + qRed( p11 ) * w11 ) >> 16;
+    int g = ( qGreen( p00 ) * w00 + qGreen( p10 ) * w10 + qGreen( p01 ) * w01 + qGreen( p11 ) * w11 ) >> 16;
+    int b = ( qBlue( p00 ) * w00 + qBlue( p10 ) * w10 + qBlue( p01 ) * w01 + qBlue( p11 ) * w11 ) >> 16;
+
+    /* Return opaque result */
+    return qRgb( r, g, b );
+}
+
+#endif // PROJECTION_H
@@ -0,0 +1,127 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef PROJECTIONMAP_H
+#define PROJECTIONMAP_H
+
+/* Includes */
+#include <QCache>
+#include <QMutex>
+#include <QVector>
+#include <QHash>
+#include <QRect>
+
+#include "projection.h"
+
+/* Projection map key structure */
+struct projection_map_key_struct{
+
+    /* Equirectangular dimensions */
+    int e_width;
+    int e_height;
+
+    /* Rectilinear dimensions */
+    int c_width;
+    int c_height;
+
+    /* Rectilinear window */
+    int w_x;
+    int w_y;
+    int w_width;
+    int w_height;
+
+    /* View parameters */
+    float azimuth;
+    float elevation;
+    float aperture;
+};
+
+/* Projection map key comparison */
+inline bool operator==(const projection_map_key_struct &a, const projection_map_key_struct &b)
+{
+    return a.e_width == b.e_width && a.e_height == b.e_height &&
+           a.c_width == b.c_width && a.c_height == b.c_height &&
+           a.w_x == b.w_x && a.w_y == b.w_y && a.w_width == b.w_width && a.w_height == b.w_height &&
+           a.azimuth == b.azimuth && a.elevation == b.elevation && a.aperture == b.aperture;
+}
+
+/* Projection map key hash */
+inline uint qHash(const projection_map_key_struct &key)
+{
+    return qHash( QByteArray::fromRawData( (const char *) &key, sizeof( key ) ) );
+}
+
+/* Main class */
+class ProjectionMapCache
+{
+
+/* Public functions / variables */
+public:
+
+    /* Function to get the process wide maps cache (viewer frames only, one-shot crops and exports bypass it) */
+    static ProjectionMapCache* instance();
+
+    /* Constructor */
+    ProjectionMapCache();
+
+    /* Function to set the maps memory budget (in bytes) */
+    void setMemoryBudget(qint64 bytes);
+
+    /* Function to get the fixed point coordinates map of a view window, computing it if missing */
+    QVector<qint32> map(int e_width,
+                        int e_height,
+                        int c_width,
+                        int c_height,
+                        const QRect &window,
+                        float azimuth,
+                        float elevation,
+                        float aperture,
+                        int threads,
+                        const QAtomicInt* cancel = NULL);
+
+/* Private functions / variables */
+private:
+
+    /* Maps LRU cache (cost in kilobytes) */
+    QCache<projection_map_key_struct, QVector<qint32> > maps_cache;
+
+    /* Maps cache lock */
+    QMutex maps_mutex;
+};
+
+#endif // PROJECTIONMAP_H
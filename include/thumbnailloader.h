@@ -0,0 +1,160 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef THUMBNAILLOADER_H
+#define THUMBNAILLOADER_H
+
+/* Includes */
+#include <QObject>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QMutex>
+#include <QVector>
+#include <QList>
+#include <QImage>
+#include <QRect>
+
+#include "panoramacache.h"
+
+/* Thumbnail job structure */
+struct thumbnail_job_struct{
+
+    /* Projection view dimensions */
+    int view_width;
+    int view_height;
+
+    /* Object selection in view */
+    QRect window;
+
+    /* Projection parameters */
+    float azimuth;
+    float elevation;
+    float aperture;
+};
+
+/* Main class */
+class ThumbnailLoader : public QObject
+{
+    Q_OBJECT
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    explicit ThumbnailLoader(PanoramaCache* cache, QObject *parent = 0);
+
+    /* Destructor (cancels pending jobs and waits for running ones) */
+    ~ThumbnailLoader();
+
+    /* Function to queue a thumbnail, returns its index */
+    int append(const thumbnail_job_struct &job);
+
+    /* Function to move specified thumbnails ahead of the queue */
+    void prioritize(const QList<int> &indexes);
+
+    /* Function to cancel all pending thumbnails */
+    void cancel();
+
+    /* Function to process queued thumbnails (called from pool threads) */
+    void process();
+
+/* Signals */
+signals:
+
+    /* Function to deliver a generated thumbnail */
+    void thumbnailReady(int index, QImage image);
+
+/* Private functions / variables */
+private:
+
+    /* Thumbnail state struct */
+    struct ThumbnailState
+    {
+        enum Type
+        {
+            Queued = 0, Running = 1, Done = 2
+        };
+    };
+
+    /* Source panorama */
+    PanoramaCache* cache;
+
+    /* Workers pool */
+    QThreadPool pool;
+
+    /* Queue lock */
+    QMutex mutex;
+
+    /* Jobs and their states */
+    QVector<thumbnail_job_struct> jobs;
+    QVector<int> states;
+
+    /* Prioritized jobs indexes */
+    QList<int> priority;
+
+    /* Next job index in insertion order */
+    int next_index;
+
+    /* Number of started workers */
+    int workers;
+
+    /* Function to take next job index, -1 when queue is empty */
+    int takeJob();
+};
+
+/* Worker runnable */
+class ThumbnailTask : public QRunnable
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    explicit ThumbnailTask(ThumbnailLoader* loader) : loader(loader) {}
+
+    /* Run function */
+    void run() { this->loader->process(); }
+
+/* Private functions / variables */
+private:
+
+    /* Parent loader */
+    ThumbnailLoader* loader;
+};
+
+#endif // THUMBNAILLOADER_H
@@ -0,0 +1,155 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/* Includes */
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+/* Trace events ring buffer size (power of two) */
+#define TRACE_RING_SIZE 65536
+
+/* Trace event structure */
+struct trace_event_struct{
+
+    /* Zone name (static string) */
+    const char* name;
+
+    /* Start time and duration (in nanoseconds since tracing was enabled) */
+    qint64 start;
+    qint64 duration;
+
+    /* Recording thread */
+    quintptr thread;
+};
+
+/* Trace ring slot structure */
+struct trace_slot_struct{
+
+    /* Published event number + 1 (0 while slot is unwritten or being written) */
+    QAtomicInt sequence;
+
+    /* Recorded event */
+    trace_event_struct event;
+};
+
+/* Main class */
+class Trace
+{
+
+/* Public functions / variables */
+public:
+
+    /* Function to enable/disable tracing (ring buffer is allocated on first enable) */
+    static void setEnabled(bool value);
+
+    /* Function to check if tracing is enabled (inlined, zones cost a single load when disabled) */
+    static inline bool enabled() { return Trace::active.load() != 0; }
+
+    /* Function to get current trace time (in nanoseconds) */
+    static qint64 now();
+
+    /* Function to record a completed zone */
+    static void record(const char* name, qint64 start, qint64 duration);
+
+    /* Function to get recorded events (oldest first) */
+    static QList<trace_event_struct> events();
+
+    /* Function to get the mean duration of last events of a zone (in milliseconds, -1 if none) */
+    static double average(const char* name, int samples = 30);
+
+    /* Function to get recorded events as Chrome trace-event JSON (chrome://tracing) */
+    static QByteArray toChromeJson();
+
+    /* Function to write recorded events as Chrome trace-event JSON */
+    static bool dump(QString path);
+
+/* Private functions / variables */
+private:
+
+    /* Tracing state */
+    static QAtomicInt active;
+
+    /* Number of recorded events (ring position) */
+    static QAtomicInt head;
+
+    /* Events ring buffer */
+    static trace_slot_struct* ring;
+
+    /* Function to read the published event of specified number, returns false if it is not (or no longer) available */
+    static bool readEvent(unsigned int number, trace_event_struct &event);
+
+    /* Trace clock */
+    static QElapsedTimer clock;
+};
+
+/* Scoped timing zone, recorded on destruction if tracing is enabled */
+class TraceZone
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    explicit TraceZone(const char* name) : name(name), start( Trace::enabled() ? Trace::now() : -1 ) {}
+
+    /* Destructor */
+    ~TraceZone() { if( this->start >= 0 ) Trace::record( this->name, this->start, Trace::now() - this->start ); }
+
+/* Private functions / variables */
+private:
+
+    /* Zone name */
+    const char* name;
+
+    /* Start time (-1 if tracing is disabled) */
+    qint64 start;
+};
+
+#endif // TRACE_H
@@ -49,20 +49,36 @@
 #include <gnomonic-all.h>
 #include "objectrect.h"
 
+/* Forward declarations */
+class PanoramaCache;
+
 /* Image info structure */
 struct image_info_struct{
     QImage* image;
+    PanoramaCache* cache;
     int width;
     int height;
     int channels;
 };
 
 /* Function to convert an OpenCV IplImage into a QImage */
-QImage*  IplImage2QImage(IplImage *iplImg);
+QImage*  IplImage2QImage(IplImage *iplImg, int threads = QThread::idealThreadCount());
+
+/* Function to convert an OpenCV IplImage into a QImage, taking ownership of the IplImage (wrapped without copy when possible) */
+QImage*  IplImage2QImageAdopt(IplImage *iplImg, int threads = QThread::idealThreadCount());
+
+/* Function to convert an OpenCV IplImage into a QImage, reference per-pixel implementation */
+QImage*  IplImage2QImageReference(IplImage *iplImg);
 
 /* Function to export an object to disk */
 void exportRect(ObjectRect* rect, image_info_struct image_info, QString destination, float zoom_level = 1.5);
 
+/* Function to get an object export selection (in its zoomed projection view) */
+QRect exportSelection(ObjectRect* rect, float zoom_level = 1.5);
+
+/* Function to project an object export selection */
+QImage exportImage(ObjectRect* rect, const image_info_struct &image_info, QRect selection, float zoom_level = 1.5, int threads = QThread::idealThreadCount());
+
 /* Function to clamp a specified value */
 float clamp(float x, float a, float b);
 
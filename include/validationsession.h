@@ -0,0 +1,114 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef VALIDATIONSESSION_H
+#define VALIDATIONSESSION_H
+
+/* Includes */
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QRegExp>
+#include <iostream>
+
+/* Session item structure (one panorama of a yafdb blurring directory) */
+struct validation_item_struct{
+
+    /* Panorama timestamp */
+    QString timestamp;
+
+    /* Panorama image path */
+    QString image_path;
+
+    /* Detector YML path */
+    QString detector_yml_path;
+
+    /* Validated YML path */
+    QString destination_yml_path;
+};
+
+/* Main class */
+class ValidationSession
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor */
+    ValidationSession();
+
+    /* Function to open a yafdb blurring directory (state file is relative to it), returns false if invalid */
+    bool open(QString path, QString state_path = "validated.job", bool revalidate = false);
+
+    /* Function to get number of items to validate */
+    int count();
+
+    /* Function to get specified item */
+    validation_item_struct item(int index);
+
+    /* Function to check if a timestamp is marked as validated */
+    bool isValidated(QString timestamp);
+
+    /* Function to mark a timestamp as validated (state file is rewritten atomically) */
+    bool markValidated(QString timestamp);
+
+/* Private functions / variables */
+private:
+
+    /* Items to validate */
+    QList<validation_item_struct> items;
+
+    /* Validated timestamps (in state file order) */
+    QStringList state;
+
+    /* State file path */
+    QString state_path;
+
+    /* Function to read validated timestamps from state file */
+    void loadState();
+
+    /* Function to write validated timestamps to state file */
+    bool saveState();
+};
+
+#endif // VALIDATIONSESSION_H
@@ -0,0 +1,120 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+#ifndef YMLCONVERTER_H
+#define YMLCONVERTER_H
+
+/* Includes */
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSize>
+#include <QAtomicInt>
+#include <QFileInfo>
+#include <QDir>
+#include <QImageReader>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <iostream>
+
+#include "ymlparser.h"
+
+/* YML conversion status structure */
+struct YMLConvertStatus
+{
+    enum Type
+    {
+        Converted = 1, /* Converted YML written */
+        Skipped   = 2, /* No objects in detector YML, empty YML written */
+        Failed    = 3  /* Conversion failed */
+    };
+};
+
+/* YML conversion job structure */
+struct yml_convert_job_struct{
+    QString source_path;
+    QString destination_path;
+};
+
+/* Main class */
+class YMLConverter
+{
+
+/* Public functions / variables */
+public:
+
+    /* Constructor (image path is optional, taken from YML when empty) */
+    YMLConverter(QString image_path = QString());
+
+    /* Function to get an image size from its header only */
+    static QSize imageSize(QString path);
+
+    /* Function to convert detector YMLs on specified number of threads, returns number of failed conversions */
+    int convert(QList<yml_convert_job_struct> jobs, int threads, int* skipped = NULL);
+
+    /* Function to convert one detector YML */
+    YMLConvertStatus::Type convertJob(const yml_convert_job_struct &job);
+
+/* Private functions / variables */
+private:
+
+    /* Images path (shared by all jobs when not empty) */
+    QString image_path;
+};
+
+/* Conversion functor for QtConcurrent */
+struct YMLConvertFunctor
+{
+    /* Constructor */
+    YMLConvertFunctor(YMLConverter* converter, QAtomicInt* failed, QAtomicInt* skipped);
+
+    /* Convert function */
+    void operator()(const yml_convert_job_struct &job);
+
+    /* Parent converter */
+    YMLConverter* converter;
+
+    /* Failed conversions counter */
+    QAtomicInt* failed;
+
+    /* Skipped conversions counter */
+    QAtomicInt* skipped;
+};
+
+#endif // YMLCONVERTER_H
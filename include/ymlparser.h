@@ -42,8 +42,16 @@
 /* Includes */
 #include <opencv2/core/core.hpp>
 #include "objectrect.h"
+#include "annotationfile.h"
+#include "trace.h"
 #include <QString>
 #include <QList>
+#include <QVector>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <iostream>
 
 /* YML type structure */
 struct YMLType
@@ -55,6 +63,25 @@ struct YMLType
     };
 };
 
+/* YML load statistics structure */
+struct yml_load_stats_struct{
+
+    /* Size of the file in bytes */
+    qint64 bytes;
+
+    /* Number of loaded objects */
+    int objects;
+
+    /* Loading time in nanoseconds */
+    qint64 elapsed;
+
+    /* Whether the streaming reader was used (false if FileStorage fallback was used) */
+    bool streamed;
+
+    /* Whether an up to date binary sidecar was read instead of the YML */
+    bool binary;
+};
+
 /* Main class */
 class YMLParser
 {
@@ -65,20 +92,100 @@ public:
     /* Constructor */
     YMLParser();
 
-    /* Function to write ObjectRect list to YML file on disk */
-    void writeYML(QList<ObjectRect*> objects, QString path);
+    /* Function to write ObjectRect list to YML file on disk (atomically) */
+    bool writeYML(QList<ObjectRect*> objects, QString path);
+
+    /* Function to write objects snapshot (see AnnotationFile::serialize) to YML file on disk (atomically) */
+    bool writeSnapshot(const QByteArray &snapshot, QString path);
 
     /* Function load ObjectRect list from YML file on disk */
     QList<ObjectRect*> loadYML(QString path, int ymltype = YMLType::Validator);
 
+    /* Function to get statistics of last loaded YML */
+    yml_load_stats_struct loadStats();
+
+    /* Function to print statistics of last loaded YML (parse throughput) */
+    void printLoadStats(QString path);
+
+    /* Functions to convert manual status from/to its YML name */
+    static QString manualStatusName(int status);
+    static int manualStatusFromName(QString name);
+
+    /* Functions to convert automatic status from/to its YML name */
+    static QString automaticStatusName(int status);
+    static int automaticStatusFromName(QString name, int ymltype = YMLType::Validator);
+
 /* Private functions / variables */
 private:
 
-    /* Function to write specific ObjectRect into YML file */
-    void writeItem(cv::FileStorage &fs, ObjectRect* obj);
+    /* YML object tags structure (as read from file) */
+    struct yml_item_struct{
+        QString falsePositive;
+        QString className;
+        QString subClassName;
+        QString autoStatus;
+        QString manualStatus;
+        QString blurObject;
+
+        /* Area points (p1, p2, p3, p4) */
+        QPointF area[4];
+
+        /* Projection parameters */
+        float azimuth;
+        float elevation;
+        float aperture;
+        float width;
+        float height;
+
+        /* Childrens tags */
+        QList<yml_item_struct> childrens;
+
+        /* Constructor */
+        yml_item_struct() : azimuth(0.0), elevation(0.0), aperture(0.0), width(0.0), height(0.0) {}
+    };
+
+    /* Streaming reader frame kinds */
+    struct YMLFrame
+    {
+        enum Type
+        {
+            Root = 0, List = 1, Item = 2, Area = 3, Params = 4, Skip = 5
+        };
+    };
+
+    /* Streaming reader frame (one per open block) */
+    struct yml_frame_struct{
+        int indent;
+        int kind;
+        int list;
+        yml_item_struct* item;
+    };
+
+    /* Statistics of last loaded YML */
+    yml_load_stats_struct load_stats;
+
+    /* Function to write specific object record into YML file */
+    void writeItem(cv::FileStorage &fs, const annotation_record_struct &record);
+
+    /* Function to read specific ObjectRect from its tags */
+    ObjectRect* readItem(const yml_item_struct &item, int ymltype = YMLType::Validator);
+
+    /* Function to mark an object loaded from invalid objects list */
+    void setInvalid(ObjectRect* object);
+
+    /* Function to load YML file in a single pass over memory mapped file (returns false if unsupported) */
+    bool streamYML(QString path, int ymltype, QList<ObjectRect*> &out_list, QString &source_image);
+
+    /* Function to load YML file using cv::FileStorage (fallback) */
+    bool storageYML(QString path, int ymltype, QList<ObjectRect*> &out_list, QString &source_image);
+
+    /* Function to read object tags from a cv::FileStorage node */
+    void readNode(const cv::FileNode &node, yml_item_struct &item);
 
-    /* Function to read specific ObjectRect from YML file */
-    ObjectRect* readItem(cv::FileNodeIterator iterator, int ymltype = YMLType::Validator);
+    /* Functions to parse YML values (return false if unsupported) */
+    static bool parseScalar(const char* begin, const char* end, QString &value);
+    static bool parseNumber(const char* begin, const char* end, double &value);
+    static bool parsePoint(const char* begin, const char* end, QPointF &value);
 };
 
 #endif // YMLREADER_H
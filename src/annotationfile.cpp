@@ -0,0 +1,382 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "annotationfile.h"
+#include <cstring>
+
+/* Binary annotation files extension */
+#define ANNOTATION_FILE_EXTENSION ".yfdb"
+
+/* Binary annotation files format version */
+#define ANNOTATION_FILE_VERSION 1
+
+/* Byte order marker */
+#define ANNOTATION_FILE_BYTE_ORDER 0x01020304
+
+/* Function to get the binary sidecar path of a YML file */
+QString AnnotationFile::sidecarPath(QString yml_path)
+{
+    /* Replace YML extension */
+    QFileInfo info( yml_path );
+    return QDir( info.path() ).filePath( info.completeBaseName() + ANNOTATION_FILE_EXTENSION );
+}
+
+/* Function to get the YML path of a binary sidecar */
+QString AnnotationFile::ymlPath(QString sidecar_path)
+{
+    /* Replace sidecar extension */
+    QFileInfo info( sidecar_path );
+    return QDir( info.path() ).filePath( info.completeBaseName() + ".yml" );
+}
+
+/* Function to determine if a YML file has an up to date binary sidecar */
+bool AnnotationFile::isCurrent(QString yml_path)
+{
+    /* Open sidecar */
+    QFile file( AnnotationFile::sidecarPath( yml_path ) );
+    if( !file.exists() || !file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    /* Read header */
+    annotation_header_struct header;
+    if( !AnnotationFile::readHeader( file, header ) )
+        return false;
+
+    /* Compare with mirrored YML (sidecar is outdated if YML was rewritten) */
+    QFileInfo info( yml_path );
+    return info.exists() &&
+           header.yml_size == info.size() &&
+           header.yml_modified == info.lastModified().toMSecsSinceEpoch();
+}
+
+/* Function to write objects atomically to a binary annotation file (yml_path is the mirrored YML, if any) */
+bool AnnotationFile::write(QList<ObjectRect*> objects, QString path, QString yml_path)
+{
+    /* Serialize and write objects */
+    return AnnotationFile::writeData( AnnotationFile::serialize( objects ), path, yml_path );
+}
+
+/* Function to serialize objects in memory (snapshot, not stamped) */
+QByteArray AnnotationFile::serialize(QList<ObjectRect*> objects)
+{
+    /* Source image path */
+    QByteArray source = objects.isEmpty() ? QByteArray() : objects.first()->getSourceImagePath().toUtf8();
+
+    /* Count childrens */
+    int childrens = 0;
+    foreach(ObjectRect* object, objects)
+        childrens += object->childrens.size();
+
+    /* Initialize header */
+    annotation_header_struct header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, "YFDB", 4 );
+    header.version = ANNOTATION_FILE_VERSION;
+    header.byte_order = ANNOTATION_FILE_BYTE_ORDER;
+    header.record_size = sizeof( annotation_record_struct );
+    header.objects = objects.size();
+    header.childrens = childrens;
+    header.source_size = source.size();
+    header.yml_size = -1;
+    header.yml_modified = -1;
+
+    /* Initialize output buffer */
+    int source_padded = ( source.size() + 7 ) & ~7;
+    QByteArray data;
+    data.reserve( sizeof( header ) + source_padded +
+                  ( objects.size() + childrens ) * sizeof( annotation_record_struct ) +
+                  objects.size() * sizeof( annotation_childrens_struct ) );
+
+    /* Write header and source image path */
+    data.append( (const char*)&header, sizeof( header ) );
+    data.append( source );
+    data.append( QByteArray( source_padded - source.size(), '\0' ) );
+
+    /* Write top level records */
+    annotation_record_struct record;
+    foreach(ObjectRect* object, objects)
+    {
+        AnnotationFile::writeRecord( object, record );
+        data.append( (const char*)&record, sizeof( record ) );
+    }
+
+    /* Write childrens records */
+    foreach(ObjectRect* object, objects)
+    {
+        foreach(ObjectRect* child, object->childrens)
+        {
+            AnnotationFile::writeRecord( child, record );
+            data.append( (const char*)&record, sizeof( record ) );
+        }
+    }
+
+    /* Write childrens table */
+    annotation_childrens_struct entry;
+    entry.first = 0;
+    foreach(ObjectRect* object, objects)
+    {
+        entry.count = object->childrens.size();
+        data.append( (const char*)&entry, sizeof( entry ) );
+        entry.first += entry.count;
+    }
+
+    /* Return serialized objects */
+    return data;
+}
+
+/* Function to parse serialized objects (returns false on invalid data) */
+bool AnnotationFile::parse(const uchar* data, qint64 size, annotation_view_struct &view)
+{
+    /* Check header size */
+    if( size < (qint64)sizeof( annotation_header_struct ) )
+        return false;
+
+    /* Read header */
+    memcpy( &view.header, data, sizeof( annotation_header_struct ) );
+
+    /* Check magic, version, byte order and records size */
+    if( !AnnotationFile::checkHeader( view.header ) )
+        return false;
+
+    /* Compute sections offsets */
+    qint64 source_offset = sizeof( annotation_header_struct );
+    qint64 records_offset = source_offset + ( ( (qint64)view.header.source_size + 7 ) & ~7 );
+    qint64 records = (qint64)view.header.objects + view.header.childrens;
+    qint64 table_offset = records_offset + records * sizeof( annotation_record_struct );
+
+    /* Check data size */
+    if( size < table_offset + (qint64)view.header.objects * sizeof( annotation_childrens_struct ) )
+        return false;
+
+    /* Sections (offsets are 8 bytes aligned) */
+    view.source_image = QString::fromUtf8( (const char*)data + source_offset, view.header.source_size );
+    view.records = (const annotation_record_struct*)( data + records_offset );
+    view.childrens = (const annotation_childrens_struct*)( data + table_offset );
+
+    /* Check childrens table */
+    for( quint32 i = 0; i < view.header.objects; i++ )
+    {
+        if( (qint64)view.childrens[i].first + view.childrens[i].count > view.header.childrens )
+            return false;
+    }
+
+    /* Return status */
+    return true;
+}
+
+/* Function to write serialized objects atomically to a binary annotation file (yml_path is the mirrored YML, if any) */
+bool AnnotationFile::writeData(QByteArray data, QString path, QString yml_path)
+{
+    /* Check data */
+    if( data.size() < (int)sizeof( annotation_header_struct ) )
+        return false;
+
+    /* Stamp mirrored YML */
+    annotation_header_struct* header = (annotation_header_struct*)data.data();
+    QFileInfo info( yml_path );
+    header->yml_size = -1;
+    header->yml_modified = -1;
+    if( !yml_path.isEmpty() && info.exists() )
+    {
+        header->yml_size = info.size();
+        header->yml_modified = info.lastModified().toMSecsSinceEpoch();
+    }
+
+    /* Write file atomically */
+    QSaveFile file( path );
+    if( !file.open( QIODevice::WriteOnly ) )
+        return false;
+    if( file.write( data ) != data.size() )
+        return false;
+    return file.commit();
+}
+
+/* Function to read objects from a binary annotation file (returns false on invalid file) */
+bool AnnotationFile::read(QString path, QList<ObjectRect*> &out_list)
+{
+    /* Trace zone */
+    TraceZone zone( "AnnotationFile::read" );
+
+    /* Open file */
+    QFile file( path );
+    if( !file.open( QIODevice::ReadOnly ) || file.size() <= 0 )
+        return false;
+
+    /* Map file in memory */
+    const uchar* data = file.map( 0, file.size() );
+    if( !data )
+        return false;
+
+    /* Parse file */
+    annotation_view_struct view;
+    if( !AnnotationFile::parse( data, file.size(), view ) )
+        return false;
+
+    /* Iterate over top level records */
+    for( quint32 i = 0; i < view.header.objects; i++ )
+    {
+        /* Create object */
+        ObjectRect* object = AnnotationFile::readRecord( view.records[i] );
+        object->setSourceImagePath( view.source_image );
+
+        /* Create childrens */
+        for( quint32 j = 0; j < view.childrens[i].count; j++ )
+            object->childrens.append( AnnotationFile::readRecord( view.records[view.header.objects + view.childrens[i].first + j] ) );
+
+        /* Append to list */
+        out_list.append( object );
+    }
+
+    /* Return status */
+    return true;
+}
+
+/* Function to read header of a binary annotation file (returns false on invalid header) */
+bool AnnotationFile::readHeader(QFile &file, annotation_header_struct &header)
+{
+    /* Read header */
+    if( file.read( (char*)&header, sizeof( header ) ) != sizeof( header ) )
+        return false;
+
+    /* Check header */
+    return AnnotationFile::checkHeader( header );
+}
+
+/* Function to check magic, version, byte order and records size of a header */
+bool AnnotationFile::checkHeader(const annotation_header_struct &header)
+{
+    return memcmp( header.magic, "YFDB", 4 ) == 0 &&
+           header.version == ANNOTATION_FILE_VERSION &&
+           header.byte_order == ANNOTATION_FILE_BYTE_ORDER &&
+           header.record_size == sizeof( annotation_record_struct );
+}
+
+/* Function to fill a record from an object */
+void AnnotationFile::writeRecord(ObjectRect* object, annotation_record_struct &record)
+{
+    /* Reset record */
+    memset( &record, 0, sizeof( record ) );
+
+    /* Projection points */
+    QPointF points[4] = { object->proj_point_1(), object->proj_point_2(), object->proj_point_3(), object->proj_point_4() };
+    for( int i = 0; i < 4; i++ )
+    {
+        record.points[i * 2] = points[i].x();
+        record.points[i * 2 + 1] = points[i].y();
+    }
+
+    /* Projection parameters */
+    record.params[0] = object->proj_azimuth();
+    record.params[1] = object->proj_elevation();
+    record.params[2] = object->proj_aperture();
+    record.params[3] = object->proj_width();
+    record.params[4] = object->proj_height();
+
+    /* Type, sub-type and statuses */
+    record.type = object->getObjectType();
+    record.sub_type = object->getObjectSubType();
+    record.automatic_status = object->getAutomaticStatus();
+    record.manual_status = object->getManualStatus();
+
+    /* Blur tag */
+    record.blurred = object->isBlurred() ? 1 : 0;
+}
+
+/* Function to create an object from a record (states are restored as for validator YMLs) */
+ObjectRect* AnnotationFile::readRecord(const annotation_record_struct &record)
+{
+    /* Initialize object */
+    ObjectRect* object = new ObjectRect;
+
+    /* Assign object type */
+    object->setObjectType( record.type );
+    object->setObjectSubType( record.sub_type );
+
+    /* Set object coordinates */
+    object->setPoints(QPointF(record.points[0], record.points[1]),
+                      QPointF(record.points[2], record.points[3]),
+                      QPointF(record.points[4], record.points[5]),
+                      QPointF(record.points[6], record.points[7]));
+
+    /* Set object projection parameters */
+    object->setProjectionParametters(record.params[0],
+                                    record.params[1],
+                                    record.params[2],
+                                    record.params[3],
+                                    record.params[4]);
+
+    /* Set object projection points */
+    object->setProjectionPoints();
+
+    /* Restore automatic state / status */
+    if( record.automatic_status == ObjectAutomaticStatus::None )
+    {
+        object->setObjectAutomaticState( ObjectAutomaticState::Manual );
+    } else if( record.automatic_status == ObjectAutomaticStatus::Valid ) {
+        object->setObjectAutomaticState( ObjectAutomaticState::Valid );
+        object->setAutomaticStatus( ObjectAutomaticStatus::Valid );
+    } else {
+        object->setObjectAutomaticState( ObjectAutomaticState::Invalid );
+        object->setAutomaticStatus( record.automatic_status );
+    }
+
+    /* Restore manual status */
+    object->setManualStatus( record.manual_status );
+
+    /* Restore manual state */
+    if( object->getObjectType() == ObjectType::ToBlur )
+    {
+        object->setObjectManualState( ObjectManualState::ToBlur );
+    } else if( object->getManualStatus() == ObjectManualStatus::None ) {
+        object->setObjectManualState( ObjectManualState::None );
+    } else if( object->getManualStatus() == ObjectManualStatus::Valid ) {
+        object->setObjectManualState( ObjectManualState::Valid );
+    } else {
+        object->setObjectManualState( ObjectManualState::Invalid );
+    }
+
+    /* Restore blur tag */
+    object->setBlurred( record.blurred != 0 );
+
+    /* Disable object resizing */
+    object->setResizeEnabled( false );
+
+    /* Return object */
+    return object;
+}
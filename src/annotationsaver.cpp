@@ -0,0 +1,218 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "annotationsaver.h"
+
+/* Constructor */
+AnnotationSaver::AnnotationSaver(QObject *parent) :
+    QThread(parent)
+{
+    /* Initialize state */
+    this->stopping = false;
+}
+
+/* Destructor (pending requests are completed) */
+AnnotationSaver::~AnnotationSaver()
+{
+    /* Complete pending requests */
+    this->finish();
+}
+
+/* Function to get the autosave snapshot path of a YML file */
+QString AnnotationSaver::autosavePath(QString yml_path)
+{
+    /* Snapshot is written next to the YML (not matching *.yml globs of batch scripts) */
+    return yml_path + ".autosave";
+}
+
+/* Function to queue a save of specified objects, superseding any pending request on the same path */
+void AnnotationSaver::save(QList<ObjectRect*> objects, QString path, bool sidecar)
+{
+    /* Snapshot objects (serialized in memory, objects are not accessed afterwards) */
+    this->save( AnnotationFile::serialize( objects ), path, sidecar );
+}
+
+/* Function to queue a save of an objects snapshot, superseding any pending request on the same path */
+void AnnotationSaver::save(QByteArray snapshot, QString path, bool sidecar)
+{
+    /* Initialize request */
+    annotation_save_request_struct request;
+    request.path = path;
+    request.snapshot = snapshot;
+    request.sidecar = sidecar;
+
+    /* Queue request */
+    this->enqueue( request );
+}
+
+/* Function to queue a removal, superseding any pending request on the same path */
+void AnnotationSaver::remove(QString path)
+{
+    /* Initialize request */
+    annotation_save_request_struct request;
+    request.path = path;
+    request.sidecar = false;
+
+    /* Queue request */
+    this->enqueue( request );
+}
+
+/* Function to complete pending requests and stop the save loop */
+void AnnotationSaver::finish()
+{
+    /* Request termination (pending requests are processed first) */
+    this->mutex.lock();
+    this->stopping = true;
+    this->condition.wakeAll();
+    this->mutex.unlock();
+
+    /* Wait for save loop */
+    this->wait();
+
+    /* Allow restart */
+    QMutexLocker locker(&this->mutex);
+    this->stopping = false;
+}
+
+/* Function to queue a request */
+void AnnotationSaver::enqueue(const annotation_save_request_struct &request)
+{
+    /* Drop superseded request on same path */
+    this->dropPending( request.path );
+
+    /* Lock requests */
+    QMutexLocker locker(&this->mutex);
+
+    /* Append request */
+    this->pending.append( request );
+
+    /* Start save loop if needed */
+    if( !this->isRunning() )
+        this->start( QThread::LowPriority );
+
+    /* Wake save loop */
+    this->condition.wakeAll();
+}
+
+/* Function to drop a pending request on specified path */
+void AnnotationSaver::dropPending(QString path)
+{
+    /* Lock requests */
+    QMutexLocker locker(&this->mutex);
+
+    /* Drop request (one per path) */
+    for (int i = 0; i < this->pending.size(); i++)
+    {
+        if( this->pending.at(i).path == path )
+        {
+            this->pending.removeAt( i );
+            break;
+        }
+    }
+}
+
+/* Function to wait for the next request, returns false on termination */
+bool AnnotationSaver::nextRequest(annotation_save_request_struct &request)
+{
+    /* Wait for a request */
+    QMutexLocker locker(&this->mutex);
+    while( this->pending.isEmpty() && !this->stopping )
+        this->condition.wait( &this->mutex );
+
+    /* Check termination (once all requests are processed) */
+    if( this->pending.isEmpty() )
+        return false;
+
+    /* Take request */
+    request = this->pending.takeFirst();
+
+    /* Return result */
+    return true;
+}
+
+/* Save loop */
+void AnnotationSaver::run()
+{
+    /* YML Parser */
+    YMLParser parser;
+
+    /* Request container */
+    annotation_save_request_struct request;
+
+    /* Process requests */
+    while( this->nextRequest( request ) )
+    {
+        /* Process request */
+        bool success = AnnotationSaver::process( request, parser );
+
+        /* Report completion */
+        emit saved( request.path, success );
+    }
+}
+
+/* Function to process a request, returns false on failure */
+bool AnnotationSaver::process(const annotation_save_request_struct &request, YMLParser &parser)
+{
+    /* Request status */
+    bool success = true;
+
+    /* Removal request */
+    if( request.snapshot.isEmpty() )
+    {
+        /* Remove destination if present */
+        if( QFile::exists( request.path ) )
+            success = QFile::remove( request.path );
+
+    } else {
+
+        /* Write YML atomically (temporary file, flushed to disk, renamed over destination) */
+        success = parser.writeSnapshot( request.snapshot, request.path );
+
+        /* Write binary sidecar mirroring written YML */
+        if( success && request.sidecar )
+            success = AnnotationFile::writeData( request.snapshot, AnnotationFile::sidecarPath( request.path ), request.path );
+    }
+
+    /* Info output */
+    if( !success )
+        std::cout << "[ERROR] Unable to save " << request.path.toStdString() << std::endl;
+
+    /* Return result */
+    return success;
+}
@@ -0,0 +1,298 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "batchexporter.h"
+
+/* Constructor */
+BatchExporter::BatchExporter(QString export_path, float zoom_level, int threads)
+{
+    /* Create objects exporter */
+    this->exporter = new Exporter( export_path, zoom_level, threads );
+
+    /* Decode one panorama ahead of the exported one */
+    this->queue_depth = 1;
+
+    /* Assign threads count */
+    this->threads_count = threads;
+}
+
+/* Destructor */
+BatchExporter::~BatchExporter()
+{
+    /* Wait for decoding thread */
+    this->wait();
+
+    /* Delete exporter (waits for pending exports) */
+    delete this->exporter;
+}
+
+/* Function to read pairs from a manifest file (one "image yml" pair per line) */
+QList<batch_export_pair_struct> BatchExporter::readManifest(QString path)
+{
+    /* Pairs container */
+    QList<batch_export_pair_struct> pairs;
+
+    /* Open manifest */
+    QFile file( path );
+    if( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+        /* Info output */
+        std::cout << "[ERROR] Unable to open manifest: " << path.toStdString() << std::endl;
+        return pairs;
+    }
+
+    /* Relative paths are relative to the manifest */
+    QDir base = QFileInfo( path ).absoluteDir();
+
+    /* Read manifest lines */
+    QTextStream stream( &file );
+    while( !stream.atEnd() )
+    {
+        /* Read line */
+        QString line = stream.readLine().trimmed();
+
+        /* Skip empty lines and comments */
+        if( line.isEmpty() || line.startsWith( "#" ) )
+            continue;
+
+        /* Split line fields */
+        QStringList fields = line.split( QRegExp( "\\s+" ), QString::SkipEmptyParts );
+
+        /* Check fields */
+        if( fields.size() != 2 )
+        {
+            /* Info output */
+            std::cout << "[WARNING] Invalid manifest line: " << line.toStdString() << std::endl;
+            continue;
+        }
+
+        /* Append pair */
+        batch_export_pair_struct pair;
+        pair.image_path = base.absoluteFilePath( fields.at(0) );
+        pair.yml_path = base.absoluteFilePath( fields.at(1) );
+        pairs.append( pair );
+    }
+
+    /* Return result */
+    return pairs;
+}
+
+/* Function to find pairs in a yafdb blurring directory (as scripts/yafdb-batch-validate does) */
+QList<batch_export_pair_struct> BatchExporter::scanDirectory(QString path)
+{
+    /* Pairs container */
+    QList<batch_export_pair_struct> pairs;
+
+    /* Blurring and results directories */
+    QDir blurring( path );
+    QDir results( blurring.absoluteFilePath( ".." ) );
+
+    /* Panoramas name pattern */
+    QRegExp pattern( "result_(\\d+_\\d+)-0-25-1\\.jpeg" );
+
+    /* Iterate over panoramas */
+    foreach(const QString &name, results.entryList( QStringList() << "result_*-0-25-1.jpeg", QDir::Files, QDir::Name ))
+    {
+        /* Extract timestamp */
+        if( !pattern.exactMatch( name ) )
+            continue;
+
+        /* Validated YML path */
+        QString yml = blurring.absoluteFilePath( "yml_configs/result_" + pattern.cap(1) + "_v2.yml" );
+
+        /* Only validated panoramas are exported */
+        if( !QFile::exists( yml ) )
+            continue;
+
+        /* Append pair */
+        batch_export_pair_struct pair;
+        pair.image_path = results.absoluteFilePath( name );
+        pair.yml_path = yml;
+        pairs.append( pair );
+    }
+
+    /* Return result */
+    return pairs;
+}
+
+/* Function to export all objects of specified pairs, returns number of failed pairs */
+int BatchExporter::exportPairs(QList<batch_export_pair_struct> pairs)
+{
+    /* Assign pairs */
+    this->pairs = pairs;
+
+    /* Counters */
+    int failed = 0;
+    qint64 pixels = 0;
+
+    /* Start timer */
+    QElapsedTimer timer;
+    timer.start();
+
+    /* Start decoding stage */
+    this->start();
+
+    /* Iterate over pairs */
+    for (int i = 0; i < this->pairs.size(); i++)
+    {
+        /* Wait for decoded panorama */
+        batch_decoded_struct item = this->nextDecoded();
+
+        /* Check decoding */
+        if( !item.image_info.image )
+        {
+            /* Info output */
+            std::cout << "[ERROR] Unable to read image: " << item.pair.image_path.toStdString() << std::endl;
+
+            /* Count failure */
+            failed++;
+
+        } else {
+
+            /* Info output */
+            std::cout << "[" << (i + 1) << "/" << this->pairs.size() << "] Exporting "
+                      << item.rects.size() << " objects of " << item.pair.image_path.toStdString() << std::endl;
+
+            /* Queue exports, image pixels are kept by the workers */
+            this->exporter->exportObjects( item.image_info, item.rects );
+            pixels += (qint64) item.image_info.width * item.image_info.height;
+
+            /* Release image */
+            delete item.image_info.image;
+        }
+
+        /* Release objects (workers use copies) */
+        qDeleteAll( item.rects );
+    }
+
+    /* Wait for decoding thread and pending exports */
+    this->wait();
+    this->exporter->wait();
+
+    /* Elapsed seconds */
+    double seconds = qMax( (qint64) 1, timer.elapsed() ) / 1000.0;
+
+    /* Throughput report */
+    std::cout << "Exported " << this->exporter->exported() << " objects from "
+              << ( this->pairs.size() - failed ) << " images in " << seconds << " s" << std::endl;
+    std::cout << "Throughput: " << ( ( this->pairs.size() - failed ) / seconds ) << " images/s, "
+              << ( this->exporter->exported() / seconds ) << " objects/s, "
+              << ( pixels / seconds / 1000000.0 ) << " Mpixels/s" << std::endl;
+
+    /* Info output */
+    if( this->exporter->failed() > 0 )
+    {
+        std::cout << this->exporter->failed() << " exports failed." << std::endl;
+    }
+
+    /* Return result */
+    return failed;
+}
+
+/* Function to get next decoded panorama (blocks until decoded) */
+batch_decoded_struct BatchExporter::nextDecoded()
+{
+    /* Lock queue */
+    QMutexLocker locker(&this->queue_mutex);
+
+    /* Wait for decoding thread */
+    while( this->decoded.isEmpty() )
+    {
+        this->queue_filled.wait( &this->queue_mutex );
+    }
+
+    /* Pop panorama */
+    batch_decoded_struct item = this->decoded.dequeue();
+
+    /* Wake decoding thread */
+    this->queue_drained.wakeAll();
+
+    /* Return result */
+    return item;
+}
+
+/* Decoding thread main function */
+void BatchExporter::run()
+{
+    /* YML Parser */
+    YMLParser yml_parser;
+
+    /* Iterate over pairs */
+    foreach(const batch_export_pair_struct &pair, this->pairs)
+    {
+        /* Decoded panorama */
+        batch_decoded_struct item;
+        item.pair = pair;
+        item.image_info.image = NULL;
+        item.image_info.cache = NULL;
+        item.image_info.width = 0;
+        item.image_info.height = 0;
+        item.image_info.channels = 0;
+
+        /* Load converted image, mapped from decode cache when enabled (restart markers strips are decoded in parallel) */
+        item.image_info.image = DecodeCache::load( pair.image_path, this->threads_count );
+
+        /* Check image */
+        if( item.image_info.image )
+        {
+            /* Save image details */
+            item.image_info.width = item.image_info.image->width();
+            item.image_info.height = item.image_info.image->height();
+            item.image_info.channels = (item.image_info.image->depth() / 8);
+
+            /* Load YML */
+            item.rects = yml_parser.loadYML( pair.yml_path, YMLType::Validator );
+        }
+
+        /* Lock queue */
+        QMutexLocker locker(&this->queue_mutex);
+
+        /* Wait for room in queue */
+        while( this->decoded.size() >= this->queue_depth )
+        {
+            this->queue_drained.wait( &this->queue_mutex );
+        }
+
+        /* Push panorama */
+        this->decoded.enqueue( item );
+
+        /* Wake export stage */
+        this->queue_filled.wakeAll();
+    }
+}
@@ -38,6 +38,7 @@
 
 #include "batchview.h"
 #include "ui_batchview.h"
+#include "editview.h"
 
 /* Constructor */
 BatchView::BatchView(QWidget *parent, PanoramaViewer* pano, int batchmode, int batchviewmode) :
@@ -53,23 +54,27 @@ BatchView::BatchView(QWidget *parent, PanoramaViewer* pano, int batchmode, int b
     /* Assign parent PanoramaViewer */
     this->pano = pano;
 
-    /* Initialize new FlowLayout to display tiles */
-    this->MainLayout = new FlowLayout();
-
-    /* Set proper window margins */
-    this->MainLayout->setContentsMargins( 10, 10, 10, 10 ) ;
-
-    /* Register layout */
-    QWidget * dummy = new QWidget;
-    dummy->setLayout(MainLayout);
-    this->ui->scrollArea->setWidget(dummy);
+    /* Configure objects grid */
+    this->ui->objectGrid->setCellSize( this->ui->horizontalSlider->value() );
+    connect(this->ui->objectGrid, SIGNAL(editRequested(int)), this, SLOT(editItem_slot(int)));
 
     /* Set window mode */
     this->setMode(batchmode);
 
-    /* Populate window */
+    /* Create thumbnails generator (from full resolution, preview is replaced first) */
+    this->pano->requireFullResolution();
+    this->thumbnails = new ThumbnailLoader(this->pano->image_info.cache, this);
+    connect(this->thumbnails, SIGNAL(thumbnailReady(int,QImage)), this, SLOT(thumbnailReady_slot(int,QImage)), Qt::QueuedConnection);
+
+    /* Prioritize visible thumbnails on scroll/resize */
+    connect(this->ui->objectGrid, SIGNAL(visibleItemsChanged()), this, SLOT(updateVisibleThumbnails()));
+
+    /* Populate window (tiles show placeholders until thumbnails arrive) */
     this->populate(batchviewmode);
 
+    /* Prioritize visible thumbnails once tiles are laid out */
+    QTimer::singleShot(0, this, SLOT(updateVisibleThumbnails()));
+
     /* Center window on screen */
     this->setGeometry(
         QStyle::alignedRect(
@@ -102,13 +107,12 @@ BatchView::BatchView(QWidget *parent, PanoramaViewer* pano, int batchmode, int b
 /* Destructor */
 BatchView::~BatchView()
 {
-    /* Iterate over allocated tiles */
-    foreach(ObjectItem* item, this->item_list)
-    {
-        /* Remove tile */
-        this->item_list.removeOne( item );
-        delete item;
-    }
+    /* Cancel pending thumbnails and wait for running ones */
+    delete this->thumbnails;
+
+    /* Delete tiles */
+    qDeleteAll( this->elements );
+    this->elements.clear();
 
     delete ui;
 }
@@ -116,6 +120,9 @@ BatchView::~BatchView()
 /* Function to draw tiles */
 void BatchView::populate(int batchviewmode)
 {
+    /* Trace zone */
+    TraceZone zone( "BatchView::populate" );
+
     /* Iterate over tiles */
     foreach(ObjectRect* rect, pano->rect_list )
     {
@@ -145,7 +152,7 @@ void BatchView::populate(int batchviewmode)
 
             /* Check if rect is a valid face */
             if(rect->getObjectType() == ObjectType::Face &&
-                    (rect->getAutomaticStatus() == "Valid" || rect->getAutomaticStatus() == "None"))
+                    (rect->getAutomaticStatus() == ObjectAutomaticStatus::Valid || rect->getAutomaticStatus() == ObjectAutomaticStatus::None))
             {
                 /* Insert tile */
                 this->insertItem(rect);
@@ -157,8 +164,8 @@ void BatchView::populate(int batchviewmode)
 
             /* Check if rect is unnaproved */
             if(rect->getObjectType() == ObjectType::Face
-                    && rect->getManualStatus() == "None"
-                    && rect->getAutomaticStatus() == "Valid")
+                    && rect->getManualStatus() == ObjectManualStatus::None
+                    && rect->getAutomaticStatus() == ObjectAutomaticStatus::Valid)
             {
                 /* Insert tile */
                 this->insertItem(rect);
@@ -181,8 +188,8 @@ void BatchView::populate(int batchviewmode)
 
             /* Check if rect is an unnaproved numberplate */
             if(rect->getObjectType() == ObjectType::NumberPlate
-                    && rect->getManualStatus() == "None"
-                    && rect->getAutomaticStatus() == "Valid")
+                    && rect->getManualStatus() == ObjectManualStatus::None
+                    && rect->getAutomaticStatus() == ObjectAutomaticStatus::Valid)
             {
                 /* Insert tile */
                 this->insertItem(rect);
@@ -194,8 +201,8 @@ void BatchView::populate(int batchviewmode)
 
             /* Check if rect is pre-invalidated */
             if(rect->getObjectType() != ObjectType::None
-                    && rect->getAutomaticStatus() != "Valid"
-                    && rect->getAutomaticStatus() != "None")
+                    && rect->getAutomaticStatus() != ObjectAutomaticStatus::Valid
+                    && rect->getAutomaticStatus() != ObjectAutomaticStatus::None)
             {
                 /* Insert tile */
                 this->insertItem(rect);
@@ -222,17 +229,35 @@ void BatchView::insertItem(ObjectRect *rect)
 {
 
     /* Cheate a new tile */
-    ObjectItem* object = new ObjectItem(0, this->pano, rect);
+    ObjectItem* object = new ObjectItem(rect);
 
-    /* Adjust tile size */
-    object->setSize( QSize(this->ui->horizontalSlider->value(), this->ui->horizontalSlider->value()) );
+    /* Get object selection in its crop view */
+    QRect selection = this->pano->cropSelection( rect );
 
-    /* Append to list */
-    this->item_list.append( object );
+    /* Show placeholder with object aspect until thumbnail arrives */
+    object->setPlaceholder( selection.size() );
 
     /* Insert tile */
-    this->MainLayout->addWidget(object);
-    this->elements.append(object);
+    this->elements.append( object );
+    this->ui->objectGrid->appendItem( object );
+    this->item_jobs.append( -1 );
+
+    /* Queue thumbnail generation */
+    if( this->pano->image_info.cache != NULL && !selection.isEmpty() )
+    {
+        /* Setup job */
+        thumbnail_job_struct job;
+        job.view_width = this->pano->width();
+        job.view_height = this->pano->height();
+        job.window = selection;
+        job.azimuth = rect->proj_azimuth();
+        job.elevation = rect->proj_elevation();
+        job.aperture = rect->proj_aperture();
+
+        /* Register job */
+        this->item_jobs.last() = this->thumbnails->append( job );
+        this->job_items.append( this->elements.size() - 1 );
+    }
 }
 
 /* Function to set the window mode (manual objects, auto objects, etc) */
@@ -318,45 +343,63 @@ void BatchView::mergeResults()
 /* (UI action) select all tiles */
 void BatchView::selectAll()
 {
-    /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
-    {
-        /* Set tile selected */
-        item->setSelected(true);
-    }
+    /* Set all tiles selected */
+    this->ui->objectGrid->selectAll();
 }
 
 /* (UI action) unselect all tiles */
 void BatchView::unSelectAll()
 {
-    /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
-    {
-        /* Set tile unselected */
-        item->setSelected(false);
-    }
+    /* Set all tiles unselected */
+    this->ui->objectGrid->unSelectAll();
 }
 
 /* (UI action) invert all tiles selection */
 void BatchView::invertSelection()
 {
-    /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
-    {
-        /* Invert tile selection */
-        item->setSelected( !item->isSelected() );
-    }
+    /* Invert tiles selection */
+    this->ui->objectGrid->invertSelection();
 }
 
 /* (UI signal) slider moved signal */
 void BatchView::on_horizontalSlider_sliderMoved(int position)
 {
-    /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    /* Update tiles size */
+    this->ui->objectGrid->setCellSize(position);
+}
+
+/* Slot for generated thumbnails */
+void BatchView::thumbnailReady_slot(int index, QImage image)
+{
+    /* Display thumbnail on its tile */
+    this->elements.at( this->job_items.at(index) )->setImage( image );
+}
+
+/* Slot to prioritize thumbnails of visible tiles */
+void BatchView::updateVisibleThumbnails()
+{
+    /* Collect jobs of visible tiles */
+    QList<int> indexes;
+    foreach(int index, this->ui->objectGrid->visibleItems())
     {
-        /* Update tile size */
-        item->setSize(QSize(position, position));
+        if( this->item_jobs.at(index) >= 0 )
+            indexes.append( this->item_jobs.at(index) );
     }
+
+    /* Move them ahead of the queue */
+    this->thumbnails->prioritize( indexes );
+}
+
+/* Slot to open a tile in an edition window */
+void BatchView::editItem_slot(int index)
+{
+    /* Get item */
+    ObjectItem* item = this->elements.at(index);
+
+    /* Create and show a new edition window */
+    EditView* w = new EditView(this->pano, item->getParentRect(), this->pano->image_info, item, EditMode::Single);
+    w->setAttribute( Qt::WA_DeleteOnClose );
+    w->show();
 }
 
 /* (UI signal) Close button clicked signal */
@@ -370,10 +413,13 @@ void BatchView::on_CancelButton_clicked()
 void BatchView::on_BlurButton_clicked()
 {
     /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    for (int i = 0; i < this->elements.size(); i++)
     {
+        /* Get item */
+        ObjectItem* item = this->elements.at(i);
+
         /* Check if item is selected */
-        if(item->isSelected())
+        if(this->ui->objectGrid->isSelected(i))
         {
             /* Mark object as blurred */
             item->setBlurred(true);
@@ -385,10 +431,13 @@ void BatchView::on_BlurButton_clicked()
 void BatchView::on_NoBlurButton_clicked()
 {
     /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    for (int i = 0; i < this->elements.size(); i++)
     {
+        /* Get item */
+        ObjectItem* item = this->elements.at(i);
+
         /* Check if item is selected */
-        if(item->isSelected())
+        if(this->ui->objectGrid->isSelected(i))
         {
             /* Mark object as unblurred */
             item->setBlurred(false);
@@ -400,10 +449,13 @@ void BatchView::on_NoBlurButton_clicked()
 void BatchView::on_deleteButton_clicked()
 {
     /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    for (int i = 0; i < this->elements.size(); i++)
     {
+        /* Get item */
+        ObjectItem* item = this->elements.at(i);
+
         /* Check if item is selected */
-        if(item->isSelected())
+        if(this->ui->objectGrid->isSelected(i))
         {
             /* Remove object */
             item->remove( true );
@@ -415,14 +467,17 @@ void BatchView::on_deleteButton_clicked()
 void BatchView::on_ValidateButton_clicked()
 {
     /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    for (int i = 0; i < this->elements.size(); i++)
     {
+        /* Get item */
+        ObjectItem* item = this->elements.at(i);
+
         /* Check if item is selected */
-        if(item->isSelected())
+        if(this->ui->objectGrid->isSelected(i))
         {
             /* Mark object as valid */
             item->setItemManualState( ObjectManualState::Valid );
-            item->setManualStatus("Valid");
+            item->setManualStatus(ObjectManualStatus::Valid);
         }
     }
 }
@@ -431,14 +486,17 @@ void BatchView::on_ValidateButton_clicked()
 void BatchView::on_InvalidateButton_clicked()
 {
     /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    for (int i = 0; i < this->elements.size(); i++)
     {
+        /* Get item */
+        ObjectItem* item = this->elements.at(i);
+
         /* Check if item is selected */
-        if(item->isSelected())
+        if(this->ui->objectGrid->isSelected(i))
         {
             /* Mark object as invalid */
             item->setItemManualState( ObjectManualState::Invalid );
-            item->setManualStatus("Invalid");
+            item->setManualStatus(ObjectManualStatus::Invalid);
         }
     }
 }
@@ -447,10 +505,13 @@ void BatchView::on_InvalidateButton_clicked()
 void BatchView::on_setType_clicked()
 {
     /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    for (int i = 0; i < this->elements.size(); i++)
     {
+        /* Get item */
+        ObjectItem* item = this->elements.at(i);
+
         /* Check if item is selected */
-        if(item->isSelected())
+        if(this->ui->objectGrid->isSelected(i))
         {
             /* Update type */
             item->setItemType( this->ui->TypeList->currentIndex() );
@@ -462,10 +523,13 @@ void BatchView::on_setType_clicked()
 void BatchView::on_setSubType_clicked()
 {
     /* Iterate over objects */
-    foreach(ObjectItem* item, this->elements )
+    for (int i = 0; i < this->elements.size(); i++)
     {
+        /* Get item */
+        ObjectItem* item = this->elements.at(i);
+
         /* Check if item is selected */
-        if(item->isSelected())
+        if(this->ui->objectGrid->isSelected(i))
         {
             /* Update sub type */
             item->setItemSubType( this->ui->SubTypeList->currentIndex() );
@@ -514,7 +578,7 @@ void BatchView::on_ApplyButton_clicked()
     foreach(ObjectItem* item, this->elements)
     {
         /* Check if object is unnaproved */
-        if(item->getManualStatus() == "None")
+        if(item->getManualStatus() == ObjectManualStatus::None)
         {
             /* Assign flag */
             haveNoManualState = true;
@@ -662,12 +726,8 @@ void BatchView::wheelEvent(QWheelEvent * event)
         /* Update slider value */
         this->ui->horizontalSlider->setValue( newvalue );
 
-        /* Iterate over objects */
-        foreach(ObjectItem* item, this->elements )
-        {
-            /* Update tile size */
-            item->setSize(QSize(newvalue, newvalue));
-        }
+        /* Update tiles size */
+        this->ui->objectGrid->setCellSize(newvalue);
     }
 }
 
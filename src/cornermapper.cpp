@@ -0,0 +1,258 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "cornermapper.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Maximum number of cached rotations */
+#define CORNER_ROTATIONS_MAX 8192
+
+/* Constructor */
+CornerMapper::CornerMapper()
+{
+}
+
+/* Function to get (cached) rotation matrices of a gnomonic center */
+const corner_rotation_struct &CornerMapper::rotation(float azimuth, float elevation)
+{
+    /* Pack angles bits into key */
+    quint32 az_bits, el_bits;
+    memcpy( &az_bits, &azimuth, sizeof( az_bits ) );
+    memcpy( &el_bits, &elevation, sizeof( el_bits ) );
+    quint64 key = ( (quint64) az_bits << 32 ) | el_bits;
+
+    /* Search cache */
+    QHash<quint64, corner_rotation_struct>::const_iterator it = this->rotations.constFind( key );
+    if( it != this->rotations.constEnd() )
+        return it.value();
+
+    /* Bound cache size */
+    if( this->rotations.size() >= CORNER_ROTATIONS_MAX )
+        this->rotations.clear();
+
+    /* Create rotation matrices */
+    corner_rotation_struct r;
+    lg_algebra_r2erotation( r.r2e, azimuth, elevation, 0 );
+    lg_algebra_e2rrotation( r.e2r, azimuth, elevation, 0 );
+
+    /* Insert into cache */
+    return this->rotations.insert( key, r ).value();
+}
+
+/* Function to map all objects corners to a view, objects points are updated if requested */
+void CornerMapper::map(const QList<ObjectRect*> &rects,
+                       float width,
+                       float height,
+                       float azimuth,
+                       float elevation,
+                       float aperture,
+                       bool update_points)
+{
+    /* Objects count */
+    int count = rects.size();
+
+    /* Resize buffers (no reallocation while count does not grow) */
+    this->r_x.resize( count * 4 );
+    this->r_y.resize( count * 4 );
+    this->c_x.resize( count * 4 );
+    this->c_y.resize( count * 4 );
+    this->matrices.resize( count * 9 );
+    this->r_cx.resize( count );
+    this->r_cy.resize( count );
+    this->r_pixel.resize( count );
+    this->visible.resize( count );
+
+    /* View rotation and pixel size */
+    const corner_rotation_struct &view = this->rotation( azimuth, elevation );
+    double e2r[3][3];
+    memcpy( e2r, view.e2r, sizeof( e2r ) );
+    double c_pixel = 2.0 * tan( aperture / 2.0 ) / width;
+
+    /* Fill objects buffers */
+    for (int i = 0; i < count; i++)
+    {
+        /* Get object */
+        ObjectRect* rect = rects.at(i);
+
+        /* Object corners */
+        this->r_x[i * 4 + 0] = rect->proj_point_1().x();
+        this->r_x[i * 4 + 1] = rect->proj_point_2().x();
+        this->r_x[i * 4 + 2] = rect->proj_point_3().x();
+        this->r_x[i * 4 + 3] = rect->proj_point_4().x();
+        this->r_y[i * 4 + 0] = rect->proj_point_1().y();
+        this->r_y[i * 4 + 1] = rect->proj_point_2().y();
+        this->r_y[i * 4 + 2] = rect->proj_point_3().y();
+        this->r_y[i * 4 + 3] = rect->proj_point_4().y();
+
+        /* Object projection center and pixel size */
+        this->r_cx[i] = rect->proj_width() / 2.0;
+        this->r_cy[i] = rect->proj_height() / 2.0;
+        this->r_pixel[i] = 2.0 * tan( rect->proj_aperture() / 2.0 ) / rect->proj_width();
+
+        /* Object to view matrix */
+        const corner_rotation_struct &source = this->rotation( rect->proj_azimuth(), rect->proj_elevation() );
+        double* m = this->matrices.data() + i * 9;
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                m[r * 3 + c] = e2r[r][0] * source.r2e[0][c] + e2r[r][1] * source.r2e[1][c] + e2r[r][2] * source.r2e[2][c];
+            }
+        }
+    }
+
+    /* Buffers pointers */
+    const double* rx = this->r_x.constData();
+    const double* ry = this->r_y.constData();
+    double* cx = this->c_x.data();
+    double* cy = this->c_y.data();
+    char* vis = this->visible.data();
+
+    /* View center */
+    double c_cx = width / 2.0;
+    double c_cy = height / 2.0;
+
+    /* Map corners of all objects */
+    for (int i = 0; i < count; i++)
+    {
+        /* Object matrix and projection */
+        const double* m = this->matrices.constData() + i * 9;
+        double rp = this->r_pixel[i];
+        double ox = this->r_cx[i];
+        double oy = this->r_cy[i];
+
+        /* First corner */
+        int k = i * 4;
+
+#if defined(__SSE2__)
+
+        /* Broadcast object constants */
+        const __m128d m0 = _mm_set1_pd( m[0] ), m1 = _mm_set1_pd( m[1] ), m2 = _mm_set1_pd( m[2] );
+        const __m128d m3 = _mm_set1_pd( m[3] ), m4 = _mm_set1_pd( m[4] ), m5 = _mm_set1_pd( m[5] );
+        const __m128d m6 = _mm_set1_pd( m[6] ), m7 = _mm_set1_pd( m[7] ), m8 = _mm_set1_pd( m[8] );
+        const __m128d vrp = _mm_set1_pd( rp ), vox = _mm_set1_pd( ox ), voy = _mm_set1_pd( oy );
+        const __m128d vcp = _mm_set1_pd( 1.0 / c_pixel ), vcx = _mm_set1_pd( c_cx ), vcy = _mm_set1_pd( c_cy );
+
+        /* Visible corners mask */
+        int mask = 3;
+
+        /* Map two corners at once */
+        for (int j = 0; j < 4; j += 2)
+        {
+            /* Position in object rectilinear frame */
+            __m128d u = _mm_mul_pd( _mm_sub_pd( _mm_loadu_pd( rx + k + j ), vox ), vrp );
+            __m128d v = _mm_mul_pd( _mm_sub_pd( _mm_loadu_pd( ry + k + j ), voy ), vrp );
+
+            /* Apply rotation on position */
+            __m128d q0 = _mm_add_pd( m0, _mm_add_pd( _mm_mul_pd( m1, u ), _mm_mul_pd( m2, v ) ) );
+            __m128d q1 = _mm_add_pd( m3, _mm_add_pd( _mm_mul_pd( m4, u ), _mm_mul_pd( m5, v ) ) );
+            __m128d q2 = _mm_add_pd( m6, _mm_add_pd( _mm_mul_pd( m7, u ), _mm_mul_pd( m8, v ) ) );
+
+            /* Compute coordinates in view */
+            __m128d s = _mm_div_pd( vcp, q0 );
+            _mm_storeu_pd( cx + k + j, _mm_add_pd( _mm_mul_pd( q1, s ), vcx ) );
+            _mm_storeu_pd( cy + k + j, _mm_add_pd( _mm_mul_pd( q2, s ), vcy ) );
+
+            /* Compute first order visibility condition */
+            mask &= _mm_movemask_pd( _mm_cmpgt_pd( q0, _mm_setzero_pd() ) );
+        }
+
+        /* Object is visible if its 4 corners are */
+        vis[i] = ( mask == 3 );
+
+#else
+
+        /* Visible corners flag */
+        bool all = true;
+
+        /* Iterate over corners */
+        for (int j = 0; j < 4; j++)
+        {
+            /* Position in object rectilinear frame */
+            double u = ( rx[k + j] - ox ) * rp;
+            double v = ( ry[k + j] - oy ) * rp;
+
+            /* Apply rotation on position */
+            double q0 = m[0] + m[1] * u + m[2] * v;
+            double q1 = m[3] + m[4] * u + m[5] * v;
+            double q2 = m[6] + m[7] * u + m[8] * v;
+
+            /* Compute coordinates in view */
+            cx[k + j] = ( ( q1 / q0 ) / c_pixel ) + c_cx;
+            cy[k + j] = ( ( q2 / q0 ) / c_pixel ) + c_cy;
+
+            /* Compute first order visibility condition */
+            all = all && ( q0 > 0 );
+        }
+
+        /* Object is visible if its 4 corners are */
+        vis[i] = all;
+
+#endif
+    }
+
+    /* Check if points have to be updated */
+    if( !update_points )
+        return;
+
+    /* Update objects points */
+    for (int i = 0; i < count; i++)
+    {
+        /* First corner */
+        int k = i * 4;
+
+        /* Set object points */
+        rects.at(i)->setPoints( QPointF( cx[k + 0], cy[k + 0] ),
+                                QPointF( cx[k + 1], cy[k + 1] ),
+                                QPointF( cx[k + 2], cy[k + 2] ),
+                                QPointF( cx[k + 3], cy[k + 3] ) );
+    }
+}
+
+/* Function to know if the 4 corners of an object were visible in the last mapped view */
+bool CornerMapper::isVisible(int index)
+{
+    /* Return result */
+    return ( index >= 0 && index < this->visible.size() && this->visible.at( index ) );
+}
@@ -0,0 +1,400 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "decodecache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Cache settings */
+QString DecodeCache::directory;
+qint64 DecodeCache::limit = 0;
+
+/* Mapped cache entry (released with the image) */
+struct decode_cache_mapping_struct{
+    void* address;
+    size_t size;
+};
+
+/* Function to unmap a cache entry wrapped by a QImage */
+static void releaseMappedEntry(void *info)
+{
+    /* Unmap entry */
+    decode_cache_mapping_struct* mapping = (decode_cache_mapping_struct*) info;
+    munmap( mapping->address, mapping->size );
+    delete mapping;
+}
+
+/* Function to enable the cache in specified directory, entries are evicted above size limit (in bytes) */
+void DecodeCache::setup(QString directory, qint64 limit)
+{
+    /* Create directory */
+    if( !QDir().mkpath( directory ) )
+    {
+        std::cout << "[ERROR] Unable to create decode cache directory: " << directory.toStdString() << std::endl;
+        return;
+    }
+
+    /* Assign settings */
+    DecodeCache::directory = QDir( directory ).absolutePath();
+    DecodeCache::limit = limit;
+}
+
+/* Function to check if the cache is enabled */
+bool DecodeCache::enabled()
+{
+    /* Return result */
+    return !DecodeCache::directory.isEmpty();
+}
+
+/* Function to load a decoded image, memory mapped from the cache when present, decoded and stored otherwise (NULL on failure) */
+QImage* DecodeCache::load(QString path, int threads, int* channels)
+{
+    /* Trace zone */
+    TraceZone zone( "DecodeCache::load" );
+
+    /* Cache entry path (empty if disabled or image is unreadable) */
+    QString entry = DecodeCache::enabled() ? DecodeCache::entryPath( path ) : QString();
+
+    /* Load image */
+    return DecodeCache::loadEntry( path, entry, threads, channels );
+}
+
+/* Function to load the pyramid levels of an image, each level mapped from the cache when present, built and stored otherwise */
+QList<QImage> DecodeCache::loadPyramid(QString path, int threads, int* channels)
+{
+    /* Trace zone */
+    TraceZone zone( "DecodeCache::loadPyramid" );
+
+    /* Levels list */
+    QList<QImage> levels;
+
+    /* Cache entry path (empty if disabled or image is unreadable) */
+    QString entry = DecodeCache::enabled() ? DecodeCache::entryPath( path ) : QString();
+
+    /* Load full resolution level */
+    int source_channels = 0;
+    QImage* full = DecodeCache::loadEntry( path, entry, threads, &source_channels );
+    if( full == NULL )
+        return levels;
+
+    /* Save source channels */
+    if( channels != NULL )
+        *channels = source_channels;
+
+    /* Keep full resolution level (pixels or mapping are shared with the list) */
+    levels.append( *full );
+    delete full;
+
+    /* Build levels if cache is bypassed */
+    if( entry.isEmpty() )
+        return PanoramaCache::pyramid( levels.first() );
+
+    /* Map coarser levels (full resolution pages are not touched) */
+    int depth = PanoramaCache::depth( levels.first().width() );
+    for (int level = 1; level < depth; level++)
+    {
+        /* Map level */
+        QImage* image = DecodeCache::map( DecodeCache::levelPath( entry, level ), NULL );
+        if( image == NULL )
+            break;
+
+        /* Check level dimensions (halved previous level) */
+        bool valid = image->width() == (levels.last().width() + 1) / 2 && image->height() == (levels.last().height() + 1) / 2;
+        if( valid )
+            levels.append( *image );
+        delete image;
+
+        /* Stop on invalid level */
+        if( !valid )
+            break;
+    }
+
+    /* Return mapped pyramid if complete */
+    if( levels.size() == depth )
+        return levels;
+
+    /* Build coarser levels from full resolution level */
+    levels = PanoramaCache::pyramid( levels.first() );
+
+    /* Store coarser levels, then evict least recently used entries */
+    bool stored = true;
+    for (int level = 1; stored && level < levels.size(); level++)
+        stored = DecodeCache::store( DecodeCache::levelPath( entry, level ), &levels.at( level ), source_channels, threads );
+
+    if( stored )
+        DecodeCache::evict( entry );
+    else
+        std::cout << "[WARNING] Unable to store image pyramid in cache: " << path.toStdString() << std::endl;
+
+    /* Return result */
+    return levels;
+}
+
+/* Function to load a decoded image from specified entry (cache is bypassed if entry is empty) */
+QImage* DecodeCache::loadEntry(QString path, QString entry, int threads, int* channels)
+{
+    /* Map cached image */
+    if( !entry.isEmpty() )
+    {
+        QImage* image = DecodeCache::map( entry, channels );
+        if( image != NULL )
+            return image;
+    }
+
+    /* Decode image */
+    IplImage* temp_image = JpegDecoder::load( path, threads );
+    if( temp_image == NULL )
+        return NULL;
+
+    /* Save source channels */
+    int source_channels = temp_image->nChannels;
+    if( channels != NULL )
+        *channels = source_channels;
+
+    /* Convert image, temporary image is released or wrapped by the result */
+    QImage* image = IplImage2QImageAdopt( temp_image, threads );
+
+    /* Store converted image, then evict least recently used entries */
+    if( !entry.isEmpty() )
+    {
+        if( DecodeCache::store( entry, image, source_channels, threads ) )
+            DecodeCache::evict( entry );
+        else
+            std::cout << "[WARNING] Unable to store decoded image in cache: " << path.toStdString() << std::endl;
+    }
+
+    /* Return image */
+    return image;
+}
+
+/* Function to get the cache entry path of an image (content hash and modification time) */
+QString DecodeCache::entryPath(QString path)
+{
+    /* Trace zone */
+    TraceZone zone( "DecodeCache::entryPath" );
+
+    /* Map image file */
+    QFile file( path );
+    if( !file.open( QIODevice::ReadOnly ) || file.size() <= 0 )
+        return QString();
+
+    const uchar* data = file.map( 0, file.size() );
+    if( data == NULL )
+        return QString();
+
+    /* Hash content (by chunks, sizes are int) */
+    QCryptographicHash hash( QCryptographicHash::Md5 );
+    for (qint64 offset = 0; offset < file.size(); offset += (1 << 26))
+        hash.addData( (const char*) data + offset, (int) qMin( (qint64) (1 << 26), file.size() - offset ) );
+
+    /* Entry name from hash and modification time */
+    QString name = QString("%1-%2.raw").arg( QString( hash.result().toHex() ) ).arg( QFileInfo( path ).lastModified().toMSecsSinceEpoch() );
+
+    /* Return entry path */
+    return QDir( DecodeCache::directory ).filePath( name );
+}
+
+/* Function to get the cache entry path of a pyramid level */
+QString DecodeCache::levelPath(QString entry, int level)
+{
+    /* Level entries share the full resolution entry name */
+    QString base = entry;
+    base.chop( 4 );
+
+    /* Return level entry path */
+    return QString("%1-L%2.raw").arg( base ).arg( level );
+}
+
+/* Function to map a cache entry as a read-only image (NULL if missing or invalid) */
+QImage* DecodeCache::map(QString entry, int* channels)
+{
+    /* Open entry */
+    int descriptor = open( QFile::encodeName( entry ).constData(), O_RDONLY );
+    if( descriptor < 0 )
+        return NULL;
+
+    /* Map whole entry (pages are read on first access) */
+    struct stat status;
+    void* address = MAP_FAILED;
+    if( fstat( descriptor, &status ) == 0 && status.st_size >= (off_t) sizeof( decode_cache_header_struct ) )
+        address = mmap( NULL, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0 );
+
+    /* Mapping keeps entry open */
+    close( descriptor );
+    if( address == MAP_FAILED )
+        return NULL;
+
+    /* Check header */
+    decode_cache_header_struct header;
+    memcpy( &header, address, sizeof( header ) );
+    if( memcmp( header.magic, "YFDC", 4 ) != 0 ||
+        header.version != DECODE_CACHE_VERSION ||
+        ( header.format != QImage::Format_RGB32 && header.format != QImage::Format_ARGB32 ) ||
+        header.width <= 0 || header.height <= 0 || header.bytes_per_line < header.width * 4 ||
+        header.data_offset + (qint64) header.bytes_per_line * header.height > (qint64) status.st_size )
+    {
+        /* Remove invalid entry */
+        munmap( address, status.st_size );
+        QFile::remove( entry );
+        return NULL;
+    }
+
+    /* Mark entry as recently used */
+    utime( QFile::encodeName( entry ).constData(), NULL );
+
+    /* Save source channels */
+    if( channels != NULL )
+        *channels = header.channels;
+
+    /* Wrap mapped pixels without copy, unmapped with the image */
+    decode_cache_mapping_struct* mapping = new decode_cache_mapping_struct;
+    mapping->address = address;
+    mapping->size = status.st_size;
+    return new QImage( (const uchar*) address + header.data_offset,
+                       header.width,
+                       header.height,
+                       header.bytes_per_line,
+                       (QImage::Format) header.format,
+                       releaseMappedEntry,
+                       mapping );
+}
+
+/* Function to store a decoded image as a cache entry (atomically) */
+bool DecodeCache::store(QString entry, const QImage* image, int channels, int threads)
+{
+    /* Trace zone */
+    TraceZone zone( "DecodeCache::store" );
+
+    /* Only 32 bits images are mapped back */
+    if( image->format() != QImage::Format_RGB32 && image->format() != QImage::Format_ARGB32 )
+        return false;
+
+    /* Create temporary entry next to destination */
+    QTemporaryFile file( QDir( DecodeCache::directory ).filePath( "XXXXXX.part" ) );
+    if( !file.open() )
+        return false;
+
+    /* Initialize header (rows aligned on cache lines) */
+    decode_cache_header_struct header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, "YFDC", 4 );
+    header.version = DECODE_CACHE_VERSION;
+    header.width = image->width();
+    header.height = image->height();
+    header.channels = channels;
+    header.format = image->format();
+    header.bytes_per_line = ( ( image->width() * 4 + 63 ) / 64 ) * 64;
+    header.data_offset = 4096;
+
+    /* Write header page */
+    QByteArray page( (int) header.data_offset, 0 );
+    memcpy( page.data(), &header, sizeof( header ) );
+    bool success = file.write( page ) == page.size();
+
+    /* Write rows by blocks (padding stays zeroed) */
+    int block_rows = qMax( 1, ( 1 << 24 ) / header.bytes_per_line );
+    QByteArray block( block_rows * header.bytes_per_line, 0 );
+    for (int y = 0; success && y < header.height; y += block_rows)
+    {
+        /* Copy rows */
+        int rows = qMin( block_rows, header.height - y );
+        #pragma omp parallel for num_threads( threads ) schedule( static )
+        for (int i = 0; i < rows; i++)
+            memcpy( block.data() + (qint64) i * header.bytes_per_line, image->constScanLine( y + i ), header.width * 4 );
+
+        /* Write rows */
+        success = file.write( block.constData(), (qint64) rows * header.bytes_per_line ) == (qint64) rows * header.bytes_per_line;
+    }
+
+    /* Complete entry, pixels reach the disk before entry is renamed (a crash cannot leave a valid header over zeroed pixels) */
+    success = success && file.flush() && fsync( file.handle() ) == 0;
+    if( !success )
+        return false;
+
+    /* Replace destination (concurrent stores of same entry are identical) */
+    if( rename( QFile::encodeName( file.fileName() ).constData(), QFile::encodeName( entry ).constData() ) != 0 )
+        return false;
+
+    /* Keep renamed entry */
+    file.setAutoRemove( false );
+
+    /* Return result */
+    return true;
+}
+
+/* Function to remove least recently used entries above size limit */
+void DecodeCache::evict(QString keep)
+{
+    /* Remove temporary files left by interrupted stores (recent ones may still be written) */
+    QDateTime expired = QDateTime::currentDateTime().addSecs( -DECODE_CACHE_PART_AGE );
+    foreach(const QFileInfo &info, QDir( DecodeCache::directory ).entryInfoList( QStringList() << "*.part", QDir::Files ))
+    {
+        if( info.lastModified() < expired )
+            QFile::remove( info.absoluteFilePath() );
+    }
+
+    /* Kept entry levels prefix */
+    QString keep_levels = keep;
+    keep_levels.chop( 4 );
+    keep_levels += "-L";
+
+    /* Entries, most recently used first */
+    QFileInfoList entries = QDir( DecodeCache::directory ).entryInfoList( QStringList() << "*.raw", QDir::Files, QDir::Time );
+
+    /* Keep most recently used entries until limit is reached */
+    qint64 total = 0;
+    foreach(const QFileInfo &info, entries)
+    {
+        /* Kept entry and its levels are never removed */
+        total += info.size();
+        QString path = info.absoluteFilePath();
+        if( path == keep || path.startsWith( keep_levels ) )
+            continue;
+
+        /* Remove least recently used entry */
+        if( total > DecodeCache::limit )
+            QFile::remove( path );
+    }
+}
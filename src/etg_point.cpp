@@ -38,6 +38,144 @@
 
 #include "etg_point.h"
 
+/*! \brief Equirectangular to gnomonic transformation initialization
+ *
+ *  This function computes the rotation matrix and pixel size of a gnomonic
+ *  projection once, so that etg_points can convert any number of points of
+ *  the equirectangular image in its rectilinear image. The structure is only
+ *  read afterwards, so that the conversion can be called concurrently
+ *
+ *  \param  t        Transformation structure to initialize
+ *  \param  e_width  Width, in pixels, of the equirectangular image
+ *  \param  e_height Height, in pixels, of the equirectangular image
+ *  \param  c_width  Width, in pixels, of the rectilinear image
+ *  \param  c_height Height, in pixels, of the rectilinear image
+ *  \param  c_azim   Azimuth of gnomonic center
+ *  \param  c_elev   Elevation of gnomonic center
+ *  \param  c_appe   Apperture of the gnomonic projection
+ */
+
+void etg_transform_init(
+
+    etg_transform * const t,
+    double          const e_width,
+    double          const e_height,
+    double          const c_width,
+    double          const c_height,
+    double          const c_azim,
+    double          const c_elev,
+    double          const c_appe
+
+) {
+
+    /* Assign images sizes */
+    t->e_width  = e_width;
+    t->e_height = e_height;
+    t->c_width  = c_width;
+    t->c_height = c_height;
+
+    /* Compute pixel sizes */
+    t->c_pixel = 2.0 * tan( c_appe / 2.0 ) / c_width;
+
+    /* Create rotation matrix */
+    lg_algebra_e2rrotation( t->m, c_azim, c_elev, 0 );
+
+}
+
+/*! \brief Equirectangular to gnomonic batched coordinates converter
+ *
+ *  This function converts the coordinates of an array of points of the
+ *  equirectangular image in the rectilinear image of a transformation.
+ *  Results are the ones of etg_point
+ *
+ *  \param  t        Transformation initialized with etg_transform_init
+ *  \param  count    Number of points
+ *  \param  e_x      X positions, in pixels, of the points in equirectangular mapping
+ *  \param  e_y      Y positions, in pixels, of the points in equirectangular mapping
+ *  \param  c_x      X positions of the points in rectilinear image
+ *  \param  c_y      Y positions of the points in rectilinear image
+ *  \param  c_v      First order visibility of the points (Optionnal)
+ *
+ *  \return Returns the number of points passing the first order visibility
+ *  test
+ */
+
+int etg_points(
+
+    etg_transform const * const t,
+    int               const count,
+    double    const * const e_x,
+    double    const * const e_y,
+    double          * const c_x,
+    double          * const c_y,
+    int             * const c_v
+
+) {
+
+    /* Visible points count */
+    int visible = 0;
+
+    /* Iterate over points */
+    for ( int i = 0; i < count; i ++ ) {
+
+        /* Position arrays */
+        double pi[3];
+        double pf[3];
+
+        /* Compute spherical angles */
+        double s_x = ( ( e_x[i] / t->e_width  ) * LG_PI2 );
+        double s_y = ( ( e_y[i] / t->e_height ) - 0.5 ) * LG_PI;
+
+        /* Compute position in reference frame */
+        pf[0] = + cos( s_y );
+        pf[1] = + sin( s_x ) * pf[0];
+        pf[0] = + cos( s_x ) * pf[0];
+        pf[2] = + sin( s_y );
+
+        /* Apply rotation on position */
+        pi[0] = t->m[0][0] * pf[0] + t->m[0][1] * pf[1] + t->m[0][2] * pf[2];
+        pi[1] = t->m[1][0] * pf[0] + t->m[1][1] * pf[1] + t->m[1][2] * pf[2];
+        pi[2] = t->m[2][0] * pf[0] + t->m[2][1] * pf[1] + t->m[2][2] * pf[2];
+
+        /* Compute coordinates in secondary rectilinear frame */
+        c_x[i] = + ( ( pi[1] / pi[0] ) / t->c_pixel ) + ( t->c_width  / 2.0 );
+        c_y[i] = + ( ( pi[2] / pi[0] ) / t->c_pixel ) + ( t->c_height / 2.0 );
+
+        /* Compute frist order visibility condition */
+        if ( c_v != NULL ) c_v[i] = ( pi[0] > 0 ) ? 1 : 0;
+
+        /* Count visible points */
+        if ( pi[0] > 0 ) visible ++;
+
+    }
+
+    /* Return visible points count */
+    return( visible );
+
+}
+
+/*! \brief Equirectangular to gnomonic coordinates converter
+ *
+ *  This function converts the coordinates of a point seen on the reference
+ *  equirectangular image in the rectilinear image coordinates system obtained
+ *  using gnomonic projection parameters.
+ *
+ *  \param  e_width  Width, in pixels, of the equirectangular image
+ *  \param  e_height Height, in pixels, of the equirectangular image
+ *  \param  e_x      X position, in pixels, of the point in equirectangular mapping
+ *  \param  e_y      Y position, in pixels, of the point in equirectangular mapping
+ *  \param  c_width  Width, in pixels, of the rectilinear image
+ *  \param  c_height Height, in pixels, of the rectilinear image
+ *  \param  c_azim   Azimuth of gnomonic center
+ *  \param  c_elev   Elevation of gnomonic center
+ *  \param  c_appe   Apperture of the gnomonic projection
+ *  \param  c_x      X position of the point in rectilinear image
+ *  \param  c_y      Y position of the point in rectilinear image
+ *
+ *  \return Returns one if first order visibility test of the computed point
+ *  coordinates is triggered, zero otherwise
+ */
+
 int etg_point(
 
     double   const e_width,
@@ -54,46 +192,13 @@ int etg_point(
 
 ) {
 
-    /* Matrix array */
-    static double m[3][3] = { { 0.0 } };
-
-    /* Position arrays */
-    static double pi[3] = { 0.0 };
-    static double pf[3] = { 0.0 };
-
-    /* Pixel sizes */
-    static double c_pixel = 0.0;
-
-    /* Pixel spherical angles */
-    static double s_x = 0.0;
-    static double s_y = 0.0;
-
-    /* Compute pixel sizes */
-    c_pixel = 2.0 * tan( c_appe / 2.0 ) / c_width;
-
-    /* Compute spherical angles */
-    s_x = ( ( e_x / e_width  ) * LG_PI2 );
-    s_y = ( ( e_y / e_height ) - 0.5 ) * LG_PI;
-
-    /* Compute position in reference frame */
-    pf[0] = + cos( s_y );
-    pf[1] = + sin( s_x ) * pf[0];
-    pf[0] = + cos( s_x ) * pf[0];
-    pf[2] = + sin( s_y );
-
-    /* Create rotation matrix */
-    lg_algebra_e2rrotation( m, c_azim, c_elev, 0 );
-
-    /* Apply rotation on position */
-    pi[0] = m[0][0] * pf[0] + m[0][1] * pf[1] + m[0][2] * pf[2];
-    pi[1] = m[1][0] * pf[0] + m[1][1] * pf[1] + m[1][2] * pf[2];
-    pi[2] = m[2][0] * pf[0] + m[2][1] * pf[1] + m[2][2] * pf[2];
+    /* Transformation (local, function is reentrant) */
+    etg_transform t;
 
-    /* Compute coordinates in secondary rectilinear frame */
-    * c_x = + ( ( pi[1] / pi[0] ) / c_pixel ) + ( c_width  / 2.0 );
-    * c_y = + ( ( pi[2] / pi[0] ) / c_pixel ) + ( c_height / 2.0 );
+    /* Initialize transformation */
+    etg_transform_init( &t, e_width, e_height, c_width, c_height, c_azim, c_elev, c_appe );
 
-    /* Compute frist order visibility condition */
-    if ( pi[0] > 0 ) return( 1 ); else return( 0 );
+    /* Convert point */
+    return( etg_points( &t, 1, &e_x, &e_y, c_x, c_y, NULL ) );
 
 }
@@ -0,0 +1,371 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "exporter.h"
+
+/* Constructor */
+Exporter::Exporter(QString export_path, float zoom_level, int threads, int max_images)
+{
+    /* Assign settings */
+    this->export_path = export_path;
+    this->zoom_level = zoom_level;
+
+    /* Bounded workers pool, each object is projected on a single thread */
+    this->pool.setMaxThreadCount( qMax( 1, threads ) );
+
+    /* Bound decoded images kept alive by pending exports */
+    this->images.release( qMax( 1, max_images ) );
+
+    /* IDs start at 1 */
+    this->next_id.store( 1 );
+}
+
+/* Destructor (waits for pending exports) */
+Exporter::~Exporter()
+{
+    /* Wait for workers */
+    this->wait();
+}
+
+/* Function to get the output directory of an object */
+QString Exporter::objectPath(ObjectRect* rect)
+{
+    /* Output path container */
+    QString path;
+
+    /* Rect type switch */
+    switch(rect->getObjectType())
+    {
+
+    /* Face */
+    case ObjectType::Face:
+
+        /* Rect subtype switch */
+        switch(rect->getObjectSubType())
+        {
+
+        /* Undefined subtype */
+        case ObjectSubType::None:
+
+            /* Append path */
+            path = (this->export_path + "/Face/None/");
+            break;
+
+        /* Front */
+        case ObjectSubType::Front:
+
+            /* Append path */
+            path = (this->export_path + "/Face/Front/");
+            break;
+
+        /* Profile */
+        case ObjectSubType::Profile:
+
+            /* Append path */
+            path = (this->export_path + "/Face/Profile/");
+            break;
+
+        /* Back */
+        case ObjectSubType::Back:
+
+            /* Append path */
+            path = (this->export_path + "/Face/Back/");
+            break;
+
+        /* Top */
+        case ObjectSubType::Top:
+
+            /* Append path */
+            path = (this->export_path + "/Face/Top/");
+            break;
+
+        /* Eyes */
+        case ObjectSubType::Eyes:
+
+            /* Append path */
+            path = (this->export_path + "/Face/Eyes/");
+            break;
+        }
+        break;
+
+    /* Number plate */
+    case ObjectType::NumberPlate:
+        path = (this->export_path + "/NumberPlate/");
+        break;
+
+    /* "ToBlur" */
+    case ObjectType::ToBlur:
+        path = (this->export_path + "/ToBlur/");
+        break;
+    }
+
+    /* If manual status is valid */
+    if( rect->getManualStatus() == ObjectManualStatus::Valid )
+    {
+        /* Append valid path */
+        path += "Valid/";
+
+    /* If manual status is invalid */
+    } else if ( rect->getManualStatus() == ObjectManualStatus::Invalid ){
+
+        /* Append invalid path */
+        path += "Invalid/";
+
+    /* If rect is not human validated */
+    } else {
+
+        /* If automatic status is valid */
+        if( rect->getAutomaticStatus() == ObjectAutomaticStatus::Valid )
+        {
+            /* Append specifiec valid path */
+            path += "Valid_Not_Validated/";
+        } else {
+
+            /* Append specifiec valid path */
+            path += "Invalid_Not_Validated/";
+        }
+    }
+
+    /* Return result */
+    return path;
+}
+
+/* Function to create directories and reserve IDs above existing files */
+void Exporter::prepareDirectories(const QStringList &paths)
+{
+    /* Lock directories set */
+    QMutexLocker locker(&this->directories_mutex);
+
+    /* Iterate over paths */
+    foreach(const QString &path, paths)
+    {
+        /* Skip already prepared directories */
+        if( this->directories.contains( path ) )
+            continue;
+
+        /* Create directory if not exists */
+        if( !QDir( path ).exists() )
+        {
+            QDir().mkpath( path );
+
+        } else {
+
+            /* Scan existing tiles once to keep IDs unique */
+            foreach(const QString &name, QDir( path ).entryList( QStringList() << "*.png", QDir::Files ))
+            {
+                /* Parse tile ID */
+                bool valid = false;
+                int id = name.left( name.length() - 4 ).toInt( &valid );
+
+                /* Move next ID above it */
+                if( valid && id >= this->next_id.load() )
+                    this->next_id.store( id + 1 );
+            }
+        }
+
+        /* Mark directory as prepared */
+        this->directories.insert( path );
+    }
+}
+
+/* Function to queue objects export from a decoded image (blocks while max_images images are being exported) */
+int Exporter::exportObjects(const image_info_struct &image_info, QList<ObjectRect*> rects)
+{
+    /* Output directories of objects */
+    QStringList paths;
+    foreach(ObjectRect* rect, rects)
+    {
+        paths.append( this->objectPath( rect ) );
+    }
+
+    /* Create directories up front */
+    this->prepareDirectories( paths );
+
+    /* Wait for a free image slot */
+    this->images.acquire();
+
+    /* Share image with workers, pixels are released with the last export */
+    export_source_struct* source = new export_source_struct;
+    source->image = *image_info.image;
+    source->image_info = image_info;
+    source->image_info.image = &source->image;
+
+    /* Tasks to queue */
+    QList<ExportTask*> tasks;
+
+    /* Iterate over objects */
+    for (int i = 0; i < rects.size(); i++)
+    {
+        /* Get object */
+        ObjectRect* rect = rects.at(i);
+
+        /* Check if rect size is correct */
+        if( rect->getSize().width() < 1 ||
+               rect->getSize().height() < 1 )
+        {
+            continue;
+        }
+
+        /* Create export task */
+        tasks.append( new ExportTask( this, source, rect, paths.at(i) ) );
+    }
+
+    /* Release image directly if nothing to export */
+    if( tasks.isEmpty() )
+    {
+        this->releaseImage( source );
+        return 0;
+    }
+
+    /* Pending exports of the image */
+    source->pending.store( tasks.size() );
+
+    /* Queue exports */
+    foreach(ExportTask* task, tasks)
+    {
+        this->pool.start( task );
+    }
+
+    /* Return number of queued objects */
+    return tasks.size();
+}
+
+/* Function to wait for queued exports */
+void Exporter::wait()
+{
+    /* Wait for workers */
+    this->pool.waitForDone();
+}
+
+/* Function to get number of exported objects */
+int Exporter::exported()
+{
+    /* Return value */
+    return this->exported_count.load();
+}
+
+/* Function to get number of failed exports */
+int Exporter::failed()
+{
+    /* Return value */
+    return this->failed_count.load();
+}
+
+/* Function to project, encode and write an object (called from pool threads) */
+void Exporter::writeObject(const image_info_struct &image_info, ObjectRect* rect, QString path)
+{
+    /* Get selection */
+    QRect selection = exportSelection( rect, this->zoom_level );
+
+    /* Check if selection size is correct */
+    if( selection.isEmpty() )
+        return;
+
+    /* Allocate output ID */
+    QString outpath = path + QString::number( this->next_id.fetchAndAddOrdered( 1 ) ) + ".png";
+
+    /* Project selection */
+    QImage image = exportImage( rect, image_info, selection, this->zoom_level, 1 );
+
+    /* Encode tile in memory */
+    QByteArray encoded;
+    QBuffer buffer( &encoded );
+    buffer.open( QIODevice::WriteOnly );
+    bool success = image.save( &buffer, "PNG" );
+
+    /* Write tile */
+    QFile file( outpath );
+    if( success && file.open( QIODevice::WriteOnly ) )
+    {
+        success = ( file.write( encoded ) == encoded.size() );
+        file.close();
+    } else {
+        success = false;
+    }
+
+    /* Update counters */
+    if( success )
+    {
+        this->exported_count.fetchAndAddOrdered( 1 );
+    } else {
+        this->failed_count.fetchAndAddOrdered( 1 );
+    }
+}
+
+/* Function to release an exported image slot (called from pool threads) */
+void Exporter::releaseImage(export_source_struct* source)
+{
+    /* Delete shared image */
+    delete source;
+
+    /* Free image slot */
+    this->images.release();
+}
+
+/* Constructor */
+ExportTask::ExportTask(Exporter* exporter, export_source_struct* source, ObjectRect* rect, QString path)
+{
+    /* Assign values */
+    this->exporter = exporter;
+    this->source = source;
+    this->path = path;
+
+    /* Keep a private copy of the object */
+    this->rect = rect->copy();
+}
+
+/* Destructor */
+ExportTask::~ExportTask()
+{
+    /* Delete object copy */
+    delete this->rect;
+
+    /* Release source image with its last export */
+    if( !this->source->pending.deref() )
+    {
+        this->exporter->releaseImage( this->source );
+    }
+}
+
+/* Run function */
+void ExportTask::run()
+{
+    /* Export object */
+    this->exporter->writeObject( this->source->image_info, this->rect, this->path );
+}
@@ -38,6 +38,134 @@
 
 #include "g2g_point.h"
 
+/*! \brief Gnomonic to gnomonic transformation initialization
+ *
+ *  This function computes the rotation matrices and pixel sizes of a pair of
+ *  gnomonic projections once, so that g2g_points can convert any number of
+ *  points between them. The structure is only read afterwards, so that the
+ *  conversion can be called concurrently from several threads
+ *
+ *  \param  t        Transformation structure to initialize
+ *  \param  r_width  Width, in pixels, of the reference rectilinear image
+ *  \param  r_height Height, in pixels, of the reference rectilinear image
+ *  \param  r_azim   Azimuth of reference gnomonic center
+ *  \param  r_elev   Elevation of reference gnomonic center
+ *  \param  r_appe   Apperture of the reference gnomonic projection
+ *  \param  c_width  Width, in pixels, of the secondary rectilinear image
+ *  \param  c_height Height, in pixels, of the secondary rectilinear image
+ *  \param  c_azim   Azimuth of secondary gnomonic center
+ *  \param  c_elev   Elevation of secondary gnomonic center
+ *  \param  c_appe   Apperture of the secondary gnomonic projection
+ */
+
+void g2g_transform_init(
+
+    g2g_transform * const t,
+    double          const r_width,
+    double          const r_height,
+    double          const r_azim,
+    double          const r_elev,
+    double          const r_appe,
+    double          const c_width,
+    double          const c_height,
+    double          const c_azim,
+    double          const c_elev,
+    double          const c_appe
+
+) {
+
+    /* Assign images sizes */
+    t->r_width  = r_width;
+    t->r_height = r_height;
+    t->c_width  = c_width;
+    t->c_height = c_height;
+
+    /* Compute pixel sizes */
+    t->r_pixel = 2.0 * tan( r_appe / 2.0 ) / r_width;
+    t->c_pixel = 2.0 * tan( c_appe / 2.0 ) / c_width;
+
+    /* Create rotation matrices */
+    lg_algebra_r2erotation( t->r_m, r_azim, r_elev, 0 );
+    lg_algebra_e2rrotation( t->c_m, c_azim, c_elev, 0 );
+
+}
+
+/*! \brief Gnomonic to gnomonic batched coordinates converter
+ *
+ *  This function converts the coordinates of an array of points seen in the
+ *  reference rectilinear image of a transformation in the frame of its
+ *  secondary rectilinear image. Results are the ones of g2g_point
+ *
+ *  \param  t        Transformation initialized with g2g_transform_init
+ *  \param  count    Number of points
+ *  \param  r_x      X positions of the points in reference rectilinear image
+ *  \param  r_y      Y positions of the points in reference rectilinear image
+ *  \param  c_x      X positions of the points in secondary rectilinear image (Optionnal)
+ *  \param  c_y      Y positions of the points in secondary rectilinear image (Optionnal)
+ *  \param  c_v      First order visibility of the points (Optionnal)
+ *
+ *  \return Returns the number of points passing the first order visibility
+ *  test
+ */
+
+int g2g_points(
+
+    g2g_transform const * const t,
+    int               const count,
+    double    const * const r_x,
+    double    const * const r_y,
+    double          * const c_x,
+    double          * const c_y,
+    int             * const c_v
+
+) {
+
+    /* Visible points count */
+    int visible = 0;
+
+    /* Iterate over points */
+    for ( int i = 0; i < count; i ++ ) {
+
+        /* Position arrays */
+        double pi[3];
+        double pf[3];
+
+        /* Compute position in reference rectilinear frame */
+        pi[0] = + ( 1.0 );
+        pi[1] = + ( r_x[i] - ( t->r_width  / 2.0 ) ) * t->r_pixel;
+        pi[2] = + ( r_y[i] - ( t->r_height / 2.0 ) ) * t->r_pixel;
+
+        /* Apply rotation on position */
+        pf[0] = t->r_m[0][0] * pi[0] + t->r_m[0][1] * pi[1] + t->r_m[0][2] * pi[2];
+        pf[1] = t->r_m[1][0] * pi[0] + t->r_m[1][1] * pi[1] + t->r_m[1][2] * pi[2];
+        pf[2] = t->r_m[2][0] * pi[0] + t->r_m[2][1] * pi[1] + t->r_m[2][2] * pi[2];
+
+        /* Apply rotation on position */
+        pi[0] = t->c_m[0][0] * pf[0] + t->c_m[0][1] * pf[1] + t->c_m[0][2] * pf[2];
+        pi[1] = t->c_m[1][0] * pf[0] + t->c_m[1][1] * pf[1] + t->c_m[1][2] * pf[2];
+        pi[2] = t->c_m[2][0] * pf[0] + t->c_m[2][1] * pf[1] + t->c_m[2][2] * pf[2];
+
+        /* Check if destination variables are specified */
+        if( c_x != NULL && c_y != NULL )
+        {
+            /* Compute coordinates in secondary rectilinear frame */
+            c_x[i] = + ( ( pi[1] / pi[0] ) / t->c_pixel ) + ( t->c_width  / 2.0 );
+            c_y[i] = + ( ( pi[2] / pi[0] ) / t->c_pixel ) + ( t->c_height / 2.0 );
+        }
+
+        /* Compute frist order visibility condition */
+        if ( c_v != NULL ) c_v[i] = ( pi[0] > 0 ) ? 1 : 0;
+
+        /* Count visible points */
+        if ( pi[0] > 0 ) visible ++;
+
+    }
+
+    /* Return visible points count */
+    return( visible );
+
+}
+
 /*! \brief Gnomonic to gnomonic coordinates converter
  *
  *  This function converts the coordinates of a point seen in a rectilinear
@@ -83,51 +211,12 @@ int g2g_point(
 
 ) {
 
-    /* Matrix array */
-    static double m[3][3] = { { 0.0 } };
-
-    /* Position arrays */
-    static double pi[3] = { 0.0 };
-    static double pf[3] = { 0.0 };
+    /* Transformation (local, function is reentrant) */
+    g2g_transform t;
 
-    /* Pixel sizes */
-    static double r_pixel = 0.0;
-    static double c_pixel = 0.0;
-
-    /* Compute pixel sizes */
-    r_pixel = 2.0 * tan( r_appe / 2.0 ) / r_width;
-    c_pixel = 2.0 * tan( c_appe / 2.0 ) / c_width;
-
-    /* Compute position in reference rectilinear frame */
-    pi[0] = + ( 1.0 );
-    pi[1] = + ( r_x - ( r_width  / 2.0 ) ) * r_pixel;
-    pi[2] = + ( r_y - ( r_height / 2.0 ) ) * r_pixel;
-
-    /* Create rotation matrix */
-    lg_algebra_r2erotation( m, r_azim, r_elev, 0 );
-
-    /* Apply rotation on position */
-    pf[0] = m[0][0] * pi[0] + m[0][1] * pi[1] + m[0][2] * pi[2];
-    pf[1] = m[1][0] * pi[0] + m[1][1] * pi[1] + m[1][2] * pi[2];
-    pf[2] = m[2][0] * pi[0] + m[2][1] * pi[1] + m[2][2] * pi[2];
-
-    /* Create rotation matrix */
-    lg_algebra_e2rrotation( m, c_azim, c_elev, 0 );
-
-    /* Apply rotation on position */
-    pi[0] = m[0][0] * pf[0] + m[0][1] * pf[1] + m[0][2] * pf[2];
-    pi[1] = m[1][0] * pf[0] + m[1][1] * pf[1] + m[1][2] * pf[2];
-    pi[2] = m[2][0] * pf[0] + m[2][1] * pf[1] + m[2][2] * pf[2];
-
-    /* Check if destination variables are specified */
-    if( c_x != NULL && c_y != NULL )
-    {
-        /* Compute coordinates in secondary rectilinear frame */
-        * c_x = + ( ( pi[1] / pi[0] ) / c_pixel ) + ( c_width  / 2.0 );
-        * c_y = + ( ( pi[2] / pi[0] ) / c_pixel ) + ( c_height / 2.0 );
-    }
+    /* Initialize transformation */
+    g2g_transform_init( &t, r_width, r_height, r_azim, r_elev, r_appe, c_width, c_height, c_azim, c_elev, c_appe );
 
-    /* Compute frist order visibility condition */
-    if ( pi[0] > 0 ) return( 1 );
-    else return( 0 );
+    /* Convert point */
+    return( g2g_points( &t, 1, &r_x, &r_y, c_x, c_y, NULL ) );
 }
@@ -0,0 +1,131 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "imageconvert.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+/* Function to convert a row of 8 bits BGR pixels into RGB32 pixels */
+void convertRowBGR(const uchar* src, QRgb* dst, int width)
+{
+    /* Current pixel */
+    int x = 0;
+
+#if defined(__SSSE3__)
+
+    /* Shuffle mask spreading four BGR pixels over four 32 bits pixels */
+    const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+    /* Opaque alpha channel */
+    const __m128i alpha = _mm_set1_epi32( (int) 0xFF000000 );
+
+    /* Convert sixteen pixels at once (48 source bytes) */
+    for (; (x + 16) <= width; x += 16)
+    {
+        /* Load source bytes */
+        __m128i in0 = _mm_loadu_si128( (const __m128i *) (src + (x * 3)) );
+        __m128i in1 = _mm_loadu_si128( (const __m128i *) (src + (x * 3) + 16) );
+        __m128i in2 = _mm_loadu_si128( (const __m128i *) (src + (x * 3) + 32) );
+
+        /* Store converted pixels */
+        _mm_storeu_si128( (__m128i *) (dst + x),      _mm_or_si128( _mm_shuffle_epi8( in0, mask ), alpha ) );
+        _mm_storeu_si128( (__m128i *) (dst + x + 4),  _mm_or_si128( _mm_shuffle_epi8( _mm_alignr_epi8( in1, in0, 12 ), mask ), alpha ) );
+        _mm_storeu_si128( (__m128i *) (dst + x + 8),  _mm_or_si128( _mm_shuffle_epi8( _mm_alignr_epi8( in2, in1, 8 ), mask ), alpha ) );
+        _mm_storeu_si128( (__m128i *) (dst + x + 12), _mm_or_si128( _mm_shuffle_epi8( _mm_srli_si128( in2, 4 ), mask ), alpha ) );
+    }
+
+    /* Convert four pixels at once while a full 16 bytes load stays in row */
+    for (; (x + 6) <= width; x += 4)
+    {
+        /* Load source bytes */
+        __m128i in = _mm_loadu_si128( (const __m128i *) (src + (x * 3)) );
+
+        /* Store converted pixels */
+        _mm_storeu_si128( (__m128i *) (dst + x), _mm_or_si128( _mm_shuffle_epi8( in, mask ), alpha ) );
+    }
+
+#endif
+
+    /* Convert remaining pixels */
+    for (; x < width; x++)
+    {
+        dst[x] = qRgb(src[x * 3 + 2], src[x * 3 + 1], src[x * 3]);
+    }
+}
+
+/* Function to convert a row of 8 bits grayscale pixels into RGB32 pixels */
+void convertRowGray(const uchar* src, QRgb* dst, int width)
+{
+    /* Current pixel */
+    int x = 0;
+
+#if defined(__SSSE3__)
+
+    /* Shuffle masks replicating four gray pixels over four 32 bits pixels */
+    const __m128i mask0 = _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1);
+    const __m128i mask1 = _mm_setr_epi8(4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1);
+    const __m128i mask2 = _mm_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1);
+    const __m128i mask3 = _mm_setr_epi8(12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1);
+
+    /* Opaque alpha channel */
+    const __m128i alpha = _mm_set1_epi32( (int) 0xFF000000 );
+
+    /* Convert sixteen pixels at once */
+    for (; (x + 16) <= width; x += 16)
+    {
+        /* Load source bytes */
+        __m128i in = _mm_loadu_si128( (const __m128i *) (src + x) );
+
+        /* Store converted pixels */
+        _mm_storeu_si128( (__m128i *) (dst + x),      _mm_or_si128( _mm_shuffle_epi8( in, mask0 ), alpha ) );
+        _mm_storeu_si128( (__m128i *) (dst + x + 4),  _mm_or_si128( _mm_shuffle_epi8( in, mask1 ), alpha ) );
+        _mm_storeu_si128( (__m128i *) (dst + x + 8),  _mm_or_si128( _mm_shuffle_epi8( in, mask2 ), alpha ) );
+        _mm_storeu_si128( (__m128i *) (dst + x + 12), _mm_or_si128( _mm_shuffle_epi8( in, mask3 ), alpha ) );
+    }
+
+#endif
+
+    /* Convert remaining pixels */
+    for (; x < width; x++)
+    {
+        dst[x] = qRgb(src[x], src[x], src[x]);
+    }
+}
@@ -0,0 +1,482 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "jpegdecoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csetjmp>
+#include <algorithm>
+
+extern "C" {
+#include <jpeglib.h>
+}
+
+/* libjpeg error manager (errors jump back instead of exiting) */
+struct jpeg_error_struct{
+    struct jpeg_error_mgr manager;
+    jmp_buf jump;
+};
+
+/* libjpeg error handler */
+static void jpegErrorExit(j_common_ptr info)
+{
+    /* Jump back to caller */
+    longjmp( ( (jpeg_error_struct*) info->err )->jump, 1 );
+}
+
+/* libjpeg warnings are ignored (corrupted data is reported by errors) */
+static void jpegOutputMessage(j_common_ptr)
+{
+}
+
+/* Function to read a big endian 16 bits value */
+static inline int readWord(const uchar* data)
+{
+    return ( data[0] << 8 ) | data[1];
+}
+
+/* Function to load an image, JPEGs with restart markers are decoded in parallel strips (falls back on OpenCV) */
+IplImage* JpegDecoder::load(QString path, int threads)
+{
+    /* Parallel decoding */
+    IplImage* image = JpegDecoder::decode( path, threads );
+
+    /* Fall back on OpenCV decoder */
+    if( image == NULL )
+    {
+        TraceZone zone( "JpegDecoder::fallback" );
+        image = cvLoadImage( path.toStdString().c_str(), CV_LOAD_IMAGE_UNCHANGED );
+    }
+
+    /* Return image */
+    return image;
+}
+
+/* Function to decode a JPEG in parallel strips split on restart markers (NULL if not possible) */
+IplImage* JpegDecoder::decode(QString path, int threads)
+{
+    /* Trace zone */
+    TraceZone zone( "JpegDecoder::decode" );
+
+    /* Map file */
+    QFile file( path );
+    if( !file.open( QIODevice::ReadOnly ) || file.size() < 4 )
+        return NULL;
+
+    const uchar* data = file.map( 0, file.size() );
+    if( data == NULL )
+        return NULL;
+
+    /* Read layout */
+    jpeg_layout_struct layout;
+    if( !JpegDecoder::parse( data, file.size(), layout ) || layout.restart_interval <= 0 )
+        return NULL;
+
+    /* Strips granularity */
+    int group = layout.restart_rows;
+
+    /* Determine strips (a few per thread for balancing) */
+    int groups = ( layout.mcus_y + group - 1 ) / group;
+    int strips = qMin( groups, qMax( 1, threads ) * 4 );
+    int strip_rows = ( ( groups + strips - 1 ) / strips ) * group;
+    strips = ( layout.mcus_y + strip_rows - 1 ) / strip_rows;
+
+    /* Not worth splitting */
+    if( strips < 2 )
+        return NULL;
+
+    /* Allocate destination image (same as OpenCV decoder) */
+    IplImage* image = cvCreateImage( cvSize( layout.width, layout.height ), IPL_DEPTH_8U, layout.components == 1 ? 1 : 3 );
+
+    /* Decode strips directly into destination rows */
+    QAtomicInt failed( 0 );
+    #pragma omp parallel for num_threads( qMax( 1, threads ) ) schedule( dynamic )
+    for (int i = 0; i < strips; i++)
+    {
+        if( !JpegDecoder::decodeStrip( data, layout, i * strip_rows, qMin( strip_rows, layout.mcus_y - i * strip_rows ), image ) )
+            failed.store( 1 );
+    }
+
+    /* Check strips */
+    if( failed.load() )
+    {
+        std::cout << "[WARNING] Parallel decoding failed, falling back: " << path.toStdString() << std::endl;
+        cvReleaseImage( &image );
+        return NULL;
+    }
+
+    /* Return image */
+    return image;
+}
+
+/* Function to read the layout of a JPEG stream (returns false if not a single scan baseline JPEG) */
+bool JpegDecoder::parse(const uchar* data, qint64 size, jpeg_layout_struct &layout)
+{
+    /* Initialize layout */
+    layout.width = 0;
+    layout.height = 0;
+    layout.components = 0;
+    layout.restart_interval = 0;
+    layout.restart_rows = 0;
+    layout.context_rows = 0;
+    layout.height_offset = 0;
+    layout.header_size = 0;
+    layout.data_end = 0;
+    layout.restarts.clear();
+
+    /* Maximal sampling factors */
+    int h_max = 1;
+    int v_max = 1;
+
+    /* Check start of image */
+    if( size < 4 || data[0] != 0xFF || data[1] != 0xD8 )
+        return false;
+
+    /* Iterate over markers segments until start of scan */
+    qint64 pos = 2;
+    while( true )
+    {
+        /* Skip fill bytes */
+        if( pos + 4 > size || data[pos] != 0xFF )
+            return false;
+        while( pos + 4 <= size && data[pos + 1] == 0xFF )
+            pos++;
+        if( pos + 4 > size )
+            return false;
+
+        /* Read marker and segment */
+        int marker = data[pos + 1];
+        qint64 length = readWord( data + pos + 2 );
+        const uchar* segment = data + pos + 4;
+        if( length < 2 || pos + 2 + length > size )
+            return false;
+
+        /* Baseline / extended sequential Huffman frame */
+        if( marker == 0xC0 || marker == 0xC1 )
+        {
+            /* 8 bits samples only */
+            if( length < 8 || segment[0] != 8 )
+                return false;
+
+            layout.height_offset = pos + 5;
+            layout.height = readWord( segment + 1 );
+            layout.width = readWord( segment + 3 );
+            layout.components = segment[5];
+
+            /* Grayscale or three components only */
+            if( ( layout.components != 1 && layout.components != 3 ) || length < 8 + 3 * layout.components )
+                return false;
+
+            /* Read sampling factors */
+            for (int i = 0; i < layout.components; i++)
+            {
+                h_max = qMax( h_max, segment[7 + i * 3] >> 4 );
+                v_max = qMax( v_max, segment[7 + i * 3] & 0x0F );
+            }
+
+        /* Progressive, lossless, arithmetic or hierarchical frames */
+        } else if( marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC ) {
+            return false;
+
+        /* Restart interval */
+        } else if( marker == 0xDD ) {
+            if( length < 4 )
+                return false;
+            layout.restart_interval = readWord( segment );
+
+        /* Start of scan */
+        } else if( marker == 0xDA ) {
+
+            /* Single interleaved scan of all components only */
+            if( layout.components == 0 || layout.height == 0 || segment[0] != layout.components )
+                return false;
+
+            layout.header_size = pos + 2 + length;
+            break;
+        }
+
+        /* Next segment */
+        pos += 2 + length;
+    }
+
+    /* MCU dimensions (single component scans are not interleaved) */
+    layout.mcu_width = layout.components == 1 ? 8 : 8 * h_max;
+    layout.mcu_height = layout.components == 1 ? 8 : 8 * v_max;
+    layout.mcus_x = ( layout.width + layout.mcu_width - 1 ) / layout.mcu_width;
+    layout.mcus_y = ( layout.height + layout.mcu_height - 1 ) / layout.mcu_height;
+
+    /* Scan entropy coded data for restart markers */
+    for (pos = layout.header_size; pos + 1 < size; pos++)
+    {
+        /* Skip data bytes */
+        if( data[pos] != 0xFF )
+            continue;
+
+        /* Byte stuffing and fill bytes */
+        int marker = data[pos + 1];
+        if( marker == 0x00 || marker == 0xFF )
+        {
+            if( marker == 0x00 )
+                pos++;
+            continue;
+        }
+
+        /* Restart marker */
+        if( marker >= 0xD0 && marker <= 0xD7 )
+        {
+            layout.restarts.append( pos );
+            pos++;
+            continue;
+        }
+
+        /* End of scan */
+        layout.data_end = pos;
+        break;
+    }
+
+    /* Check entropy coded data end */
+    if( layout.data_end == 0 )
+        return false;
+
+    /* Check restart markers count (a missing marker would shift strips) */
+    if( layout.restart_interval > 0 )
+    {
+        qint64 intervals = ( (qint64) layout.mcus_x * layout.mcus_y + layout.restart_interval - 1 ) / layout.restart_interval;
+        if( layout.restarts.size() != intervals - 1 )
+            return false;
+
+        /* Smallest MCU rows group ending on a restart marker */
+        layout.restart_rows = 1;
+        while( ( (qint64) layout.restart_rows * layout.mcus_x ) % layout.restart_interval != 0 )
+            layout.restart_rows++;
+
+        /* Vertically subsampled chroma is interpolated with neighbour rows */
+        if( layout.components == 3 && layout.mcu_height > 8 )
+            layout.context_rows = layout.restart_rows;
+    }
+
+    /* Return result */
+    return true;
+}
+
+/* Function to decode a strip of MCU rows into its rows of destination image */
+bool JpegDecoder::decodeStrip(const uchar* data, const jpeg_layout_struct &layout, int first_row, int rows, IplImage* image)
+{
+    /* Trace zone */
+    TraceZone zone( "JpegDecoder::decodeStrip" );
+
+    /* Decoded MCU rows (strip and its upsampling context) */
+    int decode_first = qMax( 0, first_row - layout.context_rows );
+    int decode_last = qMin( layout.mcus_y, first_row + rows + layout.context_rows );
+
+    /* Decoded restart intervals range */
+    qint64 intervals = layout.restarts.size() + 1;
+    qint64 first = ( (qint64) decode_first * layout.mcus_x ) / layout.restart_interval;
+    qint64 last = qMin( intervals, ( (qint64) decode_last * layout.mcus_x + layout.restart_interval - 1 ) / layout.restart_interval );
+
+    /* Decoded entropy coded data */
+    qint64 begin = first == 0 ? layout.header_size : layout.restarts.at( first - 1 ) + 2;
+    qint64 end = last == intervals ? layout.data_end : layout.restarts.at( last - 1 );
+
+    /* Decoded and strip pixels rows */
+    int decode_y = decode_first * layout.mcu_height;
+    int decode_height = qMin( decode_last * layout.mcu_height, layout.height ) - decode_y;
+    int y = first_row * layout.mcu_height;
+    int height = qMin( rows * layout.mcu_height, layout.height - y );
+
+    /* Build standalone stream: headers, decoded data, end of image */
+    QByteArray stream;
+    stream.reserve( layout.header_size + ( end - begin ) + 2 );
+    stream.append( (const char*) data, layout.header_size );
+    stream.append( (const char*) data + begin, end - begin );
+    stream.append( (char) 0xFF );
+    stream.append( (char) 0xD9 );
+    uchar* bytes = (uchar*) stream.data();
+
+    /* Assign decoded height */
+    bytes[layout.height_offset] = ( decode_height >> 8 ) & 0xFF;
+    bytes[layout.height_offset + 1] = decode_height & 0xFF;
+
+    /* Renumber restart markers from zero */
+    for (qint64 i = first; i < last - 1; i++)
+        bytes[layout.header_size + ( layout.restarts.at( i ) - begin ) + 1] = 0xD0 + ( ( i - first ) & 7 );
+
+    /* Context rows buffer */
+    QByteArray context( image->widthStep, 0 );
+
+    /* Initialize decoder */
+    struct jpeg_decompress_struct info;
+    jpeg_error_struct error;
+    info.err = jpeg_std_error( &error.manager );
+    error.manager.error_exit = jpegErrorExit;
+    error.manager.output_message = jpegOutputMessage;
+
+    /* Decoding errors */
+    if( setjmp( error.jump ) )
+    {
+        jpeg_destroy_decompress( &info );
+        return false;
+    }
+
+    /* Read stream headers */
+    jpeg_create_decompress( &info );
+    jpeg_mem_src( &info, bytes, stream.size() );
+    jpeg_read_header( &info, TRUE );
+
+    /* Decode to OpenCV channels order */
+#ifdef JCS_EXTENSIONS
+    info.out_color_space = layout.components == 1 ? JCS_GRAYSCALE : JCS_EXT_BGR;
+#else
+    info.out_color_space = layout.components == 1 ? JCS_GRAYSCALE : JCS_RGB;
+#endif
+    jpeg_start_decompress( &info );
+
+    /* Check decoded dimensions */
+    if( (int) info.output_width != layout.width || (int) info.output_height != decode_height || info.output_components != image->nChannels )
+    {
+        jpeg_destroy_decompress( &info );
+        return false;
+    }
+
+    /* Decode strip rows directly into destination image (context rows are dropped) */
+    while( (int) info.output_scanline < y - decode_y + height )
+    {
+        int row_y = decode_y + info.output_scanline;
+        JSAMPROW row = row_y < y ? (JSAMPROW) context.data() : (JSAMPROW) ( image->imageData + (qint64) row_y * image->widthStep );
+        jpeg_read_scanlines( &info, &row, 1 );
+
+#ifndef JCS_EXTENSIONS
+        /* Swap red and blue channels */
+        if( layout.components != 1 )
+        {
+            for (int x = 0; x < layout.width; x++)
+                std::swap( row[x * 3], row[x * 3 + 2] );
+        }
+#endif
+    }
+
+    /* Release decoder (trailing context rows are not needed) */
+    jpeg_destroy_decompress( &info );
+
+    /* Return result */
+    return true;
+}
+
+/* Function to re-encode a JPEG losslessly with one restart marker per MCU row (enables parallel decoding) */
+bool JpegDecoder::addRestartMarkers(QString path, QString destination)
+{
+    /* Read source */
+    QFile file( path );
+    if( !file.open( QIODevice::ReadOnly ) )
+        return false;
+    QByteArray source = file.readAll();
+    file.close();
+
+    /* Output buffer (allocated by libjpeg) */
+    unsigned char* output = NULL;
+    unsigned long output_size = 0;
+
+    /* Initialize decoder and encoder sharing error manager */
+    struct jpeg_decompress_struct src_info;
+    struct jpeg_compress_struct dst_info;
+    jpeg_error_struct error;
+    src_info.err = jpeg_std_error( &error.manager );
+    dst_info.err = &error.manager;
+    error.manager.error_exit = jpegErrorExit;
+    error.manager.output_message = jpegOutputMessage;
+
+    /* Transcoding errors */
+    if( setjmp( error.jump ) )
+    {
+        jpeg_destroy_compress( &dst_info );
+        jpeg_destroy_decompress( &src_info );
+        free( output );
+        return false;
+    }
+
+    jpeg_create_decompress( &src_info );
+    jpeg_create_compress( &dst_info );
+
+    /* Keep comments and application markers (EXIF, XMP) */
+    jpeg_save_markers( &src_info, JPEG_COM, 0xFFFF );
+    for (int i = 0; i < 16; i++)
+        jpeg_save_markers( &src_info, JPEG_APP0 + i, 0xFFFF );
+
+    /* Read DCT coefficients (no decoding) */
+    jpeg_mem_src( &src_info, (unsigned char*) source.data(), source.size() );
+    jpeg_read_header( &src_info, TRUE );
+    jvirt_barray_ptr* coefficients = jpeg_read_coefficients( &src_info );
+
+    /* Write same coefficients, sequential with one restart interval per MCU row */
+    jpeg_copy_critical_parameters( &src_info, &dst_info );
+    dst_info.restart_in_rows = 1;
+    dst_info.optimize_coding = TRUE;
+    jpeg_mem_dest( &dst_info, &output, &output_size );
+    jpeg_write_coefficients( &dst_info, coefficients );
+
+    /* Copy saved markers (JFIF and Adobe markers are written by encoder) */
+    for (jpeg_saved_marker_ptr marker = src_info.marker_list; marker != NULL; marker = marker->next)
+    {
+        if( dst_info.write_JFIF_header && marker->marker == JPEG_APP0 && marker->data_length >= 5 && memcmp( marker->data, "JFIF", 5 ) == 0 )
+            continue;
+        if( dst_info.write_Adobe_marker && marker->marker == JPEG_APP0 + 14 && marker->data_length >= 5 && memcmp( marker->data, "Adobe", 5 ) == 0 )
+            continue;
+        jpeg_write_marker( &dst_info, marker->marker, marker->data, marker->data_length );
+    }
+
+    /* Complete transcoding */
+    jpeg_finish_compress( &dst_info );
+    jpeg_finish_decompress( &src_info );
+    jpeg_destroy_compress( &dst_info );
+    jpeg_destroy_decompress( &src_info );
+
+    /* Write destination atomically (source can be replaced in place) */
+    QSaveFile target( destination );
+    bool success = target.open( QIODevice::WriteOnly ) &&
+                   target.write( (const char*) output, output_size ) == (qint64) output_size &&
+                   target.commit();
+
+    /* Release output buffer */
+    free( output );
+
+    /* Return result */
+    return success;
+}
@@ -38,11 +38,55 @@
 
 #include "main.h"
 
+/* Function to create the application, command line modes run without GUI */
+QCoreApplication* createApplication(int &argc, char *argv[])
+{
+    /* Iterate over arguments */
+    for (int i = 1; i < argc; i++)
+    {
+        /* Get argument */
+        QString argument = QString::fromLocal8Bit( argv[i] );
+
+        /* Mode value container */
+        QString mode_name;
+
+        /* Mode with separate value */
+        if( ( argument == "-m" || argument == "--mode" ) && i + 1 < argc )
+        {
+            mode_name = QString::fromLocal8Bit( argv[i + 1] ).toLower();
+
+        /* Mode with attached value */
+        } else if( argument.startsWith( "--mode=" ) ) {
+            mode_name = argument.mid( 7 ).toLower();
+        }
+
+        /* Headless modes */
+        if( mode_name == "exporter" || mode_name == "batchexporter" || mode_name == "ymlconverter" || mode_name == "sidecar" || mode_name == "jpegrestart" )
+        {
+            return new QCoreApplication(argc, argv);
+        }
+    }
+
+    /* Validator */
+    return new QApplication(argc, argv);
+}
+
+/* Trace output path (written at exit if tracing is enabled) */
+static QString trace_path;
+
+/* Function to write trace at exit (modes exit from anywhere) */
+static void dumpTrace()
+{
+    /* Write Chrome trace-event JSON */
+    if( !Trace::dump( trace_path ) )
+        std::cout << "[ERROR] Unable to write trace " << trace_path.toStdString() << std::endl;
+}
+
 /* Program entry point */
 int main(int argc, char *argv[])
 {
     /* Main application container */
-    QApplication app(argc, argv);
+    QScopedPointer<QCoreApplication> app( createApplication(argc, argv) );
 
     /* Application version info */
     QCoreApplication::setApplicationName("Yafdb-Validator");
@@ -58,7 +102,7 @@ int main(int argc, char *argv[])
     /* Mode */
     QCommandLineOption modeOption(QStringList() << "m" << "mode",
             QCoreApplication::translate("main", "Application mode"),
-            QCoreApplication::translate("main", "validator(default) | exporter | ymlconverter"));
+            QCoreApplication::translate("main", "validator(default) | session | exporter | batchexporter | ymlconverter | sidecar | jpegrestart"));
     parser.addOption(modeOption);
 
     /* Input image */
@@ -69,7 +113,7 @@ int main(int argc, char *argv[])
 
     /* Detector YML path */
     QCommandLineOption detectorYMLPathOption(QStringList() << "d" << "detector-yml",
-            QCoreApplication::translate("main", "Detector YML path."),
+            QCoreApplication::translate("main", "Detector YML path (repeatable in ymlconverter mode)."),
             QCoreApplication::translate("main", "file path"));
     parser.addOption(detectorYMLPathOption);
 
@@ -91,8 +135,71 @@ int main(int argc, char *argv[])
             QCoreApplication::translate("main", "zoomlevel (default 1.0)"));
     parser.addOption(exportZoomOption);
 
+    /* Panorama cache budget */
+    QCommandLineOption cacheBudgetOption(QStringList() << "c" << "cache-budget",
+            QCoreApplication::translate("main", "Panorama tiles cache memory budget"),
+            QCoreApplication::translate("main", "megabytes (default 256)"));
+    parser.addOption(cacheBudgetOption);
+
+    /* Decoded panoramas disk cache */
+    QCommandLineOption decodeCacheOption(QStringList() << "decode-cache",
+            QCoreApplication::translate("main", "Keep decoded panoramas in specified directory, reopened panoramas are memory mapped instead of decoded."),
+            QCoreApplication::translate("main", "path"));
+    parser.addOption(decodeCacheOption);
+
+    /* Decoded panoramas disk cache size */
+    QCommandLineOption decodeCacheSizeOption(QStringList() << "decode-cache-size",
+            QCoreApplication::translate("main", "Decoded panoramas disk cache size, least recently used panoramas are evicted above it"),
+            QCoreApplication::translate("main", "megabytes (default 4096)"));
+    parser.addOption(decodeCacheSizeOption);
+
+    /* Batch export manifest */
+    QCommandLineOption manifestOption(QStringList() << "l" << "manifest",
+            QCoreApplication::translate("main", "Batch export manifest (one \"image yml\" pair per line)"),
+            QCoreApplication::translate("main", "file path"));
+    parser.addOption(manifestOption);
+
+    /* Batch export directory */
+    QCommandLineOption batchDirOption(QStringList() << "b" << "batch-dir",
+            QCoreApplication::translate("main", "Batch export / session yafdb blurring directory"),
+            QCoreApplication::translate("main", "path"));
+    parser.addOption(batchDirOption);
+
+    /* Autosave interval */
+    QCommandLineOption autosaveOption(QStringList() << "a" << "autosave",
+            QCoreApplication::translate("main", "Autosave snapshot interval, 0 to disable (validator / session modes)."),
+            QCoreApplication::translate("main", "seconds (default 120)"));
+    parser.addOption(autosaveOption);
+
+    /* Binary sidecar */
+    QCommandLineOption sidecarOption(QStringList() << "s" << "sidecar",
+            QCoreApplication::translate("main", "Write a binary sidecar next to destination YML on save (validator / session modes)."));
+    parser.addOption(sidecarOption);
+
+    /* Session state file */
+    QCommandLineOption stateOption(QStringList() << "t" << "state",
+            QCoreApplication::translate("main", "Session validated timestamps file, relative to blurring directory (session mode)."),
+            QCoreApplication::translate("main", "file path (default validated.job)"));
+    parser.addOption(stateOption);
+
+    /* Session revalidation */
+    QCommandLineOption revalidateOption(QStringList() << "r" << "revalidate",
+            QCoreApplication::translate("main", "Include already validated panoramas (session mode)."));
+    parser.addOption(revalidateOption);
+
+    /* Trace output */
+    QCommandLineOption traceOption(QStringList() << "trace",
+            QCoreApplication::translate("main", "Record timing zones and write them as Chrome trace-event JSON at exit (F12 toggles frame times overlay)."),
+            QCoreApplication::translate("main", "file path"));
+    parser.addOption(traceOption);
+
+    /* Detector YMLs to convert */
+    parser.addPositionalArgument("ymls",
+            QCoreApplication::translate("main", "Detector YML files to convert (ymlconverter mode), YML or sidecar files to convert (sidecar mode), JPEG images to re-encode (jpegrestart mode)."),
+            "[ymls...]");
+
     /* Process given arguments */
-    parser.process(app);
+    parser.process(*app);
 
     /* Parse application mode in lower case */
     QString mode_name = parser.value(modeOption).toLower();
@@ -108,14 +215,30 @@ int main(int argc, char *argv[])
         {
             mode = ApplicationMode::Validator;
 
+        /* Session */
+        } else if(mode_name == "session") {
+            mode = ApplicationMode::Session;
+
         /* Exporter */
         } else if(mode_name == "exporter") {
             mode = ApplicationMode::Exporter;
 
+        /* Batch exporter */
+        } else if(mode_name == "batchexporter") {
+            mode = ApplicationMode::BatchExporter;
+
         /* YMLConverter */
         } else if( mode_name == "ymlconverter" ) {
             mode = ApplicationMode::YMLConverter;
 
+        /* Sidecar converter */
+        } else if( mode_name == "sidecar" ) {
+            mode = ApplicationMode::Sidecar;
+
+        /* JPEG restart markers re-encoder */
+        } else if( mode_name == "jpegrestart" ) {
+            mode = ApplicationMode::JpegRestart;
+
         /* Invalid mode specified */
         } else {
             std::cout << "[ERROR] Invalid mode: " << mode_name.toStdString() << std::endl;
@@ -123,21 +246,48 @@ int main(int argc, char *argv[])
         }
     }
 
+    /* Enable tracing, trace is written at exit */
+    if( parser.isSet(traceOption) )
+    {
+        trace_path = parser.value(traceOption);
+        Trace::setEnabled( true );
+        atexit( dumpTrace );
+    }
+
+    /* Enable decoded panoramas disk cache */
+    if( parser.isSet(decodeCacheOption) )
+    {
+        QString decodeCacheSize = parser.value(decodeCacheSizeOption);
+        DecodeCache::setup( parser.value(decodeCacheOption), (decodeCacheSize.length() > 0 ? decodeCacheSize.toLongLong() : 4096) * 1024 * 1024 );
+    }
+
     /* Parse given paths */
     QString sourceImagePath = parser.value(sourceImagePathOption);
     QString detectorYMLPath = parser.value(detectorYMLPathOption);
+    QStringList detectorYMLPaths = parser.values(detectorYMLPathOption) + parser.positionalArguments();
     QString destinationYMLPath = parser.value(destinationYMLPathOption);
     QString exportPath = parser.value(exportPathOption);
+    QString manifestPath = parser.value(manifestOption);
+    QString batchDirPath = parser.value(batchDirOption);
+    QString statePath = parser.isSet(stateOption) ? parser.value(stateOption) : "validated.job";
 
     /* Parse zoom level */
     QString exportZoom = parser.value(exportZoomOption);
     float export_zoom = exportZoom.length() > 0 ? exportZoom.toFloat() : 1.0;
 
+    /* Parse cache budget */
+    QString cacheBudget = parser.value(cacheBudgetOption);
+    qint64 cache_budget = (cacheBudget.length() > 0 ? cacheBudget.toLongLong() : 256) * 1024 * 1024;
+
+    /* Parse autosave interval */
+    QString autosave = parser.value(autosaveOption);
+    int autosave_interval = autosave.length() > 0 ? autosave.toInt() : 120;
+
     /* Local arguments validity variable */
     bool argcheck = true;
 
-    /* CHeck source image */
-    if( sourceImagePath.length() <= 0 )
+    /* CHeck source image (batch exporter and converter read images from pairs/YMLs) */
+    if( sourceImagePath.length() <= 0 && mode != ApplicationMode::BatchExporter && mode != ApplicationMode::YMLConverter && mode != ApplicationMode::Sidecar && mode != ApplicationMode::Session && mode != ApplicationMode::JpegRestart )
     {
         /* Info output */
         std::cout << "Missing source image path." << std::endl;
@@ -165,15 +315,23 @@ int main(int argc, char *argv[])
 
     /* Source image infos structure */
     image_info_struct image_info;
-
-    /* Temp image for loading informations */
-    IplImage * temp_image = NULL;
+    image_info.cache = NULL;
 
     /* Rect list for YML Parser */
     QList<ObjectRect*> loaded_rects;
 
-    /* ID index for exporter */
-    int out_id = 1;
+    /* Objects exporter */
+    Exporter* exporter = NULL;
+
+    /* Batch exporter and its pairs */
+    BatchExporter* batch_exporter = NULL;
+    QList<batch_export_pair_struct> batch_pairs;
+
+    /* YML conversion jobs */
+    QList<yml_convert_job_struct> convert_jobs;
+
+    /* Validation session */
+    ValidationSession* session = NULL;
 
     /* Application modes switch */
     switch(mode)
@@ -183,7 +341,45 @@ int main(int argc, char *argv[])
     case ApplicationMode::Validator:
 
         /* Create main validator window */
-        w = new MainWindow(0, sourceImagePath, detectorYMLPath, destinationYMLPath);
+        w = new MainWindow(0, sourceImagePath, detectorYMLPath, destinationYMLPath, cache_budget, parser.isSet(sidecarOption), autosave_interval);
+
+        /* Show validator window */
+        w->show();
+        break;
+
+    /* Session */
+    case ApplicationMode::Session:
+
+        /* Check if invalid path is specified */
+        if( batchDirPath.length() <= 0 )
+        {
+            /* Info output */
+            std::cout << "Session blurring directory missing." << std::endl;
+
+            /* Display hep message */
+            parser.showHelp();
+
+            /* Quit the program */
+            exit( 0 );
+        }
+
+        /* Open session */
+        session = new ValidationSession();
+        if( !session->open( batchDirPath, statePath, parser.isSet(revalidateOption) ) )
+            exit( 0 );
+
+        /* Verify number of items left */
+        if( session->count() <= 0 )
+        {
+            /* Info output */
+            std::cout << "No image(s) to process" << std::endl;
+
+            /* Exit program */
+            exit( 0 );
+        }
+
+        /* Create validator window, kept open over all session panoramas */
+        w = new MainWindow(0, session, cache_budget, parser.isSet(sidecarOption), autosave_interval);
 
         /* Show validator window */
         w->show();
@@ -208,160 +404,189 @@ int main(int argc, char *argv[])
         /* Info output */
         std::cout << "Reading image..." << std::endl;
 
-        /* Load image using OpenCV to get some additionnal details about the image */
-        temp_image = cvLoadImage( sourceImagePath.toStdString().c_str(), CV_LOAD_IMAGE_UNCHANGED );
+        /* Load converted image, mapped from decode cache when enabled (restart markers strips are decoded in parallel) */
+        image_info.image = DecodeCache::load( sourceImagePath, QThread::idealThreadCount() );
 
-        /* Save image details */
-        image_info.channels = (temp_image->nChannels + 1);
-        image_info.width = temp_image->width;
-        image_info.height = temp_image->height;
-        image_info.image = IplImage2QImage( temp_image );
+        /* Check image */
+        if( image_info.image == NULL )
+        {
+            /* Info output */
+            std::cout << "[ERROR] Unable to load image " << sourceImagePath.toStdString() << std::endl;
 
-        /* Unload temporary image */
-        cvReleaseImage( &temp_image );
+            /* Quit the program */
+            exit( 0 );
+        }
+
+        /* Save image details */
+        image_info.width = image_info.image->width();
+        image_info.height = image_info.image->height();
+        image_info.channels = (image_info.image->depth() / 8);
 
         /* Load YML */
         loaded_rects = yml_parser.loadYML( destinationYMLPath, YMLType::Validator );
 
+        /* Report parse throughput */
+        yml_parser.printLoadStats( destinationYMLPath );
+
         /* Info output */
         std::cout << "Exporting " << loaded_rects.length() << " images..." << std::endl;
 
-        /* Iterate over loaded rects */
-        foreach(ObjectRect* rect, loaded_rects)
+        /* Create exporter (one projection worker per core) */
+        exporter = new Exporter( exportPath, export_zoom, QThread::idealThreadCount() );
+
+        /* Queue all objects exports */
+        exporter->exportObjects( image_info, loaded_rects );
+
+        /* Wait for exports */
+        exporter->wait();
+
+        /* Info output */
+        if( exporter->failed() > 0 )
         {
-            /* Output path container */
-            QString path;
+            std::cout << exporter->failed() << " exports failed." << std::endl;
+        }
 
-            /* Rect type switch */
-            switch(rect->getObjectType())
-            {
+        /* Delete exporter */
+        delete exporter;
 
-            /* Face */
-            case ObjectType::Face:
+        /* Info output */
+        std::cout << "Done" << std::endl;
 
-                /* Rect subtype switch */
-                switch(rect->getObjectSubType())
-                {
+        /* Exit the program */
+        exit( 0 );
+        break;
 
-                /* Undefined subtype */
-                case ObjectSubType::None:
+    /* Batch exporter */
+    case ApplicationMode::BatchExporter:
 
-                    /* Append path */
-                    path = (exportPath + "/Face/None/");
-                    break;
+        /* Check if invalid paths are specified */
+        if( exportPath.length() <= 0 || ( manifestPath.length() <= 0 && batchDirPath.length() <= 0 ) )
+        {
+            /* Info output */
+            std::cout << "Export path or batch manifest/directory missing." << std::endl;
 
-                /* Front */
-                case ObjectSubType::Front:
+            /* Display hep message */
+            parser.showHelp();
 
-                    /* Append path */
-                    path = (exportPath + "/Face/Front/");
-                    break;
+            /* Quit the program */
+            exit( 0 );
+        }
 
-                /* Profile */
-                case ObjectSubType::Profile:
+        /* Read pairs from manifest */
+        if( manifestPath.length() > 0 )
+        {
+            batch_pairs += BatchExporter::readManifest( manifestPath );
+        }
 
-                    /* Append path */
-                    path = (exportPath + "/Face/Profile/");
-                    break;
+        /* Find pairs in blurring directory */
+        if( batchDirPath.length() > 0 )
+        {
+            batch_pairs += BatchExporter::scanDirectory( batchDirPath );
+        }
 
-                /* Back */
-                case ObjectSubType::Back:
+        /* Info output */
+        std::cout << "Exporting objects of " << batch_pairs.length() << " images..." << std::endl;
 
-                    /* Append path */
-                    path = (exportPath + "/Face/Back/");
-                    break;
+        /* Create batch exporter (one projection worker per core) */
+        batch_exporter = new BatchExporter( exportPath, export_zoom, QThread::idealThreadCount() );
 
-                /* Top */
-                case ObjectSubType::Top:
+        /* Export all pairs */
+        batch_exporter->exportPairs( batch_pairs );
 
-                    /* Append path */
-                    path = (exportPath + "/Face/Top/");
-                    break;
+        /* Delete batch exporter */
+        delete batch_exporter;
 
-                /* Eyes */
-                case ObjectSubType::Eyes:
+        /* Info output */
+        std::cout << "Done" << std::endl;
 
-                    /* Append path */
-                    path = (exportPath + "/Face/Eyes/");
-                    break;
-                }
-                break;
+        /* Exit the program */
+        exit( 0 );
+        break;
 
-            /* Number plate */
-            case ObjectType::NumberPlate:
-                path = (exportPath + "/NumberPlate/");
-                break;
+    /* YML Converter */
+    case ApplicationMode::YMLConverter:
 
-            /* "ToBlur" */
-            case ObjectType::ToBlur:
-                path = (exportPath + "/ToBlur/");
-                break;
-            }
+        /* Check if invalid path is specified */
+        if( detectorYMLPaths.isEmpty() )
+        {
+            /* Info output */
+            std::cout << "Missing detector YML path." << std::endl;
 
-            /* If manual status is valid */
-            if( rect->getManualStatus().toLower() == "valid" )
-            {
-                /* Append valid path */
-                path += "Valid/";
+            /* Show help */
+            parser.showHelp();
+
+            /* Exit program */
+            exit( 0 );
+        }
 
-            /* If manual status is invalid */
-            } else if ( rect->getManualStatus().toLower() == "invalid" ){
+        /* Iterate over detector YMLs */
+        foreach(const QString &path, detectorYMLPaths)
+        {
+            /* Conversion job */
+            yml_convert_job_struct job;
+            job.source_path = path;
 
-                /* Append invalid path */
-                path += "Invalid/";
+            /* Single YML is written to destination path */
+            if( detectorYMLPaths.size() == 1 && destinationYMLPath.length() > 0 )
+            {
+                job.destination_path = destinationYMLPath;
 
-            /* If rect is not human validated */
+            /* Multiple YMLs are written to destination directory, or next to their source */
             } else {
 
-                /* If automatic status is valid */
-                if( rect->getAutomaticStatus().toLower() == "valid" )
+                /* Output file name */
+                QString name = QFileInfo( path ).completeBaseName() + "_converted.yml";
+
+                /* Assign output path */
+                if( destinationYMLPath.length() > 0 )
                 {
-                    /* Append specifiec valid path */
-                    path += "Valid_Not_Validated/";
+                    QDir().mkpath( destinationYMLPath );
+                    job.destination_path = QDir( destinationYMLPath ).absoluteFilePath( name );
                 } else {
-
-                    /* Append specifiec valid path */
-                    path += "Invalid_Not_Validated/";
+                    job.destination_path = QFileInfo( path ).absoluteDir().absoluteFilePath( name );
                 }
             }
 
-            /* Create computed path if not exists */
-            if(!QDir( path ).exists())
-            {
-                QDir().mkpath( path );
-            }
+            /* Append job */
+            convert_jobs.append( job );
+        }
 
-            /* Append tile it to path */
-            QString outpath = path +
-                    QString::number( out_id ) +
-                    ".png";
+        /* Info output */
+        std::cout << "Converting " << convert_jobs.size() << " YML files..." << std::endl;
 
-            /* Increment output id until file exists */
-            while( QFile( outpath ).exists() )
+        /* Convert all YMLs on all cores (image sizes are read from headers only) */
+        {
+            /* Skipped conversions (empty detector YMLs) */
+            int skipped = 0;
+
+            /* Convert and report failures */
+            if( YMLConverter( sourceImagePath ).convert( convert_jobs, QThread::idealThreadCount(), &skipped ) > 0 )
             {
-                out_id++;
-                outpath = path + QString::number( out_id ) + ".png";
+                /* Info output */
+                std::cout << "Some conversions failed." << std::endl;
             }
 
-            /* Export cropped tile */
-            exportRect( rect, image_info, outpath, export_zoom);
+            /* Report skipped YMLs */
+            if( skipped > 0 )
+                std::cout << skipped << " YML files without objects, empty YMLs written." << std::endl;
         }
 
         /* Info output */
-        std::cout << "Done" << std::endl;
+        std::cout << "Done." << std::endl;
 
-        /* Exit the program */
+        /* Exit program */
         exit( 0 );
+
         break;
 
-    /* YML Converter */
-    case ApplicationMode::YMLConverter:
+    /* YML / binary sidecar converter */
+    case ApplicationMode::Sidecar:
 
         /* Check if invalid path is specified */
-        if( detectorYMLPath.length() <= 0 )
+        if( detectorYMLPaths.isEmpty() )
         {
             /* Info output */
-            std::cout << "Missing detector YML path." << std::endl;
+            std::cout << "Missing YML or sidecar path." << std::endl;
 
             /* Show help */
             parser.showHelp();
@@ -370,47 +595,95 @@ int main(int argc, char *argv[])
             exit( 0 );
         }
 
-        /* Info output */
-        std::cout << "Reading image..." << std::endl;
+        /* Iterate over files */
+        foreach(const QString &path, detectorYMLPaths)
+        {
+            /* Sidecar to YML */
+            if( path.endsWith( ".yfdb" ) )
+            {
+                /* Read sidecar */
+                if( !AnnotationFile::read( path, loaded_rects ) )
+                {
+                    std::cout << "[ERROR] Invalid sidecar: " << path.toStdString() << std::endl;
+                    continue;
+                }
+
+                /* Write YML (empty object list gives an empty YML), then restamp sidecar with it */
+                if( !yml_parser.writeYML( loaded_rects, AnnotationFile::ymlPath( path ) ) ||
+                    !AnnotationFile::write( loaded_rects, path, AnnotationFile::ymlPath( path ) ) )
+                {
+                    std::cout << "[ERROR] Unable to write YML: " << AnnotationFile::ymlPath( path ).toStdString() << std::endl;
+                    qDeleteAll( loaded_rects );
+                    loaded_rects.clear();
+                    continue;
+                }
 
-        /* Load image using OpenCV to get some additionnal details about the image */
-        temp_image = cvLoadImage( sourceImagePath.toStdString().c_str(), CV_LOAD_IMAGE_UNCHANGED );
+                /* Info output */
+                std::cout << path.toStdString() << " -> " << AnnotationFile::ymlPath( path ).toStdString() << " (" << loaded_rects.length() << " objects)" << std::endl;
 
-        /* Save image details */
-        image_info.channels = (temp_image->nChannels + 1);
-        image_info.width = temp_image->width;
-        image_info.height = temp_image->height;
-        image_info.image = IplImage2QImage( temp_image );
+            /* YML to sidecar */
+            } else {
 
-        /* Unload temporary image */
-        cvReleaseImage( &temp_image );
+                /* Load YML */
+                loaded_rects = yml_parser.loadYML( path, YMLType::Validator );
 
-        /* Load rects from YML */
-        loaded_rects = yml_parser.loadYML( detectorYMLPath, YMLType::Detector );
+                /* Report parse throughput */
+                yml_parser.printLoadStats( path );
+
+                /* Write sidecar */
+                if( !AnnotationFile::write( loaded_rects, AnnotationFile::sidecarPath( path ), path ) )
+                    std::cout << "[ERROR] Unable to write sidecar: " << AnnotationFile::sidecarPath( path ).toStdString() << std::endl;
+            }
+
+            /* Release objects */
+            qDeleteAll( loaded_rects );
+            loaded_rects.clear();
+        }
 
         /* Info output */
-        std::cout << "Converting points..." << std::endl;
+        std::cout << "Done." << std::endl;
 
-        /* Iterate over loaded rects */
-        foreach(ObjectRect* rect, loaded_rects)
+        /* Exit program */
+        exit( 0 );
+
+        break;
+
+    /* JPEG restart markers re-encoder */
+    case ApplicationMode::JpegRestart:
+
+        /* Check if invalid path is specified */
+        if( detectorYMLPaths.isEmpty() )
         {
-            /* Convert spherical coordinates to local gnomonic */
-            rect->mapFromSpherical(image_info.width,
-                                   image_info.height,
-                                   1920 / 2,
-                                   1080 / 2,
-                                   0.0,
-                                   0.0,
-                                   20.0 * (LG_PI / 180.0),
-                                   20.0 * (LG_PI / 180.0),
-                                   120.0 * (LG_PI / 180.0));
+            /* Info output */
+            std::cout << "Missing JPEG image path." << std::endl;
+
+            /* Show help */
+            parser.showHelp();
+
+            /* Exit program */
+            exit( 0 );
         }
 
-        /* Info output */
-        std::cout << "Writing YML." << std::endl;
+        /* Create export directory */
+        if( exportPath.length() > 0 )
+            QDir().mkpath( exportPath );
+
+        /* Iterate over images */
+        foreach(const QString &path, detectorYMLPaths)
+        {
+            /* Re-encoded image path (in place unless an export path is given) */
+            QString target = exportPath.length() > 0 ? QDir( exportPath ).filePath( QFileInfo( path ).fileName() ) : path;
 
-        /* Write converted items to YML */
-        yml_parser.writeYML( loaded_rects, destinationYMLPath );
+            /* Re-encode image (DCT coefficients are kept, no quality loss) */
+            if( !JpegDecoder::addRestartMarkers( path, target ) )
+            {
+                std::cout << "[ERROR] Unable to re-encode image: " << path.toStdString() << std::endl;
+                continue;
+            }
+
+            /* Info output */
+            std::cout << path.toStdString() << " -> " << target.toStdString() << std::endl;
+        }
 
         /* Info output */
         std::cout << "Done." << std::endl;
@@ -422,5 +695,5 @@ int main(int argc, char *argv[])
     }
 
     /* Wait until app finishes */
-    return app.exec();
+    return app->exec();
 }
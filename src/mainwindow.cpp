@@ -44,13 +44,86 @@
 #include <QGraphicsProxyWidget>
 
 #include "ymlparser.h"
+#include "annotationfile.h"
 
 /* Constructor */
-MainWindow::MainWindow(QWidget *parent, QString sourceImagePath, QString detectorYMLPath, QString destinationYMLPath) :
+MainWindow::MainWindow(QWidget *parent, QString sourceImagePath, QString detectorYMLPath, QString destinationYMLPath, qint64 cacheBudget, bool sidecar, int autosaveInterval) :
     QMainWindow(parent),
     ui(new Ui::MainWindow)
 {
+    /* Assign panorama cache budget */
+    this->options.cacheBudget = cacheBudget;
+
+    /* Assign binary sidecar setting */
+    this->options.sidecar = sidecar;
+
+    /* Assign autosave interval (in seconds) */
+    this->options.autosaveInterval = autosaveInterval;
+
+    /* Not in session mode */
+    this->session.session = NULL;
+    this->session.index = 0;
+    this->session.prefetcher = NULL;
+    this->session.created = false;
+    this->session.quitting = false;
+
+    /* Initialize background saves */
+    this->initializeSaves();
+
     this->initializeValidator(sourceImagePath, detectorYMLPath, destinationYMLPath);
+
+    /* Start autosave */
+    this->startAutosave();
+}
+
+/* Constructor (session mode, all panoramas of a session are validated in this window) */
+MainWindow::MainWindow(QWidget *parent, ValidationSession* session, qint64 cacheBudget, bool sidecar, int autosaveInterval) :
+    QMainWindow(parent),
+    ui(new Ui::MainWindow)
+{
+    /* Assign panorama cache budget */
+    this->options.cacheBudget = cacheBudget;
+
+    /* Assign binary sidecar setting */
+    this->options.sidecar = sidecar;
+
+    /* Assign autosave interval (in seconds) */
+    this->options.autosaveInterval = autosaveInterval;
+
+    /* Assign session */
+    this->session.session = session;
+    this->session.index = 0;
+    this->session.quitting = false;
+
+    /* Initialize background saves */
+    this->initializeSaves();
+
+    /* First item */
+    validation_item_struct item = session->item( 0 );
+    this->session.created = !QFile::exists( item.destination_yml_path );
+
+    /* Info output */
+    std::cout << ( this->session.created ? "[Create]" : "[Edit]" ) << " Processing image 1 of " << session->count() << " (" << item.timestamp.toStdString() << ")" << std::endl;
+
+    this->initializeValidator(item.image_path, item.detector_yml_path, item.destination_yml_path);
+
+    /* Snapshot loaded objects */
+    this->session.snapshot = AnnotationFile::serialize( this->pano->rect_list );
+
+    /* Start autosave */
+    this->startAutosave();
+
+    /* Show session progress */
+    this->setWindowTitle( QString("[1/%1] %2").arg( session->count() ).arg( item.timestamp ) );
+
+    /* Bind CTRL+Q to session quit */
+    new QShortcut(QKeySequence("Ctrl+Q"), this, SLOT(onQuit()));
+
+    /* Prefetch next panorama while current one is validated */
+    this->session.prefetcher = new PanoramaPrefetcher( this );
+    this->session.prefetcher->setup( this->pano->threads() );
+    if( session->count() > 1 )
+        this->session.prefetcher->prefetch( session->item( 1 ).image_path );
 }
 
 /* Destructor */
@@ -59,6 +132,42 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+/* Function to initialize background saves and autosave timer */
+void MainWindow::initializeSaves()
+{
+    /* Initialize background saves, pending saves are completed before exit */
+    this->saver = new AnnotationSaver( this );
+    connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(finishSaves()));
+
+    /* Close is completed once destination save is reported */
+    connect(this->saver, SIGNAL(saved(QString,bool)), this, SLOT(saveCompleted(QString,bool)));
+    this->closing.validate = false;
+    this->closing.accepted = false;
+
+    /* Initialize autosave timer */
+    this->autosave_timer = new QTimer( this );
+    connect(this->autosave_timer, SIGNAL(timeout()), this, SLOT(autosave()));
+}
+
+/* Function to start autosave of current destination YML */
+void MainWindow::startAutosave()
+{
+    /* Stop autosave of previous destination */
+    this->autosave_timer->stop();
+    this->autosave_snapshot.clear();
+
+    /* Start autosave if a destination is specified */
+    if( this->options.destinationYMLPath.length() > 0 && this->options.autosaveInterval > 0 )
+    {
+        /* Warn about snapshot left by a previous session */
+        if( QFile::exists( AnnotationSaver::autosavePath( this->options.destinationYMLPath ) ) )
+            std::cout << "[WARNING] Autosave snapshot found: " << AnnotationSaver::autosavePath( this->options.destinationYMLPath ).toStdString() << std::endl;
+
+        /* Start timer */
+        this->autosave_timer->start( this->options.autosaveInterval * 1000 );
+    }
+}
+
 /* Initial setup function */
 void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYMLPath, QString destinationYMLPath)
 {
@@ -81,6 +190,12 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
     this->good_color = good_color_string;
     this->warn_color = warn_color_string;
 
+    /* Labels colors are not assigned yet */
+    this->label_states.untyped = -1;
+    this->label_states.faces = -1;
+    this->label_states.plates = -1;
+    this->label_states.preinvalidated = -1;
+
     /* Remove margins */
     this->setContentsMargins(-5, -5, -5, -5);
 
@@ -119,7 +234,6 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
     /* Variables to store files presence */
     bool sourceImageFile_exists = false;
     bool detectorYMLFile_exists = false;
-    bool destinationYMLFile_exists = false;
 
     /* Check if source image exists */
     if( this->options.sourceImagePath.length() > 0 )
@@ -135,13 +249,6 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
         detectorYMLFile_exists = ( detectorYMLFile.exists() && detectorYMLFile.isFile( ));
     }
 
-    /* Check if destination YML exists */
-    if( this->options.destinationYMLPath.length() > 0 )
-    {
-        QFileInfo destinationYMLFile( this->options.destinationYMLPath );
-        destinationYMLFile_exists = ( destinationYMLFile.exists() && destinationYMLFile.isFile( ));
-    }
-
     /* Display proper messages */
     if( !sourceImageFile_exists )
     {
@@ -154,9 +261,45 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
         std::cout << "[ERROR] Invalid detector YML path: " << this->options.detectorYMLPath.toStdString() << std::endl;
     }
 
+    /* Configure panorama tiles cache */
+    this->pano->setCacheBudget( this->options.cacheBudget );
+
     /* Load input image */
     this->pano->loadImage( this->options.sourceImagePath );
 
+    /* Load objects */
+    this->loadObjects();
+
+    /* Check if no YML files are specified */
+    if( ( this->options.destinationYMLPath.length() <= 0) && ( this->options.detectorYMLPath.length() <= 0 ) )
+    {
+        /* Disable batche actions elements */
+        this->ui->groupBox->setVisible( false );
+
+        /* Disable visibility groups elements */
+        this->ui->groupBox_3->setVisible( false );
+
+        /* Disable object creation */
+        this->pano->setCreateEnabled( false );
+
+        /* Disable sight */
+        this->pano->setSightEnabled( false );
+    }
+
+    /* Bind ESC key to window close */
+    new QShortcut(QKeySequence("Esc"), this, SLOT(onESC()));
+
+    /* Initialize labels */
+    emit refreshLabels();
+}
+
+/* Function to load objects from current YML files */
+void MainWindow::loadObjects()
+{
+    /* Check YML files presence */
+    bool detectorYMLFile_exists = QFileInfo( this->options.detectorYMLPath ).isFile();
+    bool destinationYMLFile_exists = QFileInfo( this->options.destinationYMLPath ).isFile();
+
     /* Intialize YML parser */
     YMLParser parser;
 
@@ -172,6 +315,9 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
                 /* Load validator YML */
                 QList<ObjectRect*> loaded_rects = parser.loadYML( this->options.destinationYMLPath, YMLType::Validator );
 
+                /* Report parse throughput */
+                parser.printLoadStats( this->options.destinationYMLPath );
+
                 /* Iterate over loaded rects */
                 foreach(ObjectRect* rect, loaded_rects)
                 {
@@ -191,7 +337,7 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
                         child->setId( this->pano->rect_list_id_index++ );
                     }
 
-                    this->pano->rect_list.append( rect );
+                    this->pano->appendObject( rect );
                     this->pano->getScene()->addItem( rect );
 
                     /* Check object visibility */
@@ -205,6 +351,9 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
                 /* Load detector YML */
                 QList<ObjectRect*> loaded_rects = parser.loadYML( this->options.detectorYMLPath, YMLType::Detector );
 
+                /* Report parse throughput */
+                parser.printLoadStats( this->options.detectorYMLPath );
+
                 /* Iterate over loaded rects */
                 foreach(ObjectRect* rect, loaded_rects)
                 {
@@ -228,7 +377,7 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
                         child->setId( this->pano->rect_list_id_index++ );
                     }
 
-                    this->pano->rect_list.append( rect );
+                    this->pano->appendObject( rect );
                     this->pano->getScene()->addItem( rect );
 
                     /* Check object visibility */
@@ -250,6 +399,9 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
                 /* Load validator YML */
                 QList<ObjectRect*> loaded_rects = parser.loadYML( this->options.destinationYMLPath, YMLType::Validator );
 
+                /* Report parse throughput */
+                parser.printLoadStats( this->options.destinationYMLPath );
+
                 /* Iterate over loaded rects */
                 foreach(ObjectRect* rect, loaded_rects)
                 {
@@ -270,7 +422,7 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
                         child->setId( this->pano->rect_list_id_index++ );
                     }
 
-                    this->pano->rect_list.append( rect );
+                    this->pano->appendObject( rect );
                     this->pano->getScene()->addItem( rect );
 
                     /* Check object visibility */
@@ -284,184 +436,52 @@ void MainWindow::initializeValidator(QString sourceImagePath, QString detectorYM
 
         }
     }
-
-    /* Check if no YML files are specified */
-    if( ( this->options.destinationYMLPath.length() <= 0) && ( this->options.detectorYMLPath.length() <= 0 ) )
-    {
-        /* Disable batche actions elements */
-        this->ui->groupBox->setVisible( false );
-
-        /* Disable visibility groups elements */
-        this->ui->groupBox_3->setVisible( false );
-
-        /* Disable object creation */
-        this->pano->setCreateEnabled( false );
-
-        /* Disable sight */
-        this->pano->setSightEnabled( false );
-    }
-
-    /* Bind ESC key to window close */
-    new QShortcut(QKeySequence("Esc"), this, SLOT(onESC()));
-
-    /* Initialize labels */
-    emit refreshLabels();
 }
 
 /* (UI action) Refresh labels */
 void MainWindow::refreshLabels()
 {
-    /* Types / States counter variables */
-    int untyped = 0;
-
-    int facecount = 0;
-    int facesvalidated = 0;
-
-    int numberplatescount = 0;
-    int numberplatesvalidated = 0;
-
-    int preinvalidatedcount = 0;
-    int preinvalidatedvalidated = 0;
-
-    int toblurcount = 0;
+    /* Objects statistics (maintained incrementally by objects) */
+    ObjectStats* stats = this->pano->statistics();
 
-    /* Iterate over PanoramaViewer rects */
-    foreach(ObjectRect* rect, this->pano->rect_list)
-    {
-        /* Rect type swith */
-        switch(rect->getObjectType())
-        {
-
-        /* Untyped rect */
-        case ObjectType::None:
-
-            /* Increment untyped items */
-            untyped++;
-            break;
-
-        /* Face */
-        case ObjectType::Face:
-
-            /* If automatic status is valid or automatic status is None */
-            if(rect->getAutomaticStatus() == "Valid" || rect->getAutomaticStatus() == "None")
-            {
-                /* Increment faces count */
-                facecount++;
-            }
-
-            /* If automatic status is valid or automatic status is None and manual status is not None */
-            if( (rect->getAutomaticStatus() == "Valid" || rect->getAutomaticStatus() == "None")
-                    && rect->getManualStatus() != "None")
-            {
-                /* Increment validated faces count */
-                facesvalidated++;
-            }
-
-            /* If automatic status is pre-filtered */
-            if(rect->getAutomaticStatus() != "None" && rect->getAutomaticStatus() != "Valid")
-            {
-                /* Increment pre-filtered items count */
-                preinvalidatedcount++;
-            }
-
-            /* If automatic status is pre-filtered and manualy validated */
-            if(rect->getAutomaticStatus() != "None" && rect->getAutomaticStatus() != "Valid" && rect->getManualStatus() != "None")
-            {
-                /* Increment pre-filtered (manualy validated) items count */
-                preinvalidatedvalidated++;
-            }
-
-            break;
-
-        /* NumberPlate */
-        case ObjectType::NumberPlate:
+    /* Types / States counter variables */
+    int untyped = stats->untyped();
 
-            /* Increment NumberPlate items count */
-            numberplatescount++;
+    int facecount = stats->faces();
+    int facesvalidated = stats->facesValidated();
 
-            /* If object is manualy validated */
-            if(rect->getManualStatus() != "None")
-            {
-                /* Increment NumberPlate (manualy validated) items count */
-                numberplatesvalidated++;
-            }
+    int numberplatescount = stats->plates();
+    int numberplatesvalidated = stats->platesValidated();
 
-            break;
+    int preinvalidatedcount = stats->preInvalidated();
+    int preinvalidatedvalidated = stats->preInvalidatedValidated();
 
-        /* "ToBlur" */
-        case ObjectType::ToBlur:
-
-            /* Increment "ToBlur" objects count */
-            toblurcount++;
-            break;
-        }
-    }
+    int toblurcount = stats->toBlur();
 
     /* Untyped items labels update */
-    if(untyped > 0)
-    {
-        this->ui->untypedLabel->setStyleSheet("QLabel {color: " + this->warn_color + "; }");
-        this->ui->untypedButton->setEnabled(true);
-    } else {
-        this->ui->untypedLabel->setStyleSheet("QLabel {color: " + this->good_color + "; }");
-        this->ui->untypedButton->setEnabled(false);
-    }
+    this->setLabelState( this->ui->untypedLabel, this->label_states.untyped, untyped > 0 );
+    this->ui->untypedButton->setEnabled( untyped > 0 );
 
     /* Face items labels update */
-    if(facecount <= 0)
-    {
-        this->ui->facesButton->setEnabled(false);
-    } else {
-        this->ui->facesButton->setEnabled(true);
-    }
+    this->ui->facesButton->setEnabled( facecount > 0 );
 
     /* NumberPlate items labels update */
-    if(numberplatescount <= 0)
-    {
-        this->ui->platesButton->setEnabled(false);
-    } else {
-        this->ui->platesButton->setEnabled(true);
-    }
+    this->ui->platesButton->setEnabled( numberplatescount > 0 );
 
     /* Pre-invalidated items labels update */
-    if(preinvalidatedcount <= 0)
-    {
-        this->ui->preInvalidatedButton->setEnabled(false);
-    } else {
-        this->ui->preInvalidatedButton->setEnabled(true);
-    }
+    this->ui->preInvalidatedButton->setEnabled( preinvalidatedcount > 0 );
 
     /* "ToBlur" items labels update */
-    if(toblurcount <= 0)
-    {
-        this->ui->toBlurButton->setEnabled(false);
-    } else {
-        this->ui->toBlurButton->setEnabled(true);
-    }
+    this->ui->toBlurButton->setEnabled( toblurcount > 0 );
 
     /* Assign proper label color if not all Faces are manualy vlidated */
-    if(facesvalidated != facecount)
-    {
-        this->ui->facesLabel->setStyleSheet("QLabel {color: " + this->warn_color + "; }");
-    } else {
-        this->ui->facesLabel->setStyleSheet("QLabel {color: " + this->good_color + "; }");
-    }
+    this->setLabelState( this->ui->facesLabel, this->label_states.faces, facesvalidated != facecount );
 
     /* Assign proper label color if not all NumberPlates are manualy vlidated */
-    if(numberplatesvalidated != numberplatescount)
-    {
-        this->ui->platesLabel->setStyleSheet("QLabel {color: " + this->warn_color + "; }");
-    } else {
-        this->ui->platesLabel->setStyleSheet("QLabel {color: " + this->good_color + "; }");
-    }
+    this->setLabelState( this->ui->platesLabel, this->label_states.plates, numberplatesvalidated != numberplatescount );
 
     /* Assign proper label color if not all pre-invalidated objects are manualy vlidated */
-    if(preinvalidatedvalidated != preinvalidatedcount)
-    {
-        this->ui->preInvalidatedLabel->setStyleSheet("QLabel {color: " + this->warn_color + "; }");
-    } else {
-        this->ui->preInvalidatedLabel->setStyleSheet("QLabel {color: " + this->good_color + "; }");
-    }
+    this->setLabelState( this->ui->preInvalidatedLabel, this->label_states.preinvalidated, preinvalidatedvalidated != preinvalidatedcount );
 
     /* Update labels text */
     /* Untyped items */
@@ -481,6 +501,20 @@ void MainWindow::refreshLabels()
 
 }
 
+/* Function to set label color, stylesheet is only updated when state changes */
+void MainWindow::setLabelState(QLabel* label, int &state, bool warn)
+{
+    /* Skip if color is already assigned (stylesheets are costly to re-apply) */
+    if( state == (warn ? 1 : 0) )
+        return;
+
+    /* Assign state */
+    state = warn ? 1 : 0;
+
+    /* Assign color */
+    label->setStyleSheet("QLabel {color: " + ( warn ? this->warn_color : this->good_color ) + "; }");
+}
+
 /* (UI action) Update scale factor slider */
 void MainWindow::updateScaleSlider(int value)
 {
@@ -491,6 +525,53 @@ void MainWindow::updateScaleSlider(int value)
 /* Window close event */
 void MainWindow::closeEvent (QCloseEvent *event)
 {
+    /* Accept close completed by a save */
+    if( this->closing.accepted )
+    {
+        this->closing.accepted = false;
+        event->accept();
+        return;
+    }
+
+    /* Ignore close while destination is being saved */
+    if( !this->closing.path.isEmpty() )
+    {
+        event->ignore();
+        return;
+    }
+
+    /* Session mode */
+    if( this->session.session != NULL )
+    {
+        /* Ask for saving current item */
+        if( !this->closeItem() )
+        {
+            /* Ignore action */
+            this->session.quitting = false;
+            event->ignore();
+            return;
+        }
+
+        /* Item is advanced once its save is reported (saved objects are not editable meanwhile) */
+        if( !this->closing.path.isEmpty() )
+        {
+            this->setEnabled( false );
+            event->ignore();
+            return;
+        }
+
+        /* Keep window open on next item */
+        if( this->nextItem() )
+        {
+            event->ignore();
+            return;
+        }
+
+        /* Accept event */
+        event->accept();
+        return;
+    }
+
     /* Check if destination YML path is specified */
     if( ! ( this->options.destinationYMLPath.length() <= 0) && ( this->options.detectorYMLPath.length() <= 0 ) )
     {
@@ -508,24 +589,239 @@ void MainWindow::closeEvent (QCloseEvent *event)
         /* Yes */
         } else if( resBtn == QMessageBox::Yes ) {
 
-            /* Initialize YMLparser */
-            YMLParser parser;
+            /* Save YML (and binary sidecar) in background, window is closed once it is written */
+            this->closing.path = this->options.destinationYMLPath;
+            this->closing.validate = false;
+            this->saver->save( this->pano->rect_list, this->options.destinationYMLPath, this->options.sidecar );
 
-            /* Save YML */
-            parser.writeYML( this->pano->rect_list, this->options.destinationYMLPath );
-
-            /* Accept event */
-            event->accept();
+            /* Hide window meanwhile (shown again if save fails) */
+            this->hide();
+            event->ignore();
 
         /* No */
         } else if(resBtn == QMessageBox::No) {
 
+            /* Stop autosave and remove its snapshot */
+            this->autosave_timer->stop();
+            this->saver->remove( AnnotationSaver::autosavePath( this->options.destinationYMLPath ) );
+
             /* Accept event */
             event->accept();
         }
     }
 }
 
+/* Function to switch to specified session item (returns false if its panorama cannot be loaded) */
+bool MainWindow::openItem(int index)
+{
+    /* Get item */
+    validation_item_struct item = this->session.session->item( index );
+
+    /* Take prefetched panorama (loaded now if it was not prefetched) */
+    panorama_prefetch_struct panorama = this->session.prefetcher->take( item.image_path );
+
+    /* Check panorama */
+    if( panorama.cache == NULL )
+        return false;
+
+    /* Close views of previous panorama */
+    this->closeViews();
+
+    /* Assign item paths */
+    this->options.sourceImagePath = item.image_path;
+    this->options.detectorYMLPath = item.detector_yml_path;
+    this->options.destinationYMLPath = item.destination_yml_path;
+    this->session.created = !QFile::exists( item.destination_yml_path );
+
+    /* Info output */
+    std::cout << ( this->session.created ? "[Create]" : "[Edit]" ) << " Processing image " << ( index + 1 ) << " of " << this->session.session->count() << " (" << item.timestamp.toStdString() << ")" << std::endl;
+
+    if( !QFile::exists( item.detector_yml_path ) )
+    {
+        std::cout << "[ERROR] Invalid detector YML path: " << item.detector_yml_path.toStdString() << std::endl;
+    }
+
+    /* Replace objects and panorama */
+    this->pano->clearObjects();
+    this->pano->setPanorama( panorama );
+
+    /* Load objects */
+    this->loadObjects();
+
+    /* Snapshot loaded objects */
+    this->session.snapshot = AnnotationFile::serialize( this->pano->rect_list );
+
+    /* Start autosave of new destination */
+    this->startAutosave();
+
+    /* Show session progress */
+    this->setWindowTitle( QString("[%1/%2] %3").arg( index + 1 ).arg( this->session.session->count() ).arg( item.timestamp ) );
+
+    /* Prefetch next panorama */
+    if( index + 1 < this->session.session->count() )
+        this->session.prefetcher->prefetch( this->session.session->item( index + 1 ).image_path );
+
+    /* Refresh labels */
+    emit refreshLabels();
+
+    /* Return result */
+    return true;
+}
+
+/* Function to ask for saving current session item and mark it as validated (returns false if cancelled) */
+bool MainWindow::closeItem()
+{
+    /* Get current item */
+    validation_item_struct item = this->session.session->item( this->session.index );
+
+    /* Ask to save changes */
+    QMessageBox::StandardButton resBtn = QMessageBox::question( this, "",
+                                                                tr("Do you want to save your work\n(You can resume later)"),
+                                                                QMessageBox::Cancel | QMessageBox::No | QMessageBox::Yes,
+                                                                QMessageBox::Yes);
+    /* Cancel */
+    if( resBtn == QMessageBox::Cancel )
+        return false;
+
+    /* Snapshot objects */
+    QByteArray snapshot = AnnotationFile::serialize( this->pano->rect_list );
+    bool saved = ( resBtn == QMessageBox::Yes );
+
+    /* Determine if item is validated: created items once saved, edited items if changed, unchanged items on request */
+    bool validate = false;
+    if( this->session.created )
+    {
+        validate = saved;
+
+    } else if( saved && snapshot != this->session.snapshot ) {
+        validate = true;
+
+    } else {
+        validate = QMessageBox::question( this, "",
+                                          tr("No changes detected, do you want to mark this image as processed ?"),
+                                          QMessageBox::No | QMessageBox::Yes,
+                                          QMessageBox::No) == QMessageBox::Yes;
+    }
+
+    /* Save YML (and binary sidecar) in background, item is marked and advanced once it is written */
+    if( saved )
+    {
+        this->closing.path = item.destination_yml_path;
+        this->closing.validate = validate;
+        this->closing.timestamp = item.timestamp;
+        this->saver->save( snapshot, item.destination_yml_path, this->options.sidecar );
+        return true;
+    }
+
+    /* Stop autosave and remove its snapshot */
+    this->autosave_timer->stop();
+    this->saver->remove( AnnotationSaver::autosavePath( item.destination_yml_path ) );
+
+    /* Mark item */
+    if( validate )
+        this->session.session->markValidated( item.timestamp );
+
+    /* Return result */
+    return true;
+}
+
+/* Function to open next session item, unless session is quit (returns false if none was opened) */
+bool MainWindow::nextItem()
+{
+    /* Iterate over remaining items */
+    while( !this->session.quitting && ++this->session.index < this->session.session->count() )
+    {
+        /* Keep window open on next item */
+        if( this->openItem( this->session.index ) )
+            return true;
+    }
+
+    /* Return result */
+    return false;
+}
+
+/* Slot for completed background saves, completes pending close */
+void MainWindow::saveCompleted(QString path, bool success)
+{
+    /* Skip saves not completing a close (autosaves, removals) */
+    if( this->closing.path.isEmpty() || path != this->closing.path )
+        return;
+
+    /* Reset pending close */
+    this->closing.path.clear();
+    this->setEnabled( true );
+
+    /* Warn user and keep current panorama (autosave snapshot is kept) */
+    if( !success )
+    {
+        this->session.quitting = false;
+        this->show();
+        QMessageBox::warning( this, "", tr("Unable to save %1").arg( path ) );
+        return;
+    }
+
+    /* Stop autosave and remove its snapshot */
+    this->autosave_timer->stop();
+    this->saver->remove( AnnotationSaver::autosavePath( path ) );
+
+    /* Session mode */
+    if( this->session.session != NULL )
+    {
+        /* Mark saved item */
+        if( this->closing.validate )
+            this->session.session->markValidated( this->closing.timestamp );
+
+        /* Keep window open on next item */
+        if( this->nextItem() )
+            return;
+    }
+
+    /* Complete close */
+    this->closing.accepted = true;
+    this->close();
+}
+
+/* Function to close views referencing current panorama objects */
+void MainWindow::closeViews()
+{
+    /* Guard views (a view can own others) */
+    QList< QPointer<QMainWindow> > views;
+    foreach(QMainWindow* view, this->findChildren<QMainWindow*>())
+        views.append( view );
+
+    /* Close and delete views (thumbnails loaders are stopped before panorama is released) */
+    foreach(QPointer<QMainWindow> view, views)
+    {
+        if( !view.isNull() )
+        {
+            view->close();
+            delete view.data();
+        }
+    }
+}
+
+/* Autosave snapshot */
+void MainWindow::autosave()
+{
+    /* Snapshot objects */
+    QByteArray snapshot = AnnotationFile::serialize( this->pano->rect_list );
+
+    /* Skip unchanged objects */
+    if( snapshot == this->autosave_snapshot )
+        return;
+
+    /* Save snapshot in background */
+    this->autosave_snapshot = snapshot;
+    this->saver->save( snapshot, AnnotationSaver::autosavePath( this->options.destinationYMLPath ) );
+}
+
+/* Function to complete pending saves (application exit) */
+void MainWindow::finishSaves()
+{
+    /* Wait for pending saves */
+    this->saver->finish();
+}
+
 /* (Key signal) ESC key pressed */
 void MainWindow::onESC()
 {
@@ -533,6 +829,14 @@ void MainWindow::onESC()
     this->close();
 }
 
+/* (Key signal) CTRL+Q key pressed */
+void MainWindow::onQuit()
+{
+    /* Quit session after current item */
+    this->session.quitting = true;
+    this->close();
+}
+
 /* (UI component signal) Untyped button clicked */
 void MainWindow::on_untypedButton_clicked()
 {
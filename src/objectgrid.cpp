@@ -0,0 +1,460 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "objectgrid.h"
+
+/* Constructor */
+ObjectGrid::ObjectGrid(QWidget *parent) :
+    QAbstractScrollArea(parent)
+{
+    /* Default geometry */
+    this->cell_size = 160;
+    this->margin = 10;
+    this->spacing = 6;
+    this->border_size = 4;
+
+    /* Keep scaled thumbnails of a few screens */
+    this->pixmaps.setMaxCost( 1024 );
+
+    /* Load icons */
+    this->icon_face = QPixmap(":/resources/icons/Face.png");
+    this->icon_plate = QPixmap(":/resources/icons/Plate.png");
+    this->icon_blur = QPixmap(":/resources/icons/Blur.png");
+
+    /* Vertical scrolling only */
+    this->setHorizontalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
+    this->setVerticalScrollBarPolicy( Qt::ScrollBarAsNeeded );
+}
+
+/* Function to append an item (not owned), returns its index */
+int ObjectGrid::appendItem(ObjectItem* item)
+{
+    /* Append item and its states */
+    int index = this->items.size();
+    this->items.append( item );
+    this->selected.append( 0 );
+    this->shown.append( index );
+
+    /* Attach item */
+    item->setView( this, index );
+
+    /* Update view */
+    this->updateScrollBar();
+    this->viewport()->update();
+
+    /* Return index */
+    return index;
+}
+
+/* Function to get items count */
+int ObjectGrid::count()
+{
+    /* Return value */
+    return this->items.size();
+}
+
+/* Function to get a specified item */
+ObjectItem* ObjectGrid::item(int index)
+{
+    /* Return value */
+    return this->items.at(index);
+}
+
+/* Function to set cells size */
+void ObjectGrid::setCellSize(int size)
+{
+    /* Assign value */
+    this->cell_size = size;
+
+    /* Scaled thumbnails are obsolete */
+    this->pixmaps.clear();
+
+    /* Update view */
+    this->updateScrollBar();
+    this->viewport()->update();
+
+    /* Notify visible items change */
+    emit visibleItemsChanged();
+}
+
+/* Selection setter */
+void ObjectGrid::setSelected(int index, bool value)
+{
+    /* Assign value */
+    this->selected[index] = value;
+
+    /* Update view */
+    this->viewport()->update();
+}
+
+/* Selection getter */
+bool ObjectGrid::isSelected(int index)
+{
+    /* Return value */
+    return this->selected.at(index);
+}
+
+/* Select all items */
+void ObjectGrid::selectAll()
+{
+    /* Assign values */
+    this->selected.fill( 1 );
+
+    /* Update view */
+    this->viewport()->update();
+}
+
+/* Unselect all items */
+void ObjectGrid::unSelectAll()
+{
+    /* Assign values */
+    this->selected.fill( 0 );
+
+    /* Update view */
+    this->viewport()->update();
+}
+
+/* Invert items selection */
+void ObjectGrid::invertSelection()
+{
+    /* Invert values */
+    char *data = this->selected.data();
+    for (int i = 0; i < this->selected.size(); i++)
+        data[i] = !data[i];
+
+    /* Update view */
+    this->viewport()->update();
+}
+
+/* Function to get number of columns */
+int ObjectGrid::columns()
+{
+    /* Return result */
+    return qMax( 1, (this->viewport()->width() - (2 * this->margin) + this->spacing) / (this->cell_size + this->spacing) );
+}
+
+/* Function to get the range of displayed positions on screen */
+void ObjectGrid::visibleRange(int &first, int &last)
+{
+    /* Determine visible rows */
+    int step = this->cell_size + this->spacing;
+    int offset = this->verticalScrollBar()->value();
+    int first_row = qMax( 0, (offset - this->margin) / step );
+    int last_row = (offset + this->viewport()->height() - this->margin) / step;
+
+    /* Convert rows to positions */
+    int cols = this->columns();
+    first = first_row * cols;
+    last = qMin( this->shown.size(), (last_row + 1) * cols );
+}
+
+/* Function to get indexes of items currently on screen */
+QList<int> ObjectGrid::visibleItems()
+{
+    /* Result list */
+    QList<int> result;
+
+    /* Collect items of visible rows */
+    int first, last;
+    this->visibleRange( first, last );
+    for (int i = first; i < last; i++)
+        result.append( this->shown.at(i) );
+
+    /* Return result */
+    return result;
+}
+
+/* Function to get displayed item at a viewport position, -1 if none */
+int ObjectGrid::itemAt(QPoint pos)
+{
+    /* Position in content coordinates */
+    int x = pos.x() - this->margin;
+    int y = pos.y() + this->verticalScrollBar()->value() - this->margin;
+    if( x < 0 || y < 0 )
+        return -1;
+
+    /* Determine cell */
+    int step = this->cell_size + this->spacing;
+    int col = x / step;
+    int row = y / step;
+
+    /* Ignore spacing and out of grid positions */
+    if( (x % step) >= this->cell_size || (y % step) >= this->cell_size || col >= this->columns() )
+        return -1;
+
+    /* Return item index */
+    int position = (row * this->columns()) + col;
+    return position < this->shown.size() ? this->shown.at(position) : -1;
+}
+
+/* Function called by items on change */
+void ObjectGrid::itemChanged(int index, bool layout)
+{
+    /* Drop scaled thumbnail */
+    this->pixmaps.remove( index );
+
+    /* Rebuild displayed items on layout change */
+    if( layout )
+    {
+        this->updateShown();
+        emit visibleItemsChanged();
+    }
+
+    /* Update view */
+    this->viewport()->update();
+}
+
+/* Function to rebuild displayed items list */
+void ObjectGrid::updateShown()
+{
+    /* Collect non removed items */
+    this->shown.clear();
+    for (int i = 0; i < this->items.size(); i++)
+    {
+        if( !this->items.at(i)->toBeRemoved() )
+            this->shown.append( i );
+    }
+
+    /* Scaled thumbnails are keyed by item, positions changed only */
+    this->updateScrollBar();
+}
+
+/* Function to update scroll bar range */
+void ObjectGrid::updateScrollBar()
+{
+    /* Compute content height */
+    int step = this->cell_size + this->spacing;
+    int rows = (this->shown.size() + this->columns() - 1) / this->columns();
+    int height = (2 * this->margin) + (rows * step) - this->spacing;
+
+    /* Update range */
+    this->verticalScrollBar()->setRange( 0, qMax( 0, height - this->viewport()->height() ) );
+    this->verticalScrollBar()->setPageStep( this->viewport()->height() );
+    this->verticalScrollBar()->setSingleStep( qMax( 1, step / 4 ) );
+}
+
+/* Paint event */
+void ObjectGrid::paintEvent(QPaintEvent *)
+{
+    /* Create painter on viewport */
+    QPainter painter( this->viewport() );
+
+    /* Paint visible cells only */
+    int step = this->cell_size + this->spacing;
+    int cols = this->columns();
+    int offset = this->verticalScrollBar()->value();
+    int first, last;
+    this->visibleRange( first, last );
+    for (int position = first; position < last; position++)
+    {
+        /* Determine cell geometry */
+        QRect cell( this->margin + ((position % cols) * step),
+                    this->margin + ((position / cols) * step) - offset,
+                    this->cell_size,
+                    this->cell_size );
+
+        /* Paint cell */
+        this->paintCell( painter, cell, this->shown.at(position) );
+    }
+}
+
+/* Function to paint a cell */
+void ObjectGrid::paintCell(QPainter &painter, QRect cell, int index)
+{
+    /* Get item */
+    ObjectItem* item = this->items.at(index);
+
+    /* Image area inside border */
+    QRect inner = cell.adjusted( this->border_size, this->border_size, -this->border_size, -this->border_size );
+
+    /* Determine image area keeping aspect */
+    QImage image = item->getImage();
+    QSize aspect = image.isNull() ? item->getPlaceholder() : image.size();
+    QSize fitted = aspect.isEmpty() ? inner.size() : aspect.scaled( inner.size(), Qt::KeepAspectRatio );
+    QRect area( inner.x() + ((inner.width() - fitted.width()) / 2),
+                inner.y() + ((inner.height() - fitted.height()) / 2),
+                fitted.width(),
+                fitted.height() );
+
+    /* Draw image or placeholder */
+    if( image.isNull() )
+    {
+        painter.fillRect( area, Qt::darkGray );
+    } else {
+
+        /* Get or build scaled thumbnail */
+        QPixmap *pixmap = this->pixmaps.object( index );
+        if( pixmap == NULL || pixmap->size() != area.size() )
+        {
+            pixmap = new QPixmap( QPixmap::fromImage( image.scaled( area.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation ) ) );
+            this->pixmaps.insert( index, pixmap );
+        }
+
+        /* Draw thumbnail */
+        painter.drawPixmap( area.topLeft(), *pixmap );
+    }
+
+    /* Draw manual state overlay */
+    switch( item->getItemManualState() )
+    {
+    case ObjectManualState::Valid:
+        painter.fillRect( area, QColor(0, 255, 0, 50) );
+        break;
+    case ObjectManualState::Invalid:
+        painter.fillRect( area, QColor(255, 0, 0, 50) );
+        break;
+    case ObjectManualState::None:
+        painter.fillRect( area, QColor(0, 0, 0, 50) );
+        break;
+    case ObjectManualState::ToBlur:
+        painter.fillRect( area, QColor(255, 255, 0, 50) );
+        break;
+    }
+
+    /* Determine border color from automatic state */
+    QColor border;
+    switch( item->getItemAutomaticState() )
+    {
+    case ObjectAutomaticState::Valid:
+        border = QColor(0, 255, 0);
+        break;
+    case ObjectAutomaticState::Invalid:
+        border = QColor(255, 0, 0);
+        break;
+    default:
+        border = QColor(0, 255, 255);
+        break;
+    }
+
+    /* Draw border */
+    QPen pen( border );
+    pen.setWidth( this->border_size );
+    pen.setJoinStyle( Qt::MiterJoin );
+    painter.setPen( pen );
+    painter.setBrush( Qt::NoBrush );
+    painter.drawRect( cell.adjusted( this->border_size / 2, this->border_size / 2, -(this->border_size / 2), -(this->border_size / 2) ) );
+
+    /* Draw selection overlay */
+    if( this->selected.at(index) )
+        painter.fillRect( cell, QColor(255, 255, 0, 50) );
+
+    /* Icons size */
+    int icon = this->cell_size / 8;
+
+    /* Draw type icon */
+    switch( item->getItemType() )
+    {
+    case ObjectType::Face:
+        painter.drawPixmap( QRect( cell.x() + this->border_size, cell.y() + this->border_size, icon, icon ), this->icon_face );
+        break;
+    case ObjectType::NumberPlate:
+        painter.drawPixmap( QRect( cell.x() + this->border_size, cell.y() + this->border_size, icon, icon ), this->icon_plate );
+        break;
+    case ObjectType::ToBlur:
+        painter.drawPixmap( QRect( cell.x() + this->border_size, cell.y() + this->border_size, icon, icon ), this->icon_blur );
+        break;
+    }
+
+    /* Draw blur icon */
+    if( item->isBlurred() )
+        painter.drawPixmap( QRect( cell.right() - this->border_size - icon, cell.bottom() - this->border_size - icon, icon, icon ), this->icon_blur );
+}
+
+/* Resize event */
+void ObjectGrid::resizeEvent(QResizeEvent *event)
+{
+    /* Default handling */
+    QAbstractScrollArea::resizeEvent( event );
+
+    /* Columns may have changed */
+    this->updateScrollBar();
+
+    /* Notify visible items change */
+    emit visibleItemsChanged();
+}
+
+/* Scroll handler */
+void ObjectGrid::scrollContentsBy(int, int)
+{
+    /* Repaint visible cells */
+    this->viewport()->update();
+
+    /* Notify visible items change */
+    emit visibleItemsChanged();
+}
+
+/* Mouse press event */
+void ObjectGrid::mousePressEvent(QMouseEvent *event)
+{
+    /* Check presence of left click */
+    if( event->buttons() & Qt::LeftButton )
+    {
+        /* Toggle item selected flag */
+        int index = this->itemAt( event->pos() );
+        if( index >= 0 )
+            this->setSelected( index, !this->selected.at(index) );
+    }
+}
+
+/* Mouse double click event */
+void ObjectGrid::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    /* Check presence of right click */
+    if( event->buttons() & Qt::RightButton )
+    {
+        /* Request item edition */
+        int index = this->itemAt( event->pos() );
+        if( index >= 0 )
+            emit editRequested( index );
+    }
+}
+
+/* Mouse wheel event */
+void ObjectGrid::wheelEvent(QWheelEvent *event)
+{
+    /* Leave CTRL + wheel to parent (cells zoom) */
+    if( event->modifiers() & Qt::ControlModifier )
+    {
+        event->ignore();
+        return;
+    }
+
+    /* Default scrolling */
+    QAbstractScrollArea::wheelEvent( event );
+}
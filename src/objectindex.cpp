@@ -0,0 +1,291 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "objectindex.h"
+
+/* Constructor */
+ObjectIndex::ObjectIndex()
+{
+    /* Allocate grid */
+    this->cells.resize( OBJECT_INDEX_LON_CELLS * OBJECT_INDEX_LAT_CELLS );
+
+    /* Empty index */
+    this->max_radius = 0.0;
+    this->count = 0;
+    this->valid = false;
+}
+
+/* Function to force index rebuild on next query */
+void ObjectIndex::invalidate()
+{
+    /* Invalidate index */
+    this->valid = false;
+}
+
+/* Function to get cell index of a direction */
+int ObjectIndex::cell(int lon, int lat)
+{
+    /* Wrap longitude */
+    lon = ( ( lon % OBJECT_INDEX_LON_CELLS ) + OBJECT_INDEX_LON_CELLS ) % OBJECT_INDEX_LON_CELLS;
+
+    /* Return result */
+    return lat * OBJECT_INDEX_LON_CELLS + lon;
+}
+
+/* Function to insert an object in its center cell */
+void ObjectIndex::insert(ObjectRect* rect)
+{
+    /* Object rotation and pixel size */
+    double m[3][3];
+    lg_algebra_r2erotation( m, rect->proj_azimuth(), rect->proj_elevation(), 0 );
+    double r_pixel = 2.0 * tan( rect->proj_aperture() / 2.0 ) / rect->proj_width();
+
+    /* Object corners */
+    QPointF corners[4] = { rect->proj_point_1(), rect->proj_point_2(), rect->proj_point_3(), rect->proj_point_4() };
+
+    /* Corners directions and their mean */
+    double d[4][3];
+    double c[3] = { 0.0, 0.0, 0.0 };
+
+    /* Iterate over corners */
+    for (int i = 0; i < 4; i++)
+    {
+        /* Position in object rectilinear frame */
+        double u = ( corners[i].x() - ( rect->proj_width()  / 2.0 ) ) * r_pixel;
+        double v = ( corners[i].y() - ( rect->proj_height() / 2.0 ) ) * r_pixel;
+
+        /* Apply rotation on position */
+        double px = m[0][0] + m[0][1] * u + m[0][2] * v;
+        double py = m[1][0] + m[1][1] * u + m[1][2] * v;
+        double pz = m[2][0] + m[2][1] * u + m[2][2] * v;
+
+        /* Normalize direction */
+        double n = sqrt( px * px + py * py + pz * pz );
+        d[i][0] = px / n;
+        d[i][1] = py / n;
+        d[i][2] = pz / n;
+
+        /* Accumulate mean */
+        c[0] += d[i][0];
+        c[1] += d[i][1];
+        c[2] += d[i][2];
+    }
+
+    /* Normalize center direction */
+    double n = sqrt( c[0] * c[0] + c[1] * c[1] + c[2] * c[2] );
+
+    /* Objects without valid direction are always tested */
+    if( !qIsFinite( n ) || n <= 0.0 )
+    {
+        this->unbounded.append( rect );
+        this->locations.insert( rect, -1 );
+        return;
+    }
+
+    /* Indexed object */
+    object_index_entry_struct entry;
+    entry.rect = rect;
+    entry.x = c[0] / n;
+    entry.y = c[1] / n;
+    entry.z = c[2] / n;
+    entry.radius = 0.0;
+
+    /* Angular radius (largest corner distance to center) */
+    for (int i = 0; i < 4; i++)
+    {
+        double dot = qBound( -1.0, entry.x * d[i][0] + entry.y * d[i][1] + entry.z * d[i][2], 1.0 );
+        entry.radius = qMax( entry.radius, acos( dot ) );
+    }
+
+    /* Update largest radius */
+    this->max_radius = qMax( this->max_radius, entry.radius );
+
+    /* Center cell */
+    double lon = atan2( entry.y, entry.x );
+    double lat = asin( qBound( -1.0, entry.z, 1.0 ) );
+    int lon_cell = (int) floor( ( lon + LG_PI ) / LG_PI2 * OBJECT_INDEX_LON_CELLS );
+    int lat_cell = qBound( 0, (int) floor( ( lat + ( LG_PI / 2.0 ) ) / LG_PI * OBJECT_INDEX_LAT_CELLS ), OBJECT_INDEX_LAT_CELLS - 1 );
+
+    /* Insert object */
+    int index = this->cell( lon_cell, lat_cell );
+    this->cells[ index ].append( entry );
+    this->locations.insert( rect, index );
+}
+
+/* Function to re-bucket a single reprojected object */
+void ObjectIndex::update(ObjectRect* rect)
+{
+    /* Index is rebuilt anyway on next query */
+    if( !this->valid )
+        return;
+
+    /* Unknown objects require a rebuild */
+    QHash<ObjectRect*, int>::iterator location = this->locations.find( rect );
+    if( location == this->locations.end() )
+    {
+        this->invalidate();
+        return;
+    }
+
+    /* Remove object from its previous cell */
+    if( location.value() < 0 )
+    {
+        this->unbounded.removeOne( rect );
+    } else {
+        QVector<object_index_entry_struct> &entries = this->cells[ location.value() ];
+        for (int i = 0; i < entries.size(); i++)
+        {
+            if( entries.at(i).rect == rect )
+            {
+                entries.remove( i );
+                break;
+            }
+        }
+    }
+    this->locations.erase( location );
+
+    /* Insert object in its new cell (largest radius only grows, queries stay conservative) */
+    this->insert( rect );
+}
+
+/* Function to build index */
+void ObjectIndex::build(const QList<ObjectRect*> &rects)
+{
+    /* Clear grid */
+    for (int i = 0; i < this->cells.size(); i++)
+    {
+        this->cells[i].clear();
+    }
+    this->unbounded.clear();
+    this->locations.clear();
+    this->max_radius = 0.0;
+
+    /* Iterate over objects */
+    foreach(ObjectRect* rect, rects)
+    {
+        /* Insert object */
+        this->insert( rect );
+    }
+
+    /* Save index state */
+    this->count = rects.size();
+    this->valid = true;
+}
+
+/* Function to get objects that may be seen in a view, returns true if the index was rebuilt */
+bool ObjectIndex::query(const QList<ObjectRect*> &rects,
+                        float width,
+                        float height,
+                        float azimuth,
+                        float elevation,
+                        float aperture,
+                        QList<ObjectRect*> &candidates)
+{
+    /* Rebuild index if objects changed */
+    bool rebuilt = false;
+    if( !this->valid || this->count != rects.size() )
+    {
+        this->build( rects );
+        rebuilt = true;
+    }
+
+    /* Clear candidates */
+    candidates = this->unbounded;
+
+    /* View direction */
+    double m[3][3];
+    lg_algebra_r2erotation( m, azimuth, elevation, 0 );
+    double vx = m[0][0];
+    double vy = m[1][0];
+    double vz = m[2][0];
+
+    /* View angular radius (half diagonal) */
+    double c_pixel = 2.0 * tan( aperture / 2.0 ) / width;
+    double view_radius = atan( sqrt( width * width + height * height ) / 2.0 * c_pixel );
+
+    /* Search radius around view direction */
+    double radius = view_radius + this->max_radius + 0.01;
+
+    /* Latitude range */
+    double lat = asin( qBound( -1.0, vz, 1.0 ) );
+    double lon = atan2( vy, vx );
+    int lat_min = qBound( 0, (int) floor( ( lat - radius + ( LG_PI / 2.0 ) ) / LG_PI * OBJECT_INDEX_LAT_CELLS ), OBJECT_INDEX_LAT_CELLS - 1 );
+    int lat_max = qBound( 0, (int) floor( ( lat + radius + ( LG_PI / 2.0 ) ) / LG_PI * OBJECT_INDEX_LAT_CELLS ), OBJECT_INDEX_LAT_CELLS - 1 );
+
+    /* Longitude range (whole circle if a pole is in range) */
+    int lon_min = 0;
+    int lon_max = OBJECT_INDEX_LON_CELLS - 1;
+    if( radius < LG_PI / 2.0 && qAbs( lat ) + radius < LG_PI / 2.0 )
+    {
+        /* Longitude half width of the spherical cap */
+        double dlon = asin( qMin( 1.0, sin( radius ) / cos( lat ) ) );
+
+        /* Longitude cells range */
+        lon_min = (int) floor( ( lon - dlon + LG_PI ) / LG_PI2 * OBJECT_INDEX_LON_CELLS );
+        lon_max = (int) floor( ( lon + dlon + LG_PI ) / LG_PI2 * OBJECT_INDEX_LON_CELLS );
+        lon_max = qMin( lon_max, lon_min + OBJECT_INDEX_LON_CELLS - 1 );
+    }
+
+    /* Iterate over cells in range */
+    for (int lat_cell = lat_min; lat_cell <= lat_max; lat_cell++)
+    {
+        for (int lon_cell = lon_min; lon_cell <= lon_max; lon_cell++)
+        {
+            /* Get cell objects */
+            const QVector<object_index_entry_struct> &entries = this->cells.at( this->cell( lon_cell, lat_cell ) );
+
+            /* Iterate over cell objects */
+            for (int i = 0; i < entries.size(); i++)
+            {
+                /* Get object */
+                const object_index_entry_struct &entry = entries.at(i);
+
+                /* Keep objects whose bounding cap overlaps the view */
+                double limit = view_radius + entry.radius + 0.01;
+                if( limit >= LG_PI || ( entry.x * vx + entry.y * vy + entry.z * vz ) >= cos( limit ) )
+                {
+                    candidates.append( entry.rect );
+                }
+            }
+        }
+    }
+
+    /* Return result */
+    return rebuilt;
+}
@@ -38,62 +38,18 @@
 
 /* Includes */
 #include "objectitem.h"
-#include "ui_objectitem.h"
-#include "editview.h"
+#include "objectgrid.h"
 
-/* Constructor 1 */
-ObjectItem::ObjectItem(QWidget *parent) :
-    QWidget(parent),
-    ui(new Ui::ObjectItem)
+/* Constructor */
+ObjectItem::ObjectItem(ObjectRect* rect)
 {
-    ui->setupUi(this);
-
-    /* Configure default tile size */
-    this->setSize(QSize(128, 128));
-
-    /* Center image alignement */
-    this->ui->imageLabel->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-
-    /* Default values initialisation */
-    this->manualStatus = "None";
-    this->autoStatus = "None";
-    this->border_size = 4;
-    this->needs_removal = false;
-
-    /* Load blur label image */
-    this->ui->blurLabel->setPixmap( QPixmap(":/resources/icons/Blur.png") );
-
-    /* Set as unselected by default */
-    this->setSelected(false);
-}
-
-/* Constructor 2 */
-ObjectItem::ObjectItem(QWidget *parent, PanoramaViewer* pano, ObjectRect* rect) :
-    QWidget(parent),
-    ui(new Ui::ObjectItem)
-{
-    ui->setupUi(this);
-
-    /* Configure default tile size */
-    this->setSize(QSize(128, 128));
-
-    /* Center image alignement */
-    this->ui->imageLabel->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-
     /* Default values initialisation */
-    this->manualStatus = "None";
-    this->autoStatus = "None";
-    this->border_size = 4;
+    this->manualStatus = ObjectManualStatus::None;
+    this->autoStatus = ObjectAutomaticStatus::None;
     this->needs_removal = false;
-
-    /* Set as unselected by default */
-    this->setSelected(false);
-
-    /* Load blur label image */
-    this->ui->blurLabel->setPixmap( QPixmap(":/resources/icons/Blur.png") );
-
-    /* Assign parent PanoramaViewer */
-    this->setPano( pano );
+    this->valid = false;
+    this->view = NULL;
+    this->view_index = -1;
 
     /* Assign parent ObjectRect */
     this->setParentRect( rect );
@@ -104,71 +60,40 @@ ObjectItem::~ObjectItem()
 {
     /* Delete copied rect */
     delete this->parent_rect_copy;
-
-    /* Delete main UI */
-    delete ui;
 }
 
 /* Set source image */
-bool ObjectItem::setImage(QImage image)
+void ObjectItem::setImage(QImage image)
 {
     /* Assign value */
     this->image = image;
 
-    /* Convert source QImage to QPixmap */
-    QPixmap pixmap = QPixmap::fromImage(image);
-
-    /* Exit if pixmap is null */
-    if (pixmap.isNull()) return false;
-
-    /* Retrieve width/height of source image */
-    int source_w = pixmap.width();
-    int source_h = pixmap.height();
-
-    /* Clamp to maximum width */
-    if(source_w < this->maximumWidth())
-        source_w = this->maximumWidth();
-
-    /* Clamp to maximum height */
-    if(source_h < this->maximumHeight())
-        source_h = this->maximumHeight();
-
-    /* Get the smallest possible sizes */
-    int min_w = std::min(source_w, this->maximumWidth());
-    int min_h = std::min(source_h, this->maximumHeight());
-
-    /* Scale pixmap to size */
-    pixmap = pixmap.scaled(QSize(min_w, min_h), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-
-    /* Display tile */
-    this->ui->imageLabel->setPixmap(pixmap);
-
-    /* Variables for contour/frame sizes correction */
-    int corr_pixmap_w = pixmap.width();
-    int corr_pixmap_h = pixmap.height();
-
-    /* Clamp border width to fit perfectly */
-    if(corr_pixmap_w >= (this->width() - this->border_size))
-    {
-        corr_pixmap_w = corr_pixmap_w - (this->border_size * 2);
-    }
+    /* Notify view */
+    this->changed();
+}
 
-    /* Clamp border height to fit perfectly */
-    if(corr_pixmap_h >= (this->height() - this->border_size))
-    {
-        corr_pixmap_h = corr_pixmap_h - (this->border_size * 2);
-    }
+/* Source image getter */
+QImage ObjectItem::getImage()
+{
+    /* Return value */
+    return this->image;
+}
 
-    /* Resize valid frame */
-    this->ui->validFrame->resize(corr_pixmap_w, corr_pixmap_h);
+/* Set placeholder aspect (displayed until an image is set) */
+void ObjectItem::setPlaceholder(QSize size)
+{
+    /* Assign value */
+    this->placeholder = size;
 
-    /* Move valid frame */
-    float pos_x = (this->width() - corr_pixmap_w) / 2;
-    float pos_y = (this->height() - corr_pixmap_h) / 2;
-    this->ui->validFrame->move(pos_x, pos_y);
+    /* Notify view */
+    this->changed();
+}
 
-    /* Success */
-    return true;
+/* Placeholder aspect getter */
+QSize ObjectItem::getPlaceholder()
+{
+    /* Return value */
+    return this->placeholder;
 }
 
 /* ID setter */
@@ -185,72 +110,17 @@ int ObjectItem::getId()
     return this->id;
 }
 
-/* Function to resize tile */
-void ObjectItem::setSize(QSize size)
-{
-    /* Assign minimal/maximal sizes to ObjectItem */
-    this->setMinimumSize(size);
-    this->setMaximumSize(size);
-
-    /* Assign minimal/maximal sizes to image */
-    this->ui->imageLabel->setMinimumSize(size);
-    this->ui->imageLabel->setMaximumSize(size);
-
-    /* Assign minimal/maximal sizes to selection frame */
-    this->ui->selectFrame->setMinimumSize(size);
-    this->ui->selectFrame->setMaximumSize(size);
-
-    /* Label size corrections */
-    int label_w = size.width() / 8;
-    int label_h = size.width() / 8;
-
-    /* Assign minimal/maximal sizes to blur label */
-    this->ui->blurLabel->setMinimumSize(label_w, label_h);
-    this->ui->blurLabel->setMaximumSize(label_w, label_h);
-
-    /* Resize blur label */
-    this->ui->blurLabel->resize(label_w, label_h);
-
-    /* Assign minimal/maximal sizes to type label */
-    this->ui->typeLabel->setMinimumSize(label_w, label_h);
-    this->ui->typeLabel->setMaximumSize(label_w, label_h);
-
-    /* Resize type label */
-    this->ui->typeLabel->resize(label_w, label_h);
-
-    /* Move type label */
-    this->ui->typeLabel->move(0 + this->border_size, 0 + this->border_size);
-
-    /* Move blur label */
-    this->ui->blurLabel->move((size.width() - this->ui->blurLabel->width()) - this->border_size,
-                              (size.height() - this->ui->blurLabel->height()) - this->border_size);
-
-    /* Update tile image */
-    this->setImage(this->image);
-}
-
 /* Function to set item type */
 void ObjectItem::setItemType(int type)
 {
     /* Assign value */
     this->item_type = type;
 
-    /* Assign proper type label image */
-    switch(type)
-    {
-    case ObjectType::Face:
-        this->ui->typeLabel->setPixmap( QPixmap(":/resources/icons/Face.png") );
-        break;
-    case ObjectType::NumberPlate:
-        this->ui->typeLabel->setPixmap( QPixmap(":/resources/icons/Plate.png") );
-        break;
-    case ObjectType::ToBlur:
-        this->ui->typeLabel->setPixmap( QPixmap(":/resources/icons/Blur.png") );
-        break;
-    }
-
     /* Update parent rect type */
     this->parent_rect_copy->setObjectType( type );
+
+    /* Notify view */
+    this->changed();
 }
 
 /* Item type getter */
@@ -283,19 +153,11 @@ void ObjectItem::setBlurred(bool value)
     /* Assign value */
     this->blurred = value;
 
-    /* Check input value */
-    if(value)
-    {
-        /* Show blur label */
-        this->ui->blurLabel->show();
-    } else {
-
-        /* Hide blur label */
-        this->ui->blurLabel->hide();
-    }
-
     /* Update parent rect blurred flag */
     this->parent_rect_copy->setBlurred( value );
+
+    /* Notify view */
+    this->changed();
 }
 
 /* Blurred flag getter */
@@ -305,39 +167,17 @@ bool ObjectItem::isBlurred()
     return this->blurred;
 }
 
-void ObjectItem::setSelected(bool value)
-{
-    /* Assign value */
-    this->selected = value;
-
-    /* Check input value */
-    if(value)
-    {
-        /* Apply selected color (yellow) */
-        this->ui->selectFrame->setStyleSheet("QFrame#selectFrame {background-color :  rgba(255, 255, 0, 50);}");
-    } else {
-
-        /* Apply no colors */
-        this->ui->selectFrame->setStyleSheet("QFrame#selectFrame {background-color :  rgba(0, 0, 0, 0);}");
-    }
-}
-
-/* Selected flag getter */
-bool ObjectItem::isSelected()
-{
-    /* Return value */
-    return this->selected;
-}
-
 /* Function to assign a parent ObjectRect to item */
 void ObjectItem::setParentRect(ObjectRect *src_rect)
 {
+    /* Trace zone */
+    TraceZone zone( "ObjectItem::setParentRect" );
+
     /* Copy input ObjectRect to local parent_rect_copy variable */
     this->parent_rect_copy = src_rect->copy();
 
-    /* Update item using parent rect values */
+    /* Update item using parent rect values (image is assigned asynchronously) */
     this->setId( src_rect->getId() );
-    this->setImage( this->parent_pano->cropObject( src_rect ) );
     this->setItemType( src_rect->getObjectType() );
     this->setItemSubType( src_rect->getObjectSubType() );
     this->setBlurred( src_rect->isBlurred() );
@@ -346,10 +186,10 @@ void ObjectItem::setParentRect(ObjectRect *src_rect)
     this->setAutomaticStatus( src_rect->getAutomaticStatus() );
 
     /* If object has an automatic status */
-    if(src_rect->getAutomaticStatus() != "None")
+    if(src_rect->getAutomaticStatus() != ObjectAutomaticStatus::None)
     {
         /* If automatic status is valid */
-        if(src_rect->getAutomaticStatus() == "Valid")
+        if(src_rect->getAutomaticStatus() == ObjectAutomaticStatus::Valid)
         {
             /* Set automatic state to valid */
             this->setItemAutomaticState(ObjectAutomaticState::Valid);
@@ -372,11 +212,12 @@ ObjectRect* ObjectItem::getParentRect()
     return this->parent_rect_copy;
 }
 
-/* Function to assign parent PanoramaViewer */
-void ObjectItem::setPano(PanoramaViewer *pano)
+/* Function to attach item to its view */
+void ObjectItem::setView(ObjectGrid* view, int index)
 {
-    /* Assign value */
-    this->parent_pano = pano;
+    /* Assign values */
+    this->view = view;
+    this->view_index = index;
 }
 
 /* Function to remove item */
@@ -385,11 +226,8 @@ void ObjectItem::remove(bool value)
     /* Assign flag */
     this->needs_removal = value;
 
-    /* Hide item */
-    this->setVisible( !value );
-
-    /* Disable item */
-    this->setEnabled( !value );
+    /* Notify view (item is hidden) */
+    this->changed( true );
 }
 
 /* Function to set item manual state */
@@ -398,45 +236,21 @@ void ObjectItem::setItemManualState(int state)
     /* Assign value */
     this->manual_state = state;
 
-    /* Assign proper validation frame color based on input state */
-    switch(state)
-    {
-    case ObjectManualState::Valid:
-
-        /* Set validation frame color to green */
-        this->ui->validFrame->setStyleSheet("background-color: rgba(0, 255, 0, 50);");
-
-        /* Mark object as valid */
-        this->valid = true;
-        break;
-    case ObjectManualState::Invalid:
-
-        /* Set validation frame color to red */
-        this->ui->validFrame->setStyleSheet("background-color: rgba(255, 0, 0, 50);");
-
-        /* Mark object as invalid */
-        this->valid = false;
-        break;
-    case ObjectManualState::None:
-
-        /* Set validation frame color to none */
-        this->ui->validFrame->setStyleSheet("background-color: rgba(0, 0, 0, 50);");
-
-        /* Mark object as invalid */
-        this->valid = false;
-        break;
-    case ObjectManualState::ToBlur:
-
-        /* Set validation frame color to yellow */
-        this->ui->validFrame->setStyleSheet("background-color: rgba(255, 255, 0, 50);");
-
-        /* Mark object as invalid */
-        this->valid = false;
-        break;
-    }
+    /* Only validated objects are valid */
+    this->valid = ( state == ObjectManualState::Valid );
 
     /* Update parent rect manual state */
     this->parent_rect_copy->setObjectManualState( state );
+
+    /* Notify view */
+    this->changed();
+}
+
+/* Manual state getter */
+int ObjectItem::getItemManualState()
+{
+    /* Return value */
+    return this->manual_state;
 }
 
 /* Function to set item automatic state */
@@ -445,41 +259,19 @@ void ObjectItem::setItemAutomaticState(int state)
     /* Assign value */
     this->automatic_state = state;
 
-    /* Assign proper border color based on input state */
-    switch(state)
-    {
-    case ObjectAutomaticState::Valid:
-
-        /* Set border color to green */
-        this->setStyleSheet(
-            "QLabel#imageLabel{"
-            "border: " + QString::number(this->border_size) + "px solid rgb(0, 255, 0);"
-            "}"
-        );
-        break;
-    case ObjectAutomaticState::Invalid:
-
-         /* Set border color to red */
-        this->setStyleSheet(
-            "QLabel#imageLabel{"
-            "border: " + QString::number(this->border_size) + "px solid rgb(255, 0, 0);"
-            "}"
-        );
-        break;
-    case ObjectAutomaticState::Manual:
-
-         /* Set border color to light blue */
-        this->setStyleSheet(
-            "QLabel#imageLabel{"
-            "border: " + QString::number(this->border_size) + "px solid rgb(0, 255, 255);"
-            "}"
-        );
-        break;
-    }
+    /* Notify view */
+    this->changed();
+}
+
+/* Automatic state getter */
+int ObjectItem::getItemAutomaticState()
+{
+    /* Return value */
+    return this->automatic_state;
 }
 
 /* Function to set automatic status value */
-void ObjectItem::setAutomaticStatus(QString value)
+void ObjectItem::setAutomaticStatus(int value)
 {
     /* Assign value */
     this->autoStatus = value;
@@ -489,14 +281,14 @@ void ObjectItem::setAutomaticStatus(QString value)
 }
 
 /* Automatic status getter */
-QString ObjectItem::getAutomaticStatus()
+int ObjectItem::getAutomaticStatus()
 {
     /* Return value */
     return this->autoStatus;
 }
 
 /* Function to set manual status value */
-void ObjectItem::setManualStatus(QString value)
+void ObjectItem::setManualStatus(int value)
 {
     /* Assign value */
     this->manualStatus = value;
@@ -506,7 +298,7 @@ void ObjectItem::setManualStatus(QString value)
 }
 
 /* Manual status getter */
-QString ObjectItem::getManualStatus()
+int ObjectItem::getManualStatus()
 {
     /* Return value */
     return this->manualStatus;
@@ -526,26 +318,10 @@ bool ObjectItem::toBeRemoved()
     return this->needs_removal;
 }
 
-/* Mouse press event */
-void ObjectItem::mousePressEvent(QMouseEvent* event) {
-
-    /* Check presence of left click */
-    if(event->buttons() & Qt::LeftButton)
-    {
-        /* Toggle item selected flag */
-        this->setSelected(!this->selected);
-    }
-}
-
-/* Mouse double click event */
-void ObjectItem::mouseDoubleClickEvent(QMouseEvent *event)
+/* Function to notify view of a change */
+void ObjectItem::changed(bool layout)
 {
-    /* Check presence of right click */
-    if(event->buttons() & Qt::RightButton)
-    {
-        /* Create and show a new edition window */
-        EditView* w = new EditView(this->parent_pano, this->parent_rect_copy, this->parent_pano->image_info, this, EditMode::Single);
-        w->setAttribute( Qt::WA_DeleteOnClose );
-        w->show();
-    }
+    /* Notify attached view */
+    if( this->view != NULL )
+        this->view->itemChanged( this->view_index, layout );
 }
@@ -37,10 +37,16 @@
  */
 
 #include "objectrect.h"
+#include "objectstats.h"
+#include "objectindex.h"
 
 /* Constructor */
 ObjectRect::ObjectRect()
 {
+    /* Not counted, not indexed */
+    this->stats = NULL;
+    this->index = NULL;
+
     /* Append default points */
     this->points.append(QPointF(0.0, 0.0));
     this->points.append(QPointF(0.0, 0.0));
@@ -69,8 +75,8 @@ ObjectRect::ObjectRect()
     this->projection_parameters.points.append(QPointF(0.0, 0.0));
 
     /* Default informations */
-    this->info.automatic_status = "None";
-    this->info.manual_status = "None";
+    this->info.automatic_status = ObjectAutomaticStatus::None;
+    this->info.manual_status = ObjectManualStatus::None;
     this->info.blurred = false;
     this->info.validated = false;
     this->info.type = ObjectType::None;
@@ -556,6 +562,44 @@ void ObjectRect::render()
     this->contour2->setPen( *this->contour2_pen );
 }
 
+/* Destructor */
+ObjectRect::~ObjectRect()
+{
+    /* Uncount and unindex object */
+    this->setStatistics( NULL );
+    this->setIndex( NULL );
+}
+
+/* Function to attach object to a statistics model (counted while attached) */
+void ObjectRect::setStatistics(ObjectStats* stats)
+{
+    /* Uncount object from previous model */
+    if( this->stats )
+        this->stats->remove( this );
+
+    /* Assign model */
+    this->stats = stats;
+
+    /* Count object */
+    if( this->stats )
+        this->stats->add( this );
+}
+
+/* Function to attach object to a spatial index (object is re-bucketed when reprojected) */
+void ObjectRect::setIndex(ObjectIndex* index)
+{
+    /* Previous index loses object */
+    if( this->index )
+        this->index->invalidate();
+
+    /* Assign index */
+    this->index = index;
+
+    /* New index gains object */
+    if( this->index )
+        this->index->invalidate();
+}
+
 /* Function to set/update initial projection parameters */
 void ObjectRect::setProjectionParametters(float azimuth,
         float elevation,
@@ -568,6 +612,10 @@ void ObjectRect::setProjectionParametters(float azimuth,
     this->projection_parameters.aperture = aperture;
     this->projection_parameters.width = width;
     this->projection_parameters.height = height;
+
+    /* Re-bucket object in attached index */
+    if( this->index )
+        this->index->update( this );
 }
 
 /* Function to set/update initial projection points based on current points */
@@ -575,6 +623,10 @@ void ObjectRect::setProjectionPoints()
 {
     /* Assign value */
     this->projection_parameters.points = this->points;
+
+    /* Re-bucket object in attached index */
+    if( this->index )
+        this->index->update( this );
 }
 
 /* Function to set/update initial projection points */
@@ -584,6 +636,10 @@ void ObjectRect::setProjectionPoints(QPointF p1, QPointF p2, QPointF p3, QPointF
     this->projection_parameters.points[1] = p2;
     this->projection_parameters.points[2] = p3;
     this->projection_parameters.points[3] = p4;
+
+    /* Re-bucket object in attached index */
+    if( this->index )
+        this->index->update( this );
 }
 
 /* Function to set source image path */
@@ -673,9 +729,17 @@ int ObjectRect::getObjectType()
 /* Function to set object type (See ObjectType struct) */
 void ObjectRect::setObjectType(int value)
 {
+    /* Uncount object */
+    if( this->stats )
+        this->stats->remove( this );
+
     /* Assign value */
     this->info.type = value;
 
+    /* Count object */
+    if( this->stats )
+        this->stats->add( this );
+
     /* Apply special types colors */
     switch(value)
     {
@@ -721,34 +785,50 @@ bool ObjectRect::isValidated()
 }
 
 /* Function to get manual status */
-QString ObjectRect::getManualStatus()
+int ObjectRect::getManualStatus()
 {
     /* Return result */
     return this->info.manual_status;
 }
 
 /* Function to set manual status */
-void ObjectRect::setManualStatus(QString value)
+void ObjectRect::setManualStatus(int value)
 {
+    /* Uncount object */
+    if( this->stats )
+        this->stats->remove( this );
+
     /* Assign value */
     this->info.manual_status = value;
+
+    /* Count object */
+    if( this->stats )
+        this->stats->add( this );
 }
 
 /* Function to get automatic status */
-QString ObjectRect::getAutomaticStatus()
+int ObjectRect::getAutomaticStatus()
 {
     /* Return result */
     return this->info.automatic_status;
 }
 
 /* Function to set automatic status */
-void ObjectRect::setAutomaticStatus(QString value)
+void ObjectRect::setAutomaticStatus(int value)
 {
+    /* Uncount object */
+    if( this->stats )
+        this->stats->remove( this );
+
     /* Assign value */
     this->info.automatic_status = value;
 
+    /* Count object */
+    if( this->stats )
+        this->stats->add( this );
+
     /* If object is automatic disable resizing */
-    if(value != "None")
+    if(value != ObjectAutomaticStatus::None)
         this->setResizeEnabled( false );
 }
 
@@ -833,76 +913,37 @@ void ObjectRect::mergeWith(ObjectRect *rect)
 /* Function to map current object to specific projection parameters */
 void ObjectRect::mapTo(float width, float height, float azimuth, float elevation, float aperture)
 {
+    /* Source points containers */
+    double r_x[4] = { this->proj_point_1().x(), this->proj_point_2().x(), this->proj_point_3().x(), this->proj_point_4().x() };
+    double r_y[4] = { this->proj_point_1().y(), this->proj_point_2().y(), this->proj_point_3().y(), this->proj_point_4().y() };
+
     /* Destination points containers */
-    QPointF p1, p2, p3, p4;
-
-    /* Map point 1 */
-    g2g_point(this->proj_width(),
-              this->proj_height(),
-              this->proj_azimuth(),
-              this->proj_elevation(),
-              this->proj_aperture(),
-              this->proj_point_1().x(),
-              this->proj_point_1().y(),
-
-              width,
-              height,
-              azimuth,
-              elevation,
-              aperture,
-              &p1.rx(),
-              &p1.ry());
-
-    /* Map point 2 */
-    g2g_point(this->proj_width(),
-              this->proj_height(),
-              this->proj_azimuth(),
-              this->proj_elevation(),
-              this->proj_aperture(),
-              this->proj_point_2().x(),
-              this->proj_point_2().y(),
-
-              width,
-              height,
-              azimuth,
-              elevation,
-              aperture,
-              &p2.rx(),
-              &p2.ry());
-
-    /* Map point 3 */
-    g2g_point(this->proj_width(),
-              this->proj_height(),
-              this->proj_azimuth(),
-              this->proj_elevation(),
-              this->proj_aperture(),
-              this->proj_point_3().x(),
-              this->proj_point_3().y(),
-
-              width,
-              height,
-              azimuth,
-              elevation,
-              aperture,
-              &p3.rx(),
-              &p3.ry());
-
-    /* Map point 4 */
-    g2g_point(this->proj_width(),
-              this->proj_height(),
-              this->proj_azimuth(),
-              this->proj_elevation(),
-              this->proj_aperture(),
-              this->proj_point_4().x(),
-              this->proj_point_4().y(),
-
-              width,
-              height,
-              azimuth,
-              elevation,
-              aperture,
-              &p4.rx(),
-              &p4.ry());
+    double c_x[4];
+    double c_y[4];
+
+    /* Transformation between object and destination projections */
+    g2g_transform t;
+    g2g_transform_init(&t,
+                       this->proj_width(),
+                       this->proj_height(),
+                       this->proj_azimuth(),
+                       this->proj_elevation(),
+                       this->proj_aperture(),
+
+                       width,
+                       height,
+                       azimuth,
+                       elevation,
+                       aperture);
+
+    /* Map all points */
+    g2g_points( &t, 4, r_x, r_y, c_x, c_y );
+
+    /* Destination points */
+    QPointF p1( c_x[0], c_y[0] );
+    QPointF p2( c_x[1], c_y[1] );
+    QPointF p3( c_x[2], c_y[2] );
+    QPointF p4( c_x[3], c_y[3] );
 
     /* Update current object points */
     this->setPoints( p1, p2, p3, p4 );
@@ -949,31 +990,31 @@ void ObjectRect::mapFromSpherical(float source_width,
     float azimuth = ( ( center_x / source_width ) * LG_PI2 );
     float elevation = ( ( - ( center_y / source_height ) + 0.5 ) * LG_PI );
 
-    /* Convert point 1 */
-    etg_point(source_width,
-              source_height,
-              p1_d_x,
-              p1_d_y,
-              dest_width,
-              dest_height,
-              azimuth,
-              elevation,
-              aperture,
-              &p1.rx(),
-              &p1.ry());
-
-    /* Convert point 2 */
-    etg_point(source_width,
-              source_height,
-              p3_d_x,
-              p3_d_y,
-              dest_width,
-              dest_height,
-              azimuth,
-              elevation,
-              aperture,
-              &p3.rx(),
-              &p3.ry());
+    /* Source points containers */
+    double e_x[2] = { p1_d_x, p3_d_x };
+    double e_y[2] = { p1_d_y, p3_d_y };
+
+    /* Destination points containers */
+    double c_x[2];
+    double c_y[2];
+
+    /* Transformation to destination projection */
+    etg_transform t;
+    etg_transform_init(&t,
+                       source_width,
+                       source_height,
+                       dest_width,
+                       dest_height,
+                       azimuth,
+                       elevation,
+                       aperture);
+
+    /* Convert points 1 and 3 */
+    etg_points( &t, 2, e_x, e_y, c_x, c_y );
+
+    /* Assign converted points */
+    p1 = QPointF( c_x[0], c_y[0] );
+    p3 = QPointF( c_x[1], c_y[1] );
 
     /* Update points */
     this->setPoints(p1,
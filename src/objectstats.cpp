@@ -0,0 +1,155 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "objectstats.h"
+
+/* Constructor */
+ObjectStats::ObjectStats()
+{
+    /* Reset counters */
+    this->counters.untyped = 0;
+    this->counters.faces = 0;
+    this->counters.faces_validated = 0;
+    this->counters.plates = 0;
+    this->counters.plates_validated = 0;
+    this->counters.preinvalidated = 0;
+    this->counters.preinvalidated_validated = 0;
+    this->counters.toblur = 0;
+}
+
+/* Function to count an object */
+void ObjectStats::add(ObjectRect* rect)
+{
+    /* Apply contribution */
+    this->apply( rect, 1 );
+}
+
+/* Function to uncount an object */
+void ObjectStats::remove(ObjectRect* rect)
+{
+    /* Remove contribution */
+    this->apply( rect, -1 );
+}
+
+/* Function to apply an object contribution to counters */
+void ObjectStats::apply(ObjectRect* rect, int delta)
+{
+    /* Object statuses */
+    bool prefiltered = ( rect->getAutomaticStatus() != ObjectAutomaticStatus::None &&
+                         rect->getAutomaticStatus() != ObjectAutomaticStatus::Valid );
+    bool validated = ( rect->getManualStatus() != ObjectManualStatus::None );
+
+    /* Rect type swith */
+    switch(rect->getObjectType())
+    {
+
+    /* Untyped rect */
+    case ObjectType::None:
+        this->counters.untyped += delta;
+        break;
+
+    /* Face */
+    case ObjectType::Face:
+
+        /* If automatic status is pre-filtered */
+        if( prefiltered )
+        {
+            this->counters.preinvalidated += delta;
+            if( validated ) this->counters.preinvalidated_validated += delta;
+
+        } else {
+
+            this->counters.faces += delta;
+            if( validated ) this->counters.faces_validated += delta;
+        }
+        break;
+
+    /* NumberPlate */
+    case ObjectType::NumberPlate:
+        this->counters.plates += delta;
+        if( validated ) this->counters.plates_validated += delta;
+        break;
+
+    /* "ToBlur" */
+    case ObjectType::ToBlur:
+        this->counters.toblur += delta;
+        break;
+    }
+}
+
+/* Counters getters */
+int ObjectStats::untyped()
+{
+    return this->counters.untyped;
+}
+
+int ObjectStats::faces()
+{
+    return this->counters.faces;
+}
+
+int ObjectStats::facesValidated()
+{
+    return this->counters.faces_validated;
+}
+
+int ObjectStats::plates()
+{
+    return this->counters.plates;
+}
+
+int ObjectStats::platesValidated()
+{
+    return this->counters.plates_validated;
+}
+
+int ObjectStats::preInvalidated()
+{
+    return this->counters.preinvalidated;
+}
+
+int ObjectStats::preInvalidatedValidated()
+{
+    return this->counters.preinvalidated_validated;
+}
+
+int ObjectStats::toBlur()
+{
+    return this->counters.toblur;
+}
@@ -0,0 +1,584 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "panoramacache.h"
+#include "imageconvert.h"
+#include "projectionmap.h"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* Mapped spill file (released with the image) */
+struct panorama_spill_struct{
+    void* address;
+    size_t size;
+};
+
+/* Function to unmap a spill file wrapped by a QImage */
+static void panoramaCacheRelease(void *info)
+{
+    /* Unmap spill file */
+    panorama_spill_struct* spill = (panorama_spill_struct*) info;
+    munmap( spill->address, spill->size );
+    delete spill;
+}
+
+/* Function to wrap a 32 bits QImage into an OpenCV matrix without copy */
+static cv::Mat panoramaCacheMat(QImage &image)
+{
+    /* Return wrapper */
+    return cv::Mat(image.height(), image.width(), CV_8UC4, image.bits(), image.bytesPerLine());
+}
+
+/* Function to get a pixel from a tiles grid */
+static inline QRgb panoramaCacheTilePixel(const QRgb * const *pointers,
+                                          const int *strides,
+                                          int tiles_x,
+                                          int shift,
+                                          int x,
+                                          int y)
+{
+    /* Determine tile index and tile mask */
+    int tile = ((y >> shift) * tiles_x) + (x >> shift);
+    int mask = (1 << shift) - 1;
+
+    /* Return pixel */
+    return pointers[tile][((y & mask) * strides[tile]) + (x & mask)];
+}
+
+/* Constructor */
+PanoramaCache::PanoramaCache()
+{
+    /* Default tiles settings */
+    this->tile_shift = 9;
+    this->tile_size = (1 << this->tile_shift);
+
+    /* Default memory settings */
+    this->setMemoryBudget( (qint64) 256 * 1024 * 1024 );
+}
+
+/* Function to allocate a 32 bits level, levels above resident limit are backed by an unlinked temporary file */
+QImage PanoramaCache::allocate(int width, int height)
+{
+    /* Level size */
+    int bytes_per_line = width * 4;
+    qint64 size = (qint64) bytes_per_line * height;
+
+    /* Small levels stay in memory */
+    if( size <= PANORAMA_CACHE_RESIDENT_LIMIT )
+        return QImage( width, height, QImage::Format_RGB32 );
+
+    /* Create spill file (removed once mapped) */
+    QByteArray name = QFile::encodeName( QDir::temp().filePath( "yafdb-validate-XXXXXX" ) );
+    int descriptor = mkstemp( name.data() );
+    if( descriptor < 0 )
+        return QImage( width, height, QImage::Format_RGB32 );
+    unlink( name.constData() );
+
+    /* Map spill file (pages are written back and evicted by the kernel under memory pressure) */
+    void* address = MAP_FAILED;
+    if( ftruncate( descriptor, size ) == 0 )
+        address = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0 );
+
+    /* Mapping keeps file open */
+    close( descriptor );
+    if( address == MAP_FAILED )
+        return QImage( width, height, QImage::Format_RGB32 );
+
+    /* Wrap mapped pixels, unmapped with the image */
+    panorama_spill_struct* spill = new panorama_spill_struct;
+    spill->address = address;
+    spill->size = size;
+    return QImage( (uchar*) address, width, height, bytes_per_line, QImage::Format_RGB32, panoramaCacheRelease, spill );
+}
+
+/* Function to build the image pyramid from a decoded image */
+void PanoramaCache::load(IplImage* image, int threads)
+{
+    /* Wrap decoded image without copy */
+    cv::Mat source( image );
+
+    /* Allocate full resolution level (BGRA in memory) */
+    QImage full = PanoramaCache::allocate( source.cols, source.rows );
+    cv::Mat full_mat = panoramaCacheMat( full );
+
+    /* Convert source pixels once, they are never re-encoded */
+    switch(source.channels())
+    {
+    case 1:
+        cv::cvtColor(source, full_mat, CV_GRAY2BGRA);
+        break;
+    case 4:
+        source.copyTo(full_mat);
+        break;
+    default:
+        #pragma omp parallel for num_threads( threads ) schedule( static )
+        for (int y = 0; y < source.rows; y++)
+        {
+            convertRowBGR(source.ptr<uchar>(y), (QRgb *) full.scanLine(y), source.cols);
+        }
+        break;
+    }
+
+    /* Build pyramid */
+    this->load( PanoramaCache::pyramid( full ) );
+}
+
+/* Function to assign prebuilt pyramid levels (32 bits, full resolution first, pixels are shared) */
+void PanoramaCache::load(const QList<QImage> &levels)
+{
+    /* Reset previous pyramid */
+    QMutexLocker locker(&this->tiles_mutex);
+    this->tiles_cache.clear();
+    this->levels_list.clear();
+
+    /* Assign levels (read through constBits only, mapped pixels are never detached) */
+    foreach(const QImage &image, levels)
+    {
+        panorama_level_struct level;
+        level.width = image.width();
+        level.height = image.height();
+        level.tiles_x = (level.width + this->tile_size - 1) / this->tile_size;
+        level.tiles_y = (level.height + this->tile_size - 1) / this->tile_size;
+        level.tiled = ( (qint64) image.bytesPerLine() * image.height() ) > PANORAMA_CACHE_RESIDENT_LIMIT;
+        level.image = image;
+        this->levels_list.append( level );
+    }
+}
+
+/* Function to build the pyramid levels of a 32 bits image (full resolution first, shared) */
+QList<QImage> PanoramaCache::pyramid(const QImage &full)
+{
+    /* Levels list */
+    QList<QImage> levels;
+
+    /* Current level image */
+    QImage current = full;
+
+    /* Build levels until they fit in coarsest width */
+    while( true )
+    {
+        /* Append level */
+        levels.append( current );
+
+        /* Stop when level is small enough */
+        if( current.width() <= PANORAMA_CACHE_COARSEST_WIDTH )
+            break;
+
+        /* Downsample level into a 32 bits image */
+        QImage next = PanoramaCache::allocate( (current.width() + 1) / 2, (current.height() + 1) / 2 );
+        cv::Mat next_mat = panoramaCacheMat( next );
+        cv::pyrDown(cv::Mat(current.height(), current.width(), CV_8UC4, (void *) current.constBits(), current.bytesPerLine()), next_mat, next_mat.size());
+        current = next;
+    }
+
+    /* Return result */
+    return levels;
+}
+
+/* Function to get the number of pyramid levels of an image width */
+int PanoramaCache::depth(int width)
+{
+    /* Count halvings until coarsest width */
+    int count = 1;
+    while( width > PANORAMA_CACHE_COARSEST_WIDTH )
+    {
+        width = (width + 1) / 2;
+        count++;
+    }
+
+    /* Return result */
+    return count;
+}
+
+/* Function to set the tiles memory budget (in bytes) */
+void PanoramaCache::setMemoryBudget(qint64 bytes)
+{
+    /* Assign value */
+    QMutexLocker locker(&this->tiles_mutex);
+    this->tiles_cache.setMaxCost( (int) (bytes / 1024) );
+}
+
+/* Function to get the tiles memory budget (in bytes) */
+qint64 PanoramaCache::memoryBudget()
+{
+    /* Return value */
+    QMutexLocker locker(&this->tiles_mutex);
+    return (qint64) this->tiles_cache.maxCost() * 1024;
+}
+
+/* Function to get the resident pixels memory usage (in bytes) */
+qint64 PanoramaCache::memoryUsage()
+{
+    /* Cached tiles usage */
+    QMutexLocker locker(&this->tiles_mutex);
+    qint64 usage = (qint64) this->tiles_cache.totalCost() * 1024;
+
+    /* Append resident levels usage (tiled levels are file backed) */
+    foreach(const panorama_level_struct &level, this->levels_list)
+    {
+        if( !level.tiled )
+            usage += level.image.byteCount();
+    }
+
+    /* Return result */
+    return usage;
+}
+
+/* Function to get full resolution width */
+int PanoramaCache::width()
+{
+    /* Return value */
+    return this->levels_list.isEmpty() ? 0 : this->levels_list.first().width;
+}
+
+/* Function to get full resolution height */
+int PanoramaCache::height()
+{
+    /* Return value */
+    return this->levels_list.isEmpty() ? 0 : this->levels_list.first().height;
+}
+
+/* Function to get number of pyramid levels */
+int PanoramaCache::levels()
+{
+    /* Return value */
+    return this->levels_list.size();
+}
+
+/* Function to select the coarsest level meeting a view resolution */
+int PanoramaCache::selectLevel(int dest_width, float aperture)
+{
+    /* Compute view pixel angular size */
+    double view_pixel = 2.0 * tan( aperture / 2.0 ) / dest_width;
+
+    /* Select coarser levels while their pixels stay smaller than view pixels */
+    int level = 0;
+    while( ((level + 1) < this->levels_list.size())
+           && ((LG_PI2 / this->levels_list.at(level + 1).width) <= view_pixel) )
+    {
+        level++;
+    }
+
+    /* Return result */
+    return level;
+}
+
+/* Function to copy a specified tile from level pixels */
+QImage PanoramaCache::copyTile(int level, int index)
+{
+    /* Get level */
+    const panorama_level_struct &source = this->levels_list.at(level);
+
+    /* Determine tile area */
+    int tile_x = (index % source.tiles_x) * this->tile_size;
+    int tile_y = (index / source.tiles_x) * this->tile_size;
+
+    /* Return copied tile (exact source pixels) */
+    return source.image.copy( tile_x,
+                              tile_y,
+                              qMin( this->tile_size, source.width - tile_x ),
+                              qMin( this->tile_size, source.height - tile_y ) );
+}
+
+/* Function to get level tiles, copying missing ones from level pixels */
+void PanoramaCache::fetchTiles(int level, QVector<char> &needed, QVector<QImage> &tiles, int threads)
+{
+    /* Missing tiles list */
+    QVector<int> missing;
+
+    /* Allocate tiles list */
+    tiles.resize( needed.size() );
+
+    /* Retrieve cached tiles */
+    this->tiles_mutex.lock();
+    for (int i = 0; i < needed.size(); i++)
+    {
+        /* Skip unneeded tiles */
+        if( !needed.at(i) )
+            continue;
+
+        /* Look for tile in cache */
+        QImage *cached = this->tiles_cache.object( (level << 20) | i );
+
+        /* Use cached tile or mark it as missing */
+        if( cached != NULL )
+        {
+            tiles[i] = *cached;
+        } else {
+            missing.append( i );
+        }
+    }
+    this->tiles_mutex.unlock();
+
+    /* Copy missing tiles (backing pages are read on demand) */
+    QImage *tiles_data = tiles.data();
+    const int *missing_data = missing.constData();
+    int missing_count = missing.size();
+
+    #pragma omp parallel for num_threads( threads ) schedule( dynamic )
+    for (int i = 0; i < missing_count; i++)
+    {
+        tiles_data[missing_data[i]] = this->copyTile(level, missing_data[i]);
+    }
+
+    /* Insert copied tiles into cache */
+    QMutexLocker locker(&this->tiles_mutex);
+    foreach(int index, missing)
+    {
+        this->tiles_cache.insert( (level << 20) | index, new QImage( tiles.at(index) ), tiles.at(index).byteCount() / 1024 );
+    }
+}
+
+/* Function to project a gnomonic view from specified level */
+bool PanoramaCache::project(QImage* dest,
+                            float azimuth,
+                            float elevation,
+                            float aperture,
+                            int level,
+                            int threads,
+                            int interpolation,
+                            const QAtomicInt* cancel,
+                            bool cache_map)
+{
+    /* Project whole view */
+    return this->projectWindow(dest,
+                               dest->width(),
+                               dest->height(),
+                               dest->rect(),
+                               azimuth,
+                               elevation,
+                               aperture,
+                               level,
+                               threads,
+                               interpolation,
+                               cancel,
+                               cache_map);
+}
+
+/* Function to project a window of a gnomonic view from specified level */
+bool PanoramaCache::projectWindow(QImage* dest,
+                                  int view_width,
+                                  int view_height,
+                                  const QRect &window,
+                                  float azimuth,
+                                  float elevation,
+                                  float aperture,
+                                  int level,
+                                  int threads,
+                                  int interpolation,
+                                  const QAtomicInt* cancel,
+                                  bool cache_map)
+{
+    /* Get level */
+    const panorama_level_struct &source = this->levels_list.at(level);
+
+    /* Destination image (window) dimensions */
+    int c_width = window.width();
+    int c_height = window.height();
+
+    /* Source coordinates */
+    QVector<qint32> coords;
+
+    /* Get source coordinates from the shared maps cache or compute them */
+    if( cache_map )
+    {
+        coords = ProjectionMapCache::instance()->map(source.width,
+                                                     source.height,
+                                                     view_width,
+                                                     view_height,
+                                                     window,
+                                                     azimuth,
+                                                     elevation,
+                                                     aperture,
+                                                     threads,
+                                                     cancel);
+    } else {
+        coords.resize( 2 * c_width * c_height );
+        projection_coordinates(coords.data(),
+                               source.width,
+                               source.height,
+                               view_width,
+                               view_height,
+                               window.x(),
+                               window.y(),
+                               c_width,
+                               c_height,
+                               azimuth,
+                               elevation,
+                               aperture,
+                               threads,
+                               cancel);
+    }
+
+    /* Stop here if cancelled */
+    if( cancel && cancel->load() )
+        return false;
+
+    /* Check if level is resident */
+    if( !source.tiled )
+    {
+        /* Sample resident level */
+        projection_gather(coords.constData(),
+                          (const QRgb *) source.image.constBits(),
+                          source.width,
+                          source.height,
+                          source.image.bytesPerLine() / 4,
+                          (QRgb *) dest->bits(),
+                          c_width,
+                          c_height,
+                          dest->bytesPerLine() / 4,
+                          interpolation,
+                          threads,
+                          cancel);
+
+        /* Return completion state */
+        return !(cancel && cancel->load());
+    }
+
+    /* Mark tiles covered by source coordinates */
+    QVector<char> needed( source.tiles_x * source.tiles_y, 0 );
+    const qint32 *coord = coords.constData();
+    qint32 y_max = (source.height - 1) << PROJECTION_FIXED_SHIFT;
+    for (int i = 0; i < (c_width * c_height); i++)
+    {
+        /* Determine sampled pixels */
+        int x0 = (coord[2 * i] >> PROJECTION_FIXED_SHIFT) % source.width;
+        int y0 = qBound( 0, coord[2 * i + 1], y_max ) >> PROJECTION_FIXED_SHIFT;
+        int x1 = (x0 + 1) < source.width ? (x0 + 1) : 0;
+        int y1 = (y0 + 1) < source.height ? (y0 + 1) : y0;
+
+        /* Mark tiles */
+        needed[((y0 >> this->tile_shift) * source.tiles_x) + (x0 >> this->tile_shift)] = 1;
+        needed[((y0 >> this->tile_shift) * source.tiles_x) + (x1 >> this->tile_shift)] = 1;
+        needed[((y1 >> this->tile_shift) * source.tiles_x) + (x0 >> this->tile_shift)] = 1;
+        needed[((y1 >> this->tile_shift) * source.tiles_x) + (x1 >> this->tile_shift)] = 1;
+    }
+
+    /* Retrieve decoded tiles */
+    QVector<QImage> tiles;
+    this->fetchTiles(level, needed, tiles, threads);
+
+    /* Stop here if cancelled */
+    if( cancel && cancel->load() )
+        return false;
+
+    /* Build tiles pointers/strides tables */
+    QVector<const QRgb *> pointers( tiles.size(), NULL );
+    QVector<int> strides( tiles.size(), 0 );
+    for (int i = 0; i < tiles.size(); i++)
+    {
+        if( !tiles.at(i).isNull() )
+        {
+            pointers[i] = (const QRgb *) tiles.at(i).constBits();
+            strides[i] = tiles.at(i).bytesPerLine() / 4;
+        }
+    }
+
+    /* Tables raw pointers */
+    const QRgb * const *pointers_data = pointers.constData();
+    const int *strides_data = strides.constData();
+
+    /* Destination pixels */
+    QRgb *c_bits = (QRgb *) dest->bits();
+    int c_stride = dest->bytesPerLine() / 4;
+
+    /* Iterate over rectilinear image Y axis */
+    #pragma omp parallel for num_threads( threads ) schedule( static )
+    for (int y = 0; y < c_height; y++)
+    {
+        /* Skip remaining rows on cancellation */
+        if( cancel && cancel->load() )
+            continue;
+
+        /* Get source coordinates and destination rows */
+        const qint32 *row_coord = coord + (2 * y * c_width);
+        QRgb *row = c_bits + (y * c_stride);
+
+        /* Nearest neighbour sampling */
+        if( interpolation == ProjectionInterpolation::Nearest )
+        {
+            /* Iterate over rectilinear image X axis */
+            for (int x = 0; x < c_width; x++)
+            {
+                /* Round coordinates and wrap/clamp them */
+                int x0 = ((row_coord[2 * x] + (PROJECTION_FIXED_ONE / 2)) >> PROJECTION_FIXED_SHIFT) % source.width;
+                int y0 = qBound( 0, row_coord[2 * x + 1] + (PROJECTION_FIXED_ONE / 2), y_max ) >> PROJECTION_FIXED_SHIFT;
+
+                /* Copy pixel */
+                row[x] = panoramaCacheTilePixel(pointers_data, strides_data, source.tiles_x, this->tile_shift, x0, y0);
+            }
+
+            /* Next row */
+            continue;
+        }
+
+        /* Iterate over rectilinear image X axis */
+        for (int x = 0; x < c_width; x++)
+        {
+            /* Split coordinates into integer and fixed point fractional parts */
+            qint32 s_x = row_coord[2 * x];
+            qint32 s_y = qBound( 0, row_coord[2 * x + 1], y_max );
+            int x0 = s_x >> PROJECTION_FIXED_SHIFT;
+            int y0 = s_y >> PROJECTION_FIXED_SHIFT;
+            int wx = s_x & PROJECTION_FIXED_MASK;
+            int wy = s_y & PROJECTION_FIXED_MASK;
+
+            /* Wrap/clamp neighbour coordinates */
+            x0 = x0 % source.width;
+            int x1 = (x0 + 1) < source.width ? (x0 + 1) : 0;
+            int y1 = (y0 + 1) < source.height ? (y0 + 1) : y0;
+
+            /* Interpolate pixel */
+            row[x] = projection_bilinear(
+                panoramaCacheTilePixel(pointers_data, strides_data, source.tiles_x, this->tile_shift, x0, y0),
+                panoramaCacheTilePixel(pointers_data, strides_data, source.tiles_x, this->tile_shift, x1, y0),
+                panoramaCacheTilePixel(pointers_data, strides_data, source.tiles_x, this->tile_shift, x0, y1),
+                panoramaCacheTilePixel(pointers_data, strides_data, source.tiles_x, this->tile_shift, x1, y1),
+                wx,
+                wy
+            );
+        }
+    }
+
+    /* Return completion state */
+    return !(cancel && cancel->load());
+}
@@ -0,0 +1,330 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "panoramaprefetcher.h"
+
+/* Constructor */
+PanoramaPrefetcher::PanoramaPrefetcher(QObject *parent) :
+    QThread(parent)
+{
+    /* Initialize state */
+    this->ready.cache = NULL;
+    this->threads_count = 1;
+    this->stopping = false;
+}
+
+/* Destructor (unclaimed panorama is released) */
+PanoramaPrefetcher::~PanoramaPrefetcher()
+{
+    /* Stop loading loop */
+    this->stop();
+
+    /* Release unclaimed panorama */
+    this->release();
+}
+
+/* Function to load a panorama (decoded in calling thread) */
+panorama_prefetch_struct PanoramaPrefetcher::load(QString path, int threads)
+{
+    /* Trace zone */
+    TraceZone zone( "PanoramaPrefetcher::load" );
+
+    /* Initialize result */
+    panorama_prefetch_struct result;
+    result.path = path;
+    result.cache = NULL;
+    result.width = 0;
+    result.height = 0;
+    result.channels = 0;
+
+    /* Pyramid levels mapped from decode cache (full resolution pages are read on demand) */
+    if( DecodeCache::enabled() )
+    {
+        /* Map cached pyramid, or decode, build and store it */
+        int channels = 0;
+        QList<QImage> levels = DecodeCache::loadPyramid( path, threads, &channels );
+
+        /* Check image */
+        if( levels.isEmpty() )
+        {
+            /* Info output */
+            std::cout << "[ERROR] Unable to load image " << path.toStdString() << std::endl;
+            return result;
+        }
+
+        /* Save image details */
+        result.channels = (channels + 1);
+        result.width = levels.first().width();
+        result.height = levels.first().height();
+
+        /* Assign mapped pyramid */
+        result.cache = new PanoramaCache();
+        result.cache->load( levels );
+        return result;
+    }
+
+    /* Decode image (restart markers strips are decoded in parallel) */
+    IplImage * temp_image = JpegDecoder::load( path, threads );
+
+    /* Check image */
+    if( temp_image == NULL )
+    {
+        /* Info output */
+        std::cout << "[ERROR] Unable to load image " << path.toStdString() << std::endl;
+        return result;
+    }
+
+    /* Save image details */
+    result.channels = (temp_image->nChannels + 1);
+    result.width = temp_image->width;
+    result.height = temp_image->height;
+
+    /* Build image pyramid (full resolution level keeps source pixels) */
+    result.cache = new PanoramaCache();
+    result.cache->load( temp_image, threads );
+
+    /* Release temporary image */
+    cvReleaseImage( &temp_image );
+
+    /* Return result */
+    return result;
+}
+
+/* Function to load a reduced resolution preview of a JPEG panorama, decoded in DCT domain (NULL cache if not worth it) */
+panorama_prefetch_struct PanoramaPrefetcher::loadPreview(QString path, int threads, int view_width)
+{
+    /* Trace zone */
+    TraceZone zone( "PanoramaPrefetcher::loadPreview" );
+
+    /* Initialize result */
+    panorama_prefetch_struct result;
+    result.path = path;
+    result.cache = NULL;
+    result.width = 0;
+    result.height = 0;
+    result.channels = 0;
+
+    /* Read image size from header */
+    QImageReader reader( path );
+    QSize size = reader.size();
+
+    /* Only JPEG decoder scales in DCT domain, small panoramas are decoded fast enough */
+    if( !size.isValid() || reader.format() != "jpeg" || size.width() < 4096 )
+        return result;
+
+    /* Reduce 8 times if preview still covers the view pixels, 4 times otherwise */
+    int denominator = ( size.width() / 8 >= view_width ) ? 8 : 4;
+
+    /* Decode preview (exact 1/n scales are applied by the decoder, without resampling) */
+    reader.setScaledSize( QSize( size.width() / denominator, size.height() / denominator ) );
+    QImage preview = reader.read();
+
+    /* Check preview */
+    if( preview.isNull() )
+        return result;
+
+    /* Convert preview to 32 bits (BGRA in memory) */
+    if( preview.format() != QImage::Format_RGB32 && preview.format() != QImage::Format_ARGB32 )
+        preview = preview.convertToFormat( QImage::Format_RGB32 );
+
+    /* Wrap preview without copy */
+    IplImage* header = cvCreateImageHeader( cvSize( preview.width(), preview.height() ), IPL_DEPTH_8U, 4 );
+    cvSetData( header, preview.bits(), preview.bytesPerLine() );
+
+    /* Build preview pyramid */
+    result.cache = new PanoramaCache();
+    result.cache->load( header, threads );
+
+    /* Release header */
+    cvReleaseImageHeader( &header );
+
+    /* Save full resolution details (objects are mapped on them) */
+    result.width = size.width();
+    result.height = size.height();
+    result.channels = reader.imageFormat() == QImage::Format_Grayscale8 || reader.imageFormat() == QImage::Format_Indexed8 ? 2 : 4;
+
+    /* Return result */
+    return result;
+}
+
+/* Function to set the loading parameters (threads count) */
+void PanoramaPrefetcher::setup(int threads)
+{
+    /* Assign value */
+    QMutexLocker locker(&this->mutex);
+    this->threads_count = threads;
+}
+
+/* Function to queue a panorama loading, superseding any pending one */
+void PanoramaPrefetcher::prefetch(QString path)
+{
+    /* Lock requests */
+    QMutexLocker locker(&this->mutex);
+
+    /* Skip panorama already loaded or loading */
+    if( this->loading == path || ( this->ready.cache != NULL && this->ready.path == path ) )
+        return;
+
+    /* Queue request */
+    this->pending = path;
+
+    /* Start loading loop if needed (low priority, validation must stay responsive) */
+    if( !this->isRunning() )
+        this->start( QThread::LowPriority );
+
+    /* Wake loading loop */
+    this->condition.wakeAll();
+}
+
+/* Function to take a panorama, waiting for its prefetch or loading it if it was not requested */
+panorama_prefetch_struct PanoramaPrefetcher::take(QString path)
+{
+    /* Lock requests */
+    this->mutex.lock();
+
+    /* Wait for in-flight loading of requested panorama */
+    while( this->loading == path )
+        this->done.wait( &this->mutex );
+
+    /* Take prefetched panorama */
+    if( this->ready.cache != NULL && this->ready.path == path )
+    {
+        panorama_prefetch_struct result = this->ready;
+        this->ready.cache = NULL;
+        this->mutex.unlock();
+        return result;
+    }
+
+    /* Drop pending request of requested panorama */
+    if( this->pending == path )
+        this->pending.clear();
+
+    /* Read loading parameters */
+    int threads = this->threads_count;
+    this->mutex.unlock();
+
+    /* Load panorama in calling thread */
+    return PanoramaPrefetcher::load( path, threads );
+}
+
+/* Function to release a loaded or pending panorama which is not needed anymore */
+void PanoramaPrefetcher::discard(QString path)
+{
+    /* Lock requests */
+    QMutexLocker locker(&this->mutex);
+
+    /* Drop pending request */
+    if( this->pending == path )
+        this->pending.clear();
+
+    /* Release loaded panorama */
+    if( this->ready.cache != NULL && this->ready.path == path )
+    {
+        delete this->ready.cache;
+        this->ready.cache = NULL;
+    }
+}
+
+/* Function to stop the loading loop */
+void PanoramaPrefetcher::stop()
+{
+    /* Request termination */
+    this->mutex.lock();
+    this->stopping = true;
+    this->pending.clear();
+    this->condition.wakeAll();
+    this->mutex.unlock();
+
+    /* Wait for loading loop */
+    this->wait();
+
+    /* Allow restart */
+    QMutexLocker locker(&this->mutex);
+    this->stopping = false;
+}
+
+/* Function to release the loaded panorama */
+void PanoramaPrefetcher::release()
+{
+    /* Release panorama */
+    QMutexLocker locker(&this->mutex);
+    delete this->ready.cache;
+    this->ready.cache = NULL;
+}
+
+/* Loading loop */
+void PanoramaPrefetcher::run()
+{
+    forever
+    {
+        /* Wait for a request */
+        this->mutex.lock();
+        while( this->pending.isEmpty() && !this->stopping )
+            this->condition.wait( &this->mutex );
+
+        /* Check termination */
+        if( this->stopping )
+        {
+            this->mutex.unlock();
+            return;
+        }
+
+        /* Take request */
+        this->loading = this->pending;
+        this->pending.clear();
+        int threads = this->threads_count;
+        this->mutex.unlock();
+
+        /* Load panorama */
+        panorama_prefetch_struct result = PanoramaPrefetcher::load( this->loading, threads );
+
+        /* Replace unclaimed panorama */
+        this->mutex.lock();
+        delete this->ready.cache;
+        this->ready = result;
+        this->loading.clear();
+
+        /* Wake waiting takers */
+        this->done.wakeAll();
+        this->mutex.unlock();
+
+        /* Report loaded panorama */
+        emit loaded( result.path );
+    }
+}
@@ -0,0 +1,250 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "panoramarenderer.h"
+
+/* Constructor */
+PanoramaRenderer::PanoramaRenderer(QObject *parent) :
+    QThread(parent)
+{
+    /* Initialize state */
+    this->has_pending = false;
+    this->stopping = false;
+    this->busy = false;
+
+    /* Default settings */
+    this->draft_pixels = 320 * 1000;
+    this->refine_delay = 120;
+
+    /* Triple buffered frames pools */
+    this->draft_pool.resize( 3 );
+    this->frame_pool.resize( 3 );
+}
+
+/* Destructor */
+PanoramaRenderer::~PanoramaRenderer()
+{
+    /* Request termination and cancel in-flight frame */
+    this->mutex.lock();
+    this->stopping = true;
+    this->cancel.store( 1 );
+    this->condition.wakeAll();
+    this->mutex.unlock();
+
+    /* Wait for render loop */
+    this->wait();
+}
+
+/* Function to request a new frame, superseding any pending one */
+void PanoramaRenderer::request(const panorama_render_request_struct &request)
+{
+    /* Replace pending request */
+    QMutexLocker locker(&this->mutex);
+    this->pending = request;
+    this->has_pending = true;
+
+    /* Cancel in-flight refinement */
+    this->cancel.store( 1 );
+
+    /* Start render loop if needed */
+    if( !this->isRunning() )
+        this->start();
+
+    /* Wake render loop */
+    this->condition.wakeAll();
+}
+
+/* Function to set the maximal pixels count of draft frames */
+void PanoramaRenderer::setDraftPixels(int pixels)
+{
+    /* Assign value */
+    QMutexLocker locker(&this->mutex);
+    this->draft_pixels = qMax( 1, pixels );
+}
+
+/* Function to set the idle delay before refining a frame (in milliseconds) */
+void PanoramaRenderer::setRefineDelay(int msecs)
+{
+    /* Assign value */
+    QMutexLocker locker(&this->mutex);
+    this->refine_delay = qMax( 0, msecs );
+}
+
+/* Function to drop pending request and wait for in-flight frame (its panorama can be released afterwards) */
+void PanoramaRenderer::sync()
+{
+    /* Drop pending request and cancel in-flight refinement */
+    QMutexLocker locker(&this->mutex);
+    this->has_pending = false;
+    this->cancel.store( 1 );
+    this->condition.wakeAll();
+
+    /* Wait for in-flight request */
+    while( this->busy )
+        this->idle.wait( &this->mutex );
+}
+
+/* Function to wait for the next request, returns false on termination */
+bool PanoramaRenderer::nextRequest(panorama_render_request_struct &request)
+{
+    /* Previous request is completed */
+    QMutexLocker locker(&this->mutex);
+    this->busy = false;
+    this->idle.wakeAll();
+
+    /* Wait for a request */
+    while( !this->has_pending && !this->stopping )
+        this->condition.wait( &this->mutex );
+
+    /* Check termination */
+    if( this->stopping )
+        return false;
+
+    /* Take request and reset cancellation */
+    request = this->pending;
+    this->has_pending = false;
+    this->busy = true;
+    this->cancel.store( 0 );
+
+    /* Return result */
+    return true;
+}
+
+/* Function to get a pool frame no longer referenced by the viewer */
+QImage* PanoramaRenderer::acquireFrame(QVector<QImage> &pool, int width, int height)
+{
+    /* Free frame fallback */
+    int free_index = -1;
+
+    /* Look for a free frame, preferably already sized */
+    for (int i = 0; i < pool.size(); i++)
+    {
+        /* Skip frames still shared with the viewer */
+        if( !pool.at(i).isNull() && !pool.at(i).isDetached() )
+            continue;
+
+        /* Reuse frame as is if size matches */
+        if( pool.at(i).width() == width && pool.at(i).height() == height )
+            return &pool[i];
+
+        /* Remember free frame */
+        if( free_index < 0 )
+            free_index = i;
+    }
+
+    /* Use first frame if all are shared, its pixels stay owned by the viewer */
+    if( free_index < 0 )
+        free_index = 0;
+
+    /* Allocate frame */
+    pool[free_index] = QImage( width, height, QImage::Format_RGB32 );
+
+    /* Return result */
+    return &pool[free_index];
+}
+
+/* Render loop */
+void PanoramaRenderer::run()
+{
+    /* Current request */
+    panorama_render_request_struct request;
+
+    /* Process requests */
+    while( this->nextRequest( request ) )
+    {
+        /* Skip empty views */
+        if( request.cache == NULL || request.width < 1 || request.height < 1 )
+            continue;
+
+        /* Determine draft reduction factor to bound its pixels count */
+        this->mutex.lock();
+        int factor = (int) ceil( sqrt( ((double) request.width * request.height) / this->draft_pixels ) );
+        int delay = this->refine_delay;
+        this->mutex.unlock();
+        factor = qMax( 1, factor );
+
+        /* Render draft frame (nearest neighbour, reduced resolution, from coarse level) */
+        QImage* draft = this->acquireFrame( this->draft_pool, qMax( 1, request.width / factor ), qMax( 1, request.height / factor ) );
+        {
+            TraceZone zone( "PanoramaRenderer::draft" );
+            request.cache->project( draft,
+                                    request.azimuth,
+                                    request.elevation,
+                                    request.aperture,
+                                    request.cache->selectLevel( draft->width(), request.aperture ),
+                                    request.threads,
+                                    ProjectionInterpolation::Nearest,
+                                    NULL,
+                                    false );
+        }
+
+        /* Deliver draft frame */
+        emit frameReady( *draft, request.generation, false );
+
+        /* Wait for the view to stay idle */
+        this->mutex.lock();
+        if( !this->has_pending && !this->stopping )
+            this->condition.wait( &this->mutex, delay );
+        bool superseded = this->has_pending || this->stopping;
+        this->mutex.unlock();
+
+        /* Skip refinement if a newer view was requested */
+        if( superseded )
+            continue;
+
+        /* Render refined frame (bilinear, full resolution), cancellable */
+        QImage* frame = this->acquireFrame( this->frame_pool, request.width, request.height );
+        bool completed = false;
+        {
+            TraceZone zone( "PanoramaRenderer::frame" );
+            completed = request.cache->project( frame,
+                                                request.azimuth,
+                                                request.elevation,
+                                                request.aperture,
+                                                request.cache->selectLevel( request.width, request.aperture ),
+                                                request.threads,
+                                                ProjectionInterpolation::Bilinear,
+                                                &this->cancel );
+        }
+
+        /* Deliver refined frame */
+        if( completed )
+            emit frameReady( *frame, request.generation, true );
+    }
+}
@@ -70,6 +70,8 @@ PanoramaViewer::PanoramaViewer(QWidget *parent, bool connectSlots) :
     this->image_info.channels = 0;
     this->image_info.height = 0;
     this->image_info.image = NULL;
+    this->image_info.cache = NULL;
+    this->preview_shown = false;
 
     /* Initialize default mode */
     this->mode = PanoramaViewerMode::None;
@@ -82,14 +84,26 @@ PanoramaViewer::PanoramaViewer(QWidget *parent, bool connectSlots) :
     this->position.aperture = ( this->position.aperture_delta * ( LG_PI / 180.0 ) );;
     this->position.old_aperture = this->position.aperture;
     this->threads_count = 1;
+    this->cache_budget = (qint64) 256 * 1024 * 1024;
     this->vis_group = PanoramaViewerVisGroups::All;
     this->moveEnabled = true;
     this->zoomEnabled = true;
     this->createEnabled = true;
     this->editEnabled = true;
 
-    /* Initialize pixmap state container */
-    this->pixmap_initialized = false;
+    /* Initialize destination size */
+    this->dest_size = QSize(0, 0);
+
+    /* Create background renderer */
+    this->render_generation = 0;
+    this->frame_generation = 0;
+    this->request_time = -1;
+    this->renderer = new PanoramaRenderer(this);
+    connect(this->renderer, SIGNAL(frameReady(QImage,int,bool)), this, SLOT(frameReady_slot(QImage,int,bool)), Qt::QueuedConnection);
+
+    /* Create background full resolution loader */
+    this->loader = new PanoramaPrefetcher(this);
+    connect(this->loader, SIGNAL(loaded(QString)), this, SLOT(panoramaLoaded_slot(QString)), Qt::QueuedConnection);
 
     /* Initialize in rect containers */
     this->increation_rect.rect = NULL;
@@ -114,13 +128,30 @@ PanoramaViewer::PanoramaViewer(QWidget *parent, bool connectSlots) :
     /* Set sight width */
     this->sight_width = 800;
 
+    /* Objects visibility is reset on first update */
+    this->hide_all = true;
+
     /* Add sight to scene */
-    this->sight = this->scene->addRect( this->dest_image_map.width() / 2,
-                                        this->dest_image_map.height() / 2,
+    this->sight = this->scene->addRect( this->dest_size.width() / 2,
+                                        this->dest_size.height() / 2,
                                         this->sight_width,
                                         this->sight_width,
                                         sight_pen);
 
+    /* Add persistent pixmap to scene (panorama gnomonic), updated in place */
+    this->last_pixmap = this->scene->addPixmap(QPixmap());
+
+    /* Update z value (to see other objects */
+    this->last_pixmap->setZValue(-1);
+
+    /* Add frame times overlay (unscaled, above objects), F12 toggles it when tracing */
+    this->trace_overlay = this->scene->addSimpleText(QString());
+    this->trace_overlay->setBrush( Qt::yellow );
+    this->trace_overlay->setFlag( QGraphicsItem::ItemIgnoresTransformations );
+    this->trace_overlay->setPos( 10, 10 );
+    this->trace_overlay->setZValue( 1000 );
+    this->trace_overlay->setVisible( Trace::enabled() );
+
     /* Connect signal for labels refresh */
     if( connectSlots )
     {
@@ -129,6 +160,17 @@ PanoramaViewer::PanoramaViewer(QWidget *parent, bool connectSlots) :
     }
 }
 
+/* Destructor */
+PanoramaViewer::~PanoramaViewer()
+{
+    /* Detach objects from statistics and spatial index */
+    foreach(ObjectRect* rect, this->rect_list)
+    {
+        rect->setStatistics( NULL );
+        rect->setIndex( NULL );
+    }
+}
+
 /* Main setup function */
 void PanoramaViewer::setup(int width,
                            int height,
@@ -153,39 +195,159 @@ void PanoramaViewer::setup(int width,
 /* Function to load specified image */
 void PanoramaViewer::loadImage(QString path)
 {
-    /* Save image path */
-    this->image_path = path;
+    /* Panorama pixels covered by the view (default view needs a fraction of them) */
+    int view_width = (int) ( this->width() * this->scale_factor * ( 360.0 / this->position.aperture_delta ) );
+
+    /* Decode a reduced preview in DCT domain and show it immediately */
+    panorama_prefetch_struct preview = PanoramaPrefetcher::loadPreview( path, this->threads_count, view_width );
+    if( preview.cache != NULL )
+    {
+        /* Show preview */
+        this->setPanorama( preview );
+        this->preview_shown = true;
+
+        /* Decode full resolution in background, swapped in when loaded */
+        this->loader->setup( this->threads_count );
+        this->loader->prefetch( path );
+        return;
+    }
+
+    /* Load image and build its pyramid */
+    this->setPanorama( PanoramaPrefetcher::load( path, this->threads_count ) );
+}
+
+/* Slot for background decoded full resolution panoramas */
+void PanoramaViewer::panoramaLoaded_slot(QString path)
+{
+    /* Release panorama replaced meanwhile */
+    if( path != this->image_path )
+    {
+        this->loader->discard( path );
+        return;
+    }
+
+    /* Skip panorama already taken by a full resolution request */
+    if( !this->preview_shown )
+        return;
+
+    /* Replace preview */
+    this->requireFullResolution();
+}
+
+/* Function to replace the shown preview by the full resolution panorama, waiting for its background decoding (crops, thumbnails and edit views need it) */
+void PanoramaViewer::requireFullResolution()
+{
+    /* Check if a preview is shown */
+    if( !this->preview_shown )
+        return;
+
+    /* Take full resolution panorama (waits for in-flight decoding) */
+    this->preview_shown = false;
+    panorama_prefetch_struct panorama = this->loader->take( this->image_path );
+    if( panorama.cache == NULL )
+        return;
+
+    /* Wait for in-flight frame of preview */
+    this->renderer->sync();
+
+    /* Retire preview pyramid, displayed frame is kept until refined one arrives */
+    this->retired_caches.append( this->image_info.cache );
+    this->image_info.cache = panorama.cache;
+    this->image_info.cache->setMemoryBudget( this->cache_budget );
+
+    /* Render full resolution frame */
+    this->render();
+}
+
+/* Function to show a loaded panorama, replacing current one (takes ownership of its cache) */
+void PanoramaViewer::setPanorama(const panorama_prefetch_struct &panorama)
+{
+    /* Wait for in-flight frame of previous panorama */
+    this->renderer->sync();
 
-    /* Create a temporary image */
-    IplImage * temp_image = NULL;
+    /* Release previous panorama and its previews */
+    delete this->image_info.cache;
+    qDeleteAll( this->retired_caches );
+    this->retired_caches.clear();
 
-    /* Load image */
-    temp_image = cvLoadImage( path.toStdString().c_str(), CV_LOAD_IMAGE_UNCHANGED );
+    /* Save image path (full resolution is shown) */
+    this->image_path = panorama.path;
+    this->preview_shown = false;
 
     /* Save image details */
-    this->image_info.channels = (temp_image->nChannels + 1);
-    this->image_info.width = temp_image->width;
-    this->image_info.height = temp_image->height;
+    this->image_info.channels = panorama.channels;
+    this->image_info.width = panorama.width;
+    this->image_info.height = panorama.height;
 
-    /* Convert it to QImage */
-    this->image_info.image = IplImage2QImage( temp_image );
+    /* Assign image pyramid, detailed levels are sampled through tiles cache */
+    this->image_info.image = NULL;
+    this->image_info.cache = panorama.cache;
+    if( this->image_info.cache != NULL )
+        this->image_info.cache->setMemoryBudget( this->cache_budget );
 
-    /* Release temporary image */
-    cvReleaseImage( &temp_image );
+    /* Drop frames of previous panorama */
+    this->frame_generation = ++this->render_generation;
+    this->last_pixmap->setPixmap( QPixmap() );
 
     /* Render PanoramaViewer */
     this->render();
 }
 
+/* Function to remove and delete all objects */
+void PanoramaViewer::clearObjects()
+{
+    /* Reset objects references (pending edition is dropped) */
+    this->mode = PanoramaViewerMode::None;
+    this->increation_rect.rect = NULL;
+    this->selected_rect = NULL;
+    this->view_rects.clear();
+    this->shown_rects.clear();
+
+    /* Delete objects (removed from scene and statistics) */
+    qDeleteAll( this->rect_list );
+    this->rect_list.clear();
+
+    /* Reset id index */
+    this->rect_list_id_index = 1;
+
+    /* Spatial index is rebuilt on next query */
+    this->object_index.invalidate();
+    this->hide_all = true;
+
+    /* Refresh main window labels */
+    emit refreshLabels();
+}
+
+/* Function to get the panorama tiles cache memory budget (in bytes) */
+qint64 PanoramaViewer::cacheBudget()
+{
+    /* Return value */
+    return this->cache_budget;
+}
+
+/* Function to set the panorama tiles cache memory budget (in bytes) */
+void PanoramaViewer::setCacheBudget(qint64 bytes)
+{
+    /* Assign value */
+    this->cache_budget = bytes;
+
+    /* Update cache if already loaded */
+    if( this->image_info.cache != NULL )
+        this->image_info.cache->setMemoryBudget( bytes );
+}
+
 /* Function to update scene (viewer) */
 void PanoramaViewer::updateScene(float azimuth,
                                  float elevation,
                                  float zoom)
 {
     /* Exif if input image is not loaded */
-    if( this->image_info.image == NULL )
+    if( this->image_info.cache == NULL )
         return;
 
+    /* Trace zone */
+    TraceZone zone( "PanoramaViewer::updateScene" );
+
     /* Compute destination image size */
     int dest_width = this->width() * scale_factor;
     int dest_height = this->height() * scale_factor;
@@ -195,56 +357,30 @@ void PanoramaViewer::updateScene(float azimuth,
     float clamped_elevation = clamp(elevation, -90.0, 90.0);
 
     /* Save old size */
-    this->position.old_width = this->dest_image.width();
-    this->position.old_height = this->dest_image.height();
-
-    /* Allocate destination image */
-    this->dest_image = QImage (dest_width, dest_height, QImage::Format_RGB32);
-
-    /* Project gnomonic image */
-    lg_etg_apperturep(
-
-        ( inter_C8_t * ) this->image_info.image->bits(),
-        this->image_info.width,
-        this->image_info.height,
-        this->image_info.channels,
-        ( inter_C8_t * ) dest_image.bits(),
-        dest_width,
-        dest_height,
-        this->image_info.channels,
-        clamped_azimuth,
-        clamped_elevation,
-        0.0,
-        zoom,
-        li_bilinearf,
-        this->threads_count
-    );
-
-    /* Convert projected image to pixmap */
-    this->dest_image_map = QPixmap::fromImage(this->dest_image);
-
-    /* Check if pixmap has been already initialized */
-    if(this->pixmap_initialized)
-    {
-        /* Remove old pixmap */
-        this->scene->removeItem(this->last_pixmap);
-        delete this->last_pixmap;
-    } else {
-        /* Update value to true */
-        this->pixmap_initialized = true;
-    }
-
-    /* Add pixmap to scene (panorama gnomonic */
-    this->last_pixmap = this->scene->addPixmap(this->dest_image_map);
-
-    /* Update z value (to see other objects */
-    this->last_pixmap->setZValue(-1);
+    this->position.old_width = this->dest_size.width();
+    this->position.old_height = this->dest_size.height();
+
+    /* Update destination size */
+    this->dest_size = QSize(dest_width, dest_height);
+
+    /* Request a progressive frame from the background renderer */
+    panorama_render_request_struct request;
+    request.cache = this->image_info.cache;
+    request.azimuth = clamped_azimuth;
+    request.elevation = clamped_elevation;
+    request.aperture = zoom;
+    request.width = dest_width;
+    request.height = dest_height;
+    request.threads = this->threads_count;
+    request.generation = ++this->render_generation;
+    this->request_time = Trace::enabled() ? Trace::now() : -1;
+    this->renderer->request( request );
 
     /* Set scene boundaries */
-    this->scene->setSceneRect(this->dest_image_map.rect());
+    this->scene->setSceneRect(QRect(QPoint(0, 0), this->dest_size));
 
     /* Fit image in scene */
-    this->fitInView(this->dest_image_map.rect());
+    this->fitInView(QRect(QPoint(0, 0), this->dest_size));
 
     /* Update sight position */
     this->sight->setPos( QPointF( (dest_width / 2) - ((this->sight_width / 2) * (this->scale_factor / this->position.aperture)),
@@ -254,9 +390,94 @@ void PanoramaViewer::updateScene(float azimuth,
     this->sight->setScale( this->scale_factor / this->position.aperture );
 }
 
+/* Slot for background rendered frames */
+void PanoramaViewer::frameReady_slot(QImage frame, int generation, bool final)
+{
+    /* Drop frames older than the displayed one */
+    if( generation < this->frame_generation )
+        return;
+
+    /* Trace zone */
+    TraceZone zone( "PanoramaViewer::frameReady" );
+
+    /* Record latency from request to display of latest frame */
+    if( generation == this->render_generation && this->request_time >= 0 && Trace::enabled() )
+        Trace::record( final ? "PanoramaViewer::frameLatency" : "PanoramaViewer::draftLatency", this->request_time, Trace::now() - this->request_time );
+
+    /* Save displayed frame generation */
+    this->frame_generation = generation;
+
+    /* Select draft/refined pixmap buffer */
+    QPixmap &target = this->frame_pixmaps[ final ? 1 : 0 ];
+
+    /* Release item reference so the buffer is painted without detaching */
+    this->last_pixmap->setPixmap(QPixmap());
+
+    /* Reallocate buffer only on size change */
+    if( target.size() != frame.size() )
+        target = QPixmap(frame.size());
+
+    /* Copy frame into buffer */
+    {
+        TraceZone upload_zone( "PanoramaViewer::uploadFrame" );
+        QPainter painter(&target);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(0, 0, frame);
+        painter.end();
+    }
+
+    /* Update pixmap item */
+    this->last_pixmap->setPixmap(target);
+
+    /* Stretch reduced resolution frames over the scene */
+    this->last_pixmap->setTransform(QTransform::fromScale( (qreal) this->dest_size.width() / frame.width(),
+                                                           (qreal) this->dest_size.height() / frame.height() ));
+
+    /* Smooth refined frames only, drafts must stay cheap */
+    this->last_pixmap->setTransformationMode( final ? Qt::SmoothTransformation : Qt::FastTransformation );
+
+    /* Update frame times overlay */
+    if( final && this->trace_overlay->isVisible() )
+        this->updateTraceOverlay();
+}
+
+/* Function to update frame times overlay */
+void PanoramaViewer::updateTraceOverlay()
+{
+    /* Overlayed zones (mean of last frames, in milliseconds) */
+    static const char* zones[] = {
+        "PanoramaViewer::frameLatency",
+        "PanoramaViewer::draftLatency",
+        "PanoramaRenderer::frame",
+        "PanoramaRenderer::draft",
+        "PanoramaViewer::uploadFrame",
+        "PanoramaViewer::render",
+        "PanoramaViewer::updateScene",
+        "PanoramaViewer::queryView",
+        "PanoramaViewer::mapObjects",
+        "PanoramaViewer::applyVisGroup",
+        "PanoramaViewer::showObjects"
+    };
+
+    /* Build overlay text */
+    QString text;
+    for (unsigned int i = 0; i < sizeof( zones ) / sizeof( zones[0] ); i++)
+    {
+        double average = Trace::average( zones[i] );
+        if( average >= 0.0 )
+            text += QString("%1 %2 ms\n").arg( zones[i] ).arg( average, 0, 'f', 2 );
+    }
+
+    /* Assign text */
+    this->trace_overlay->setText( text.trimmed() );
+}
+
 /* Function to render panorama and all objects */
 void PanoramaViewer::render()
 {
+    /* Trace zone */
+    TraceZone zone( "PanoramaViewer::render" );
+
     /* Call scene update procedure */
     this->updateScene(
         this->position.azimuth,
@@ -264,15 +485,20 @@ void PanoramaViewer::render()
         this->position.aperture
     );
 
-    /* Iterate over objects */
-    foreach(ObjectRect* rect, this->rect_list)
+    /* Get objects near current view */
+    this->queryView();
+
+    /* Iterate over objects near current view */
+    foreach(ObjectRect* rect, this->view_rects)
     {
         /* Object size filtering check */
         if( rect->getSize().width() < 1 ||
                rect->getSize().height() < 1 )
         {
-            /* Remove rect from list */
+            /* Remove rect from lists */
             this->rect_list.removeOne( rect );
+            this->view_rects.removeOne( rect );
+            this->shown_rects.remove( rect );
             delete rect;
 
             /* Refresh main window labels */
@@ -280,7 +506,7 @@ void PanoramaViewer::render()
         } else {
 
             /* Check if object is manual */
-            if(rect->getAutomaticStatus() == "None")
+            if(rect->getAutomaticStatus() == ObjectAutomaticStatus::None)
             {
                 /* Check if current parameter are the same as object's projection parameters */
                 if( rect->proj_azimuth() != this->position.azimuth ||
@@ -299,18 +525,69 @@ void PanoramaViewer::render()
                 /* Disable resizing */
                 rect->setResizeEnabled( false );
             }
-
-            /* Map object to current projection parameters */
-            rect->mapTo(this->dest_image_map.width(),
-                        this->dest_image_map.height(),
-                        this->position.azimuth,
-                        this->position.elevation,
-                        this->position.aperture);
         }
     }
 
-    /* Apply visibility groups */
-    this->applyVisGroup();
+    /* Map objects near current view to current projection parameters in one pass */
+    {
+        TraceZone map_zone( "PanoramaViewer::mapObjects" );
+        this->corners.map(this->view_rects,
+                          this->dest_size.width(),
+                          this->dest_size.height(),
+                          this->position.azimuth,
+                          this->position.elevation,
+                          this->position.aperture);
+    }
+
+    /* Apply visibility groups (objects already mapped) */
+    this->applyVisGroup( true );
+}
+
+/* Function to get objects near current view from spatial index */
+void PanoramaViewer::queryView()
+{
+    /* Trace zone */
+    TraceZone zone( "PanoramaViewer::queryView" );
+
+    /* Query index, all objects visibility is reset if it was rebuilt */
+    if( this->object_index.query(this->rect_list,
+                                 this->dest_size.width(),
+                                 this->dest_size.height(),
+                                 this->position.azimuth,
+                                 this->position.elevation,
+                                 this->position.aperture,
+                                 this->view_rects) )
+    {
+        this->hide_all = true;
+    }
+}
+
+/* Function to show specified objects and hide previously shown ones */
+void PanoramaViewer::showObjects(const QSet<ObjectRect*> &visible)
+{
+    /* Trace zone */
+    TraceZone zone( "PanoramaViewer::showObjects" );
+
+    /* Hide objects leaving the view (all objects if list changed) */
+    foreach(ObjectRect* obj, this->hide_all ? this->rect_list : this->shown_rects.toList())
+    {
+        if( !visible.contains( obj ) )
+            obj->setVisible( false );
+    }
+
+    /* Hide object in creation too (not in objects list yet) */
+    if( this->hide_all && this->increation_rect.rect != NULL && !visible.contains( this->increation_rect.rect ) )
+        this->increation_rect.rect->setVisible( false );
+
+    /* Show visible objects */
+    foreach(ObjectRect* obj, visible)
+    {
+        obj->setVisible( true );
+    }
+
+    /* Update shown objects */
+    this->shown_rects = visible;
+    this->hide_all = false;
 }
 
 /* Function to update zoom of current scene */
@@ -533,6 +810,7 @@ void PanoramaViewer::mouseDoubleClickEvent(QMouseEvent *event)
             else if ( event->buttons() == Qt::LeftButton )
             {
                 /* Create and show a new edition window */
+                this->requireFullResolution();
                 EditView* w = new EditView(this, clicked_rect, this->image_info, NULL, EditMode::Scene);
                 w->setAttribute( Qt::WA_DeleteOnClose );
                 w->show();
@@ -611,7 +889,7 @@ void PanoramaViewer::mouseMoveEvent(QMouseEvent* event)
             this->increation_rect.rect->setObjectAutomaticState( ObjectAutomaticState::Manual );
             this->increation_rect.rect->setObjectManualState( ObjectManualState::Valid );
             this->increation_rect.rect->setObjectType( ObjectType::None );
-            this->increation_rect.rect->setManualStatus( "Valid" );
+            this->increation_rect.rect->setManualStatus( ObjectManualStatus::Valid );
             this->increation_rect.rect->setBlurred( true );
 
             /* Assign id to object */
@@ -621,8 +899,8 @@ void PanoramaViewer::mouseMoveEvent(QMouseEvent* event)
             this->increation_rect.rect->setProjectionParametters(this->position.azimuth,
                     this->position.elevation,
                     this->position.aperture,
-                    this->dest_image.width(),
-                    this->dest_image.height());
+                    this->dest_size.width(),
+                    this->dest_size.height());
 
             /* Set object source image path */
             this->increation_rect.rect->setSourceImagePath( this->image_path );
@@ -636,7 +914,7 @@ void PanoramaViewer::mouseMoveEvent(QMouseEvent* event)
             );
 
             /* Add object to scene */
-            this->rect_list.append( this->increation_rect.rect );
+            this->appendObject( this->increation_rect.rect );
             this->scene->addItem( this->increation_rect.rect );
 
             /* Refresh vis groups */
@@ -704,8 +982,8 @@ void PanoramaViewer::mouseMoveEvent(QMouseEvent* event)
         this->selected_rect->setProjectionParametters(this->position.azimuth,
                 this->position.elevation,
                 this->position.aperture,
-                this->dest_image.width(),
-                this->dest_image.height());
+                this->dest_size.width(),
+                this->dest_size.height());
 
         /* Set projection points */
         this->selected_rect->setProjectionPoints();
@@ -749,8 +1027,8 @@ void PanoramaViewer::mouseMoveEvent(QMouseEvent* event)
         this->selected_rect->setProjectionParametters(this->position.azimuth,
                 this->position.elevation,
                 this->position.aperture,
-                this->dest_image.width(),
-                this->dest_image.height());
+                this->dest_size.width(),
+                this->dest_size.height());
 
         /* Set projection points */
         this->selected_rect->setProjectionPoints();
@@ -788,6 +1066,13 @@ void PanoramaViewer::keyPressEvent(QKeyEvent *event)
     /* Check if CTRL key is pressed */
     if(event->key() == Qt::Key_Control)
         this->pressed_keys.CTRL = true;
+
+    /* Toggle frame times overlay when tracing */
+    if(event->key() == Qt::Key_F12 && Trace::enabled())
+    {
+        this->trace_overlay->setVisible( !this->trace_overlay->isVisible() );
+        this->updateTraceOverlay();
+    }
 }
 
 /* Key release event */
@@ -797,8 +1082,8 @@ void PanoramaViewer::keyReleaseEvent(QKeyEvent *)
     this->pressed_keys.CTRL = false;
 }
 
-/* Function to crop an image from object */
-QImage PanoramaViewer::cropObject(ObjectRect* rect)
+/* Function to get object selection in its crop view */
+QRect PanoramaViewer::cropSelection(ObjectRect* rect)
 {
     /* Copy rect */
     ObjectRect* rect_mapped = rect->copy();
@@ -822,30 +1107,44 @@ QImage PanoramaViewer::cropObject(ObjectRect* rect)
     /* Delete temp rect */
     delete rect_mapped;
 
-    /* Create temporary destination image */
-    QImage temp_dest(this->width(), this->height(), QImage::Format_RGB32);
+    /* Return selection */
+    return rect_sel;
+}
 
-    /* Project gnomonic image */
-    lg_etg_apperturep(
+/* Function to crop an image from object */
+QImage PanoramaViewer::cropObject(ObjectRect* rect)
+{
+    /* Get selection */
+    QRect rect_sel = this->cropSelection( rect );
+
+    /* Check selection */
+    if( rect_sel.isEmpty() )
+        return QImage();
+
+    /* Crops are sampled from full resolution, never from preview */
+    this->requireFullResolution();
+
+    /* Create destination image (selection only) */
+    QImage temp_dest(rect_sel.size(), QImage::Format_RGB32);
 
-        ( inter_C8_t * ) this->image_info.image->bits(),
-        this->image_info.width,
-        this->image_info.height,
-        this->image_info.channels,
-        ( inter_C8_t * ) temp_dest.bits(),
+    /* Project selection window of gnomonic image from full resolution level (one-shot map, not cached) */
+    this->image_info.cache->projectWindow(
+        &temp_dest,
         this->width(),
         this->height(),
-        this->image_info.channels,
+        rect_sel,
         rect->proj_azimuth(),
         rect->proj_elevation(),
-        0.0,
         rect->proj_aperture(),
-        li_bilinearf,
-        this->threads_count
+        0,
+        this->threads_count,
+        ProjectionInterpolation::Bilinear,
+        NULL,
+        false
     );
 
-    /* Crop and return image */
-    return temp_dest.copy(rect_sel);
+    /* Return image */
+    return temp_dest;
 
 }
 
@@ -862,72 +1161,27 @@ void PanoramaViewer::backupPosition()
 bool PanoramaViewer::isObjectVisible(ObjectRect *rect)
 {
 
-    /* Check if point 1 is visible */
-    int state = g2g_point(rect->proj_width(),
-                          rect->proj_height(),
-                          rect->proj_azimuth(),
-                          rect->proj_elevation(),
-                          rect->proj_aperture(),
-                          rect->proj_point_1().x(),
-                          rect->proj_point_1().y(),
-
-                          this->dest_image_map.width(),
-                          this->dest_image_map.height(),
-                          this->position.azimuth,
-                          this->position.elevation,
-                          this->position.aperture);
+    /* Object points */
+    double r_x[4] = { rect->proj_point_1().x(), rect->proj_point_2().x(), rect->proj_point_3().x(), rect->proj_point_4().x() };
+    double r_y[4] = { rect->proj_point_1().y(), rect->proj_point_2().y(), rect->proj_point_3().y(), rect->proj_point_4().y() };
 
-    /* Check if point 2 is visible */
-    int state2 = g2g_point(rect->proj_width(),
-                           rect->proj_height(),
-                           rect->proj_azimuth(),
-                           rect->proj_elevation(),
-                           rect->proj_aperture(),
-                           rect->proj_point_2().x(),
-                           rect->proj_point_2().y(),
-
-                           this->dest_image_map.width(),
-                           this->dest_image_map.height(),
-                           this->position.azimuth,
-                           this->position.elevation,
-                           this->position.aperture);
-
-    /* Check if point 3 is visible */
-    int state3 = g2g_point(rect->proj_width(),
-                           rect->proj_height(),
-                           rect->proj_azimuth(),
-                           rect->proj_elevation(),
-                           rect->proj_aperture(),
-                           rect->proj_point_3().x(),
-                           rect->proj_point_3().y(),
-
-                           this->dest_image_map.width(),
-                           this->dest_image_map.height(),
-                           this->position.azimuth,
-                           this->position.elevation,
-                           this->position.aperture);
-
-    /* Check if point 4 is visible */
-    int state4 = g2g_point(rect->proj_width(),
-                           rect->proj_height(),
-                           rect->proj_azimuth(),
-                           rect->proj_elevation(),
-                           rect->proj_aperture(),
-                           rect->proj_point_4().x(),
-                           rect->proj_point_4().y(),
-
-                           this->dest_image_map.width(),
-                           this->dest_image_map.height(),
-                           this->position.azimuth,
-                           this->position.elevation,
-                           this->position.aperture);
-
-    /* Return proper result */
-    if( state != 1 || state2 != 1 || state3 != 1 || state4 != 1) {
-        return false;
-    } else {
-        return true;
-    }
+    /* Transformation between object and view projections */
+    g2g_transform t;
+    g2g_transform_init(&t,
+                       rect->proj_width(),
+                       rect->proj_height(),
+                       rect->proj_azimuth(),
+                       rect->proj_elevation(),
+                       rect->proj_aperture(),
+
+                       this->dest_size.width(),
+                       this->dest_size.height(),
+                       this->position.azimuth,
+                       this->position.elevation,
+                       this->position.aperture);
+
+    /* Object is visible if its 4 points are */
+    return ( g2g_points( &t, 4, r_x, r_y ) == 4 );
 }
 
 /* Function to set the visibility group */
@@ -938,82 +1192,75 @@ void PanoramaViewer::setVisGroup(int visgroup)
 }
 
 /* Function to apply visibility groups */
-void PanoramaViewer::applyVisGroup()
+void PanoramaViewer::applyVisGroup(bool mapped)
 {
+    /* Trace zone */
+    TraceZone zone( "PanoramaViewer::applyVisGroup" );
+
+    /* Visible objects container */
+    QSet<ObjectRect*> visible;
+
+    /* Compute visibility of objects near current view in one pass */
+    if( !mapped && this->vis_group != PanoramaViewerVisGroups::InCreation )
+    {
+        /* Get objects near current view */
+        this->queryView();
+
+        /* Map objects corners */
+        this->corners.map(this->view_rects,
+                          this->dest_size.width(),
+                          this->dest_size.height(),
+                          this->position.azimuth,
+                          this->position.elevation,
+                          this->position.aperture,
+                          false);
+    }
+
     /* Main visibility group switch */
     switch (this->vis_group) {
 
     case PanoramaViewerVisGroups::All:
 
-        /* Iterate over objects */
-        foreach(ObjectRect* obj, this->rect_list)
+        /* Iterate over objects near current view */
+        for (int i = 0; i < this->view_rects.size(); i++)
         {
             /* Check if object is visible */
-            if( this->isObjectVisible( obj ) ){
-                obj->setVisible( true );
-            } else {
-                obj->setVisible( false );
-            }
+            if( this->corners.isVisible( i ) )
+                visible.insert( this->view_rects.at(i) );
         }
         break;
     case PanoramaViewerVisGroups::Automatic:
 
-        /* Iterate over objects */
-        foreach(ObjectRect* obj, this->rect_list)
+        /* Iterate over objects near current view */
+        for (int i = 0; i < this->view_rects.size(); i++)
         {
-            /* Check if object is visible */
-            if( this->isObjectVisible( obj ) )
-            {
-                /* Check object is automatic */
-                if( obj->getAutomaticStatus().toLower() != "none" )
-                {
-                    obj->setVisible( true );
-                } else {
-                    obj->setVisible( false );
-                }
-            } else {
-                obj->setVisible( false );
-            }
+            /* Check if object is visible and automatic */
+            if( this->corners.isVisible( i ) && this->view_rects.at(i)->getAutomaticStatus() != ObjectAutomaticStatus::None )
+                visible.insert( this->view_rects.at(i) );
         }
         break;
     case PanoramaViewerVisGroups::Manual:
 
-        /* Iterate over objects */
-            foreach(ObjectRect* obj, this->rect_list)
-            {
-                /* Check if object is visible */
-                if( this->isObjectVisible( obj ) )
-                {
-                    /* Check if object is manual */
-                    if( obj->getAutomaticStatus().toLower() == "none" )
-                    {
-                        obj->setVisible( true );
-                    } else {
-                        obj->setVisible( false );
-                    }
-                } else {
-                    obj->setVisible( false );
-                }
-            }
+        /* Iterate over objects near current view */
+        for (int i = 0; i < this->view_rects.size(); i++)
+        {
+            /* Check if object is visible and manual */
+            if( this->corners.isVisible( i ) && this->view_rects.at(i)->getAutomaticStatus() == ObjectAutomaticStatus::None )
+                visible.insert( this->view_rects.at(i) );
+        }
         break;
     case PanoramaViewerVisGroups::InCreation:
 
-        /* Iterate over objects */
-        foreach(ObjectRect* obj, this->rect_list)
-        {
-             obj->setVisible( false );
-        }
+        /* All objects are hidden */
+        this->hide_all = true;
 
         /* Check if in creation rect is valid */
         if( this->increation_rect.rect != NULL )
         {
             /* Check if object is visible */
             if( this->isObjectVisible( this->increation_rect.rect ) )
-            {
-                this->increation_rect.rect->setVisible( true );
-            } else {
-                this->increation_rect.rect->setVisible( false );
-            }
+                visible.insert( this->increation_rect.rect );
+
         } else {
 
             /* Check if scene have objects defined */
@@ -1021,15 +1268,14 @@ void PanoramaViewer::applyVisGroup()
             {
                 /* Check if last object is visible */
                 if( this->isObjectVisible( this->rect_list.last() ) )
-                {
-                    this->rect_list.last()->setVisible( true );
-                } else {
-                    this->rect_list.last()->setVisible( false );
-                }
+                    visible.insert( this->rect_list.last() );
             }
         }
         break;
     }
+
+    /* Apply visibility */
+    this->showObjects( visible );
 }
 
 /* Function to determine if a point is in sight */
@@ -1118,6 +1364,23 @@ void PanoramaViewer::updateScaleSlider_slot(int value)
     emit updateScaleSlider(value);
 }
 
+/* Function to append an object to main ObjectRect list (objects are counted in statistics and indexed) */
+void PanoramaViewer::appendObject(ObjectRect* rect)
+{
+    /* Append object */
+    this->rect_list.append( rect );
+
+    /* Count and index object */
+    rect->setStatistics( &this->stats );
+    rect->setIndex( &this->object_index );
+}
+
+/* Function to get objects statistics */
+ObjectStats* PanoramaViewer::statistics()
+{
+    return &this->stats;
+}
+
 /* Function to get current scene */
 QGraphicsScene* PanoramaViewer::getScene()
 {
@@ -0,0 +1,183 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "projection.h"
+
+/* Function to compute equirectangular source coordinates of a gnomonic viewport window */
+void projection_coordinates(
+
+    qint32 * const coords,
+    int      const e_width,
+    int      const e_height,
+    int      const c_width,
+    int      const c_height,
+    int      const w_x,
+    int      const w_y,
+    int      const w_width,
+    int      const w_height,
+    double   const c_azim,
+    double   const c_elev,
+    double   const c_appe,
+    int      const threads,
+    QAtomicInt const * const cancel
+
+) {
+
+    /* Matrix array */
+    double m[3][3] = { { 0.0 } };
+
+    /* Create rotation matrix */
+    lg_algebra_r2erotation( m, c_azim, c_elev, 0 );
+
+    /* Compute pixel size */
+    double c_pixel = 2.0 * tan( c_appe / 2.0 ) / c_width;
+
+    /* Iterate over window Y axis */
+    #pragma omp parallel for num_threads( threads ) schedule( static )
+    for( int y = 0; y < w_height; y++ )
+    {
+        /* Skip remaining rows on cancellation */
+        if( cancel && cancel->load() ) continue;
+
+        /* Compute position in reference rectilinear frame (Y) */
+        double p_y = ( ( w_y + y ) - ( c_height / 2.0 ) ) * c_pixel;
+
+        /* Get destination row */
+        qint32 * row = coords + ( 2 * y * w_width );
+
+        /* Iterate over window X axis */
+        for( int x = 0; x < w_width; x++ )
+        {
+            /* Compute position in reference rectilinear frame (X) */
+            double p_x = ( ( w_x + x ) - ( c_width / 2.0 ) ) * c_pixel;
+
+            /* Apply rotation on position */
+            double pf_0 = m[0][0] + m[0][1] * p_x + m[0][2] * p_y;
+            double pf_1 = m[1][0] + m[1][1] * p_x + m[1][2] * p_y;
+            double pf_2 = m[2][0] + m[2][1] * p_x + m[2][2] * p_y;
+
+            /* Compute spherical angles */
+            double s_x = atan2( pf_1, pf_0 );
+            double s_y = asin( pf_2 / sqrt( pf_0 * pf_0 + pf_1 * pf_1 + pf_2 * pf_2 ) );
+
+            /* Wrap azimuth angle */
+            if( s_x < 0.0 ) s_x += LG_PI2;
+
+            /* Compute equirectangular fixed point coordinates */
+            row[ 2 * x     ] = (qint32) ( ( s_x / LG_PI2 ) * e_width * PROJECTION_FIXED_ONE + 0.5 );
+            row[ 2 * x + 1 ] = (qint32) ( ( ( s_y / LG_PI ) + 0.5 ) * e_height * PROJECTION_FIXED_ONE + 0.5 );
+        }
+    }
+}
+
+/* Function to sample a contiguous equirectangular image */
+void projection_gather(
+
+    qint32 const * const coords,
+    QRgb   const * const e_bits,
+    int            const e_width,
+    int            const e_height,
+    int            const e_stride,
+    QRgb         * const c_bits,
+    int            const c_width,
+    int            const c_height,
+    int            const c_stride,
+    int            const interp,
+    int            const threads,
+    QAtomicInt const * const cancel
+
+) {
+
+    /* Maximal fixed point vertical coordinate */
+    qint32 y_max = ( e_height - 1 ) << PROJECTION_FIXED_SHIFT;
+
+    /* Iterate over rectilinear image Y axis */
+    #pragma omp parallel for num_threads( threads ) schedule( static )
+    for( int y = 0; y < c_height; y++ )
+    {
+        /* Skip remaining rows on cancellation */
+        if( cancel && cancel->load() ) continue;
+
+        /* Get source coordinates and destination rows */
+        qint32 const * coord = coords + ( 2 * y * c_width );
+        QRgb * row = c_bits + ( y * c_stride );
+
+        /* Nearest neighbour sampling */
+        if( interp == ProjectionInterpolation::Nearest )
+        {
+            /* Iterate over rectilinear image X axis */
+            for( int x = 0; x < c_width; x++ )
+            {
+                /* Round coordinates and wrap/clamp them */
+                int x0 = ( ( coord[ 2 * x ] + ( PROJECTION_FIXED_ONE / 2 ) ) >> PROJECTION_FIXED_SHIFT ) % e_width;
+                int y0 = ( qBound( 0, coord[ 2 * x + 1 ] + ( PROJECTION_FIXED_ONE / 2 ), y_max ) ) >> PROJECTION_FIXED_SHIFT;
+
+                /* Copy pixel */
+                row[ x ] = e_bits[ ( y0 * e_stride ) + x0 ];
+            }
+
+            /* Next row */
+            continue;
+        }
+
+        /* Iterate over rectilinear image X axis */
+        for( int x = 0; x < c_width; x++ )
+        {
+            /* Split coordinates into integer and fixed point fractional parts */
+            qint32 s_x = coord[ 2 * x ];
+            qint32 s_y = qBound( 0, coord[ 2 * x + 1 ], y_max );
+            int x0 = s_x >> PROJECTION_FIXED_SHIFT;
+            int y0 = s_y >> PROJECTION_FIXED_SHIFT;
+            int wx = s_x & PROJECTION_FIXED_MASK;
+            int wy = s_y & PROJECTION_FIXED_MASK;
+
+            /* Wrap/clamp neighbour coordinates */
+            x0 = x0 % e_width;
+            int x1 = ( x0 + 1 ) < e_width ? ( x0 + 1 ) : 0;
+            int y1 = ( y0 + 1 ) < e_height ? ( y0 + 1 ) : y0;
+
+            /* Get source rows */
+            QRgb const * r0 = e_bits + ( y0 * e_stride );
+            QRgb const * r1 = e_bits + ( y1 * e_stride );
+
+            /* Interpolate pixel */
+            row[ x ] = projection_bilinear( r0[ x0 ], r0[ x1 ], r1[ x0 ], r1[ x1 ], wx, wy );
+        }
+    }
+}
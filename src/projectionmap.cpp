@@ -0,0 +1,133 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include <string.h>
+
+#include "projectionmap.h"
+
+/* Function to get the process wide maps cache */
+ProjectionMapCache* ProjectionMapCache::instance()
+{
+    /* Shared instance */
+    static ProjectionMapCache cache;
+
+    /* Return result */
+    return &cache;
+}
+
+/* Constructor */
+ProjectionMapCache::ProjectionMapCache()
+{
+    /* Default memory settings */
+    this->setMemoryBudget( (qint64) 64 * 1024 * 1024 );
+}
+
+/* Function to set the maps memory budget (in bytes) */
+void ProjectionMapCache::setMemoryBudget(qint64 bytes)
+{
+    /* Assign value */
+    QMutexLocker locker(&this->maps_mutex);
+    this->maps_cache.setMaxCost( (int) (bytes / 1024) );
+}
+
+/* Function to get the fixed point coordinates map of a view window, computing it if missing */
+QVector<qint32> ProjectionMapCache::map(int e_width,
+                                        int e_height,
+                                        int c_width,
+                                        int c_height,
+                                        const QRect &window,
+                                        float azimuth,
+                                        float elevation,
+                                        float aperture,
+                                        int threads,
+                                        const QAtomicInt* cancel)
+{
+    /* Build key (zeroed for hashing padding bytes) */
+    projection_map_key_struct key;
+    memset( &key, 0, sizeof( key ) );
+    key.e_width = e_width;
+    key.e_height = e_height;
+    key.c_width = c_width;
+    key.c_height = c_height;
+    key.w_x = window.x();
+    key.w_y = window.y();
+    key.w_width = window.width();
+    key.w_height = window.height();
+    key.azimuth = azimuth;
+    key.elevation = elevation;
+    key.aperture = aperture;
+
+    /* Look for map in cache, sharing its data */
+    this->maps_mutex.lock();
+    QVector<qint32> *cached = this->maps_cache.object( key );
+    if( cached != NULL )
+    {
+        QVector<qint32> result = *cached;
+        this->maps_mutex.unlock();
+        return result;
+    }
+    this->maps_mutex.unlock();
+
+    /* Compute map */
+    QVector<qint32> result( 2 * window.width() * window.height() );
+    projection_coordinates(result.data(),
+                           e_width,
+                           e_height,
+                           c_width,
+                           c_height,
+                           window.x(),
+                           window.y(),
+                           window.width(),
+                           window.height(),
+                           azimuth,
+                           elevation,
+                           aperture,
+                           threads,
+                           cancel);
+
+    /* Insert map into cache unless incomplete */
+    if( !(cancel && cancel->load()) )
+    {
+        QMutexLocker locker(&this->maps_mutex);
+        this->maps_cache.insert( key, new QVector<qint32>( result ), (result.size() * sizeof(qint32)) / 1024 );
+    }
+
+    /* Return result */
+    return result;
+}
@@ -0,0 +1,191 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "thumbnailloader.h"
+
+/* Constructor */
+ThumbnailLoader::ThumbnailLoader(PanoramaCache* cache, QObject *parent) :
+    QObject(parent)
+{
+    /* Assign source panorama */
+    this->cache = cache;
+
+    /* Initialize queue */
+    this->next_index = 0;
+    this->workers = 0;
+
+    /* One worker per core, each thumbnail is projected on a single thread */
+    this->pool.setMaxThreadCount( QThread::idealThreadCount() );
+}
+
+/* Destructor (cancels pending jobs and waits for running ones) */
+ThumbnailLoader::~ThumbnailLoader()
+{
+    /* Cancel pending jobs */
+    this->cancel();
+
+    /* Wait for running jobs */
+    this->pool.waitForDone();
+}
+
+/* Function to queue a thumbnail, returns its index */
+int ThumbnailLoader::append(const thumbnail_job_struct &job)
+{
+    /* Append job */
+    QMutexLocker locker(&this->mutex);
+    this->jobs.append( job );
+    this->states.append( ThumbnailState::Queued );
+
+    /* Start a new worker if possible */
+    if( this->workers < this->pool.maxThreadCount() )
+    {
+        this->workers++;
+        this->pool.start( new ThumbnailTask( this ) );
+    }
+
+    /* Return job index */
+    return this->jobs.size() - 1;
+}
+
+/* Function to move specified thumbnails ahead of the queue */
+void ThumbnailLoader::prioritize(const QList<int> &indexes)
+{
+    /* Replace prioritized jobs */
+    QMutexLocker locker(&this->mutex);
+    this->priority.clear();
+
+    /* Keep only queued jobs */
+    foreach(int index, indexes)
+    {
+        if( index >= 0 && index < this->states.size() && this->states.at(index) == ThumbnailState::Queued )
+            this->priority.append( index );
+    }
+}
+
+/* Function to cancel all pending thumbnails */
+void ThumbnailLoader::cancel()
+{
+    /* Mark all queued jobs as done */
+    QMutexLocker locker(&this->mutex);
+    for (int i = 0; i < this->states.size(); i++)
+    {
+        if( this->states.at(i) == ThumbnailState::Queued )
+            this->states[i] = ThumbnailState::Done;
+    }
+
+    /* Clear prioritized jobs */
+    this->priority.clear();
+}
+
+/* Function to take next job index, -1 when queue is empty */
+int ThumbnailLoader::takeJob()
+{
+    /* Job index */
+    int index = -1;
+
+    /* Take prioritized jobs first */
+    while( index < 0 && !this->priority.isEmpty() )
+    {
+        int candidate = this->priority.takeFirst();
+        if( this->states.at(candidate) == ThumbnailState::Queued )
+            index = candidate;
+    }
+
+    /* Then follow insertion order */
+    while( index < 0 && this->next_index < this->states.size() )
+    {
+        int candidate = this->next_index++;
+        if( this->states.at(candidate) == ThumbnailState::Queued )
+            index = candidate;
+    }
+
+    /* Mark job as running */
+    if( index >= 0 )
+        this->states[index] = ThumbnailState::Running;
+
+    /* Return result */
+    return index;
+}
+
+/* Function to process queued thumbnails (called from pool threads) */
+void ThumbnailLoader::process()
+{
+    /* Process jobs until queue is empty */
+    while( true )
+    {
+        /* Take next job */
+        this->mutex.lock();
+        int index = this->takeJob();
+
+        /* Stop worker on empty queue */
+        if( index < 0 )
+        {
+            this->workers--;
+            this->mutex.unlock();
+            return;
+        }
+
+        /* Copy job */
+        thumbnail_job_struct job = this->jobs.at(index);
+        this->mutex.unlock();
+
+        /* Project selection window from full resolution level (one-shot map, not cached) */
+        QImage image( job.window.size(), QImage::Format_RGB32 );
+        this->cache->projectWindow( &image,
+                                    job.view_width,
+                                    job.view_height,
+                                    job.window,
+                                    job.azimuth,
+                                    job.elevation,
+                                    job.aperture,
+                                    0,
+                                    1,
+                                    ProjectionInterpolation::Bilinear,
+                                    NULL,
+                                    false );
+
+        /* Mark job as done */
+        this->mutex.lock();
+        this->states[index] = ThumbnailState::Done;
+        this->mutex.unlock();
+
+        /* Deliver thumbnail */
+        emit thumbnailReady( index, image );
+    }
+}
@@ -0,0 +1,215 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "trace.h"
+
+/* Tracing state */
+QAtomicInt Trace::active( 0 );
+QAtomicInt Trace::head( 0 );
+trace_slot_struct* Trace::ring = NULL;
+QElapsedTimer Trace::clock;
+
+/* Function to enable/disable tracing (ring buffer is allocated on first enable) */
+void Trace::setEnabled(bool value)
+{
+    /* Allocate ring buffer and start clock once, both are kept for recording zones */
+    if( value && Trace::ring == NULL )
+    {
+        Trace::ring = new trace_slot_struct[TRACE_RING_SIZE]();
+        Trace::clock.start();
+    }
+
+    /* Assign state (ring buffer is visible before zones are recorded) */
+    Trace::active.storeRelease( value ? 1 : 0 );
+}
+
+/* Function to get current trace time (in nanoseconds) */
+qint64 Trace::now()
+{
+    /* Return value */
+    return Trace::clock.nsecsElapsed();
+}
+
+/* Function to record a completed zone */
+void Trace::record(const char* name, qint64 start, qint64 duration)
+{
+    /* Check state */
+    if( !Trace::enabled() )
+        return;
+
+    /* Reserve slot (oldest events are overwritten) */
+    unsigned int number = (unsigned int) Trace::head.fetchAndAddRelaxed( 1 );
+    trace_slot_struct &slot = Trace::ring[ number & ( TRACE_RING_SIZE - 1 ) ];
+
+    /* Unpublish slot before writing it (full barrier, readers skip it meanwhile) */
+    slot.sequence.fetchAndStoreOrdered( 0 );
+
+    /* Assign event */
+    slot.event.name = name;
+    slot.event.start = start;
+    slot.event.duration = duration;
+    slot.event.thread = (quintptr) QThread::currentThreadId();
+
+    /* Publish event */
+    slot.sequence.storeRelease( (int) ( number + 1 ) );
+}
+
+/* Function to read the published event of specified number, returns false if it is not (or no longer) available */
+bool Trace::readEvent(unsigned int number, trace_event_struct &event)
+{
+    /* Get slot */
+    trace_slot_struct &slot = Trace::ring[ number & ( TRACE_RING_SIZE - 1 ) ];
+
+    /* Check that event is published */
+    if( (unsigned int) slot.sequence.loadAcquire() != number + 1 )
+        return false;
+
+    /* Copy event */
+    event = slot.event;
+
+    /* Check that slot was not rewritten during copy (full barrier keeps copy before check) */
+    return (unsigned int) slot.sequence.fetchAndAddOrdered( 0 ) == number + 1;
+}
+
+/* Function to get recorded events (oldest first) */
+QList<trace_event_struct> Trace::events()
+{
+    /* Events container */
+    QList<trace_event_struct> result;
+
+    /* Check ring buffer */
+    if( Trace::ring == NULL )
+        return result;
+
+    /* Determine recorded range */
+    unsigned int end = (unsigned int) Trace::head.loadAcquire();
+    unsigned int count = qMin( end, (unsigned int) TRACE_RING_SIZE );
+
+    /* Copy published events */
+    trace_event_struct event;
+    for (unsigned int i = end - count; i != end; i++)
+    {
+        if( Trace::readEvent( i, event ) )
+            result.append( event );
+    }
+
+    /* Return result */
+    return result;
+}
+
+/* Function to get the mean duration of last events of a zone (in milliseconds, -1 if none) */
+double Trace::average(const char* name, int samples)
+{
+    /* Check ring buffer */
+    if( Trace::ring == NULL )
+        return -1.0;
+
+    /* Determine recorded range (only recent events are scanned) */
+    unsigned int end = (unsigned int) Trace::head.loadAcquire();
+    unsigned int count = qMin( end, (unsigned int) 4096 );
+
+    /* Accumulate durations of last matching events (unpublished slots are skipped) */
+    qint64 total = 0;
+    int found = 0;
+    trace_event_struct event;
+    for (unsigned int i = 0; i < count && found < samples; i++)
+    {
+        if( !Trace::readEvent( end - 1 - i, event ) )
+            continue;
+
+        if( qstrcmp( event.name, name ) == 0 )
+        {
+            total += event.duration;
+            found++;
+        }
+    }
+
+    /* Return result */
+    return found > 0 ? ( total / 1e6 ) / found : -1.0;
+}
+
+/* Function to get recorded events as Chrome trace-event JSON (chrome://tracing) */
+QByteArray Trace::toChromeJson()
+{
+    /* Threads indexes (small ids are easier to read) */
+    QHash<quintptr, int> threads;
+
+    /* Events array */
+    QJsonArray array;
+    foreach(const trace_event_struct &event, Trace::events())
+    {
+        /* Assign thread index */
+        if( !threads.contains( event.thread ) )
+            threads.insert( event.thread, threads.size() + 1 );
+
+        /* Complete event (times in microseconds) */
+        QJsonObject object;
+        object["name"] = QString::fromLatin1( event.name );
+        object["cat"] = QString("yafdb");
+        object["ph"] = QString("X");
+        object["ts"] = event.start / 1e3;
+        object["dur"] = event.duration / 1e3;
+        object["pid"] = (double) QCoreApplication::applicationPid();
+        object["tid"] = threads.value( event.thread );
+        array.append( object );
+    }
+
+    /* Trace document */
+    QJsonObject root;
+    root["traceEvents"] = array;
+    root["displayTimeUnit"] = QString("ms");
+
+    /* Return result */
+    return QJsonDocument( root ).toJson( QJsonDocument::Compact );
+}
+
+/* Function to write recorded events as Chrome trace-event JSON */
+bool Trace::dump(QString path)
+{
+    /* Serialize events */
+    QByteArray json = Trace::toChromeJson();
+
+    /* Write file */
+    QFile file( path );
+    if( !file.open( QIODevice::WriteOnly ) || file.write( json ) != json.size() )
+        return false;
+
+    /* Return result */
+    return true;
+}
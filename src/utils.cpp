@@ -37,10 +37,96 @@
  */
 
 /* Includes */
+#include <string.h>
+
 #include "utils.h"
+#include "imageconvert.h"
+#include "projection.h"
+
+/* Function to release an IplImage wrapped by a QImage */
+static void releaseWrappedIplImage(void *info)
+{
+    /* Release image */
+    IplImage *iplImg = (IplImage *) info;
+    cvReleaseImage( &iplImg );
+}
 
 /* Function to convert an OpenCV IplImage into a QImage */
-QImage* IplImage2QImage(IplImage *iplImg)
+QImage* IplImage2QImage(IplImage *iplImg, int threads)
+{
+    /* Fallback on reference implementation for non 8 bits images and unsupported channels counts */
+    if( iplImg->depth != IPL_DEPTH_8U || ( iplImg->nChannels != 1 && iplImg->nChannels != 3 && iplImg->nChannels != 4 ) )
+        return IplImage2QImageReference( iplImg );
+
+    /* Save image dismensions */
+    int h = iplImg->height;
+    int w = iplImg->width;
+
+    /* Get image channels */
+    int channels = iplImg->nChannels;
+
+    /* Allocate destination image */
+    QImage *qimg = new QImage(w, h, channels == 4 ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+
+    /* Get destination image data */
+    uchar *bits = qimg->bits();
+    int bytes_per_line = qimg->bytesPerLine();
+
+    /* Iterate over image rows */
+    #pragma omp parallel for num_threads( threads ) schedule( static )
+    for (int y = 0; y < h; y++)
+    {
+        /* Get source and destination rows */
+        const uchar *src = (const uchar *) iplImg->imageData + (y * iplImg->widthStep);
+        QRgb *dst = (QRgb *) (bits + (y * bytes_per_line));
+
+        /* Channels switch */
+        switch(channels)
+        {
+        case 1:
+            convertRowGray(src, dst, w);
+            break;
+        case 3:
+            convertRowBGR(src, dst, w);
+            break;
+        case 4:
+
+            /* BGRA rows already match ARGB32 layout */
+            memcpy(dst, src, w * 4);
+            break;
+        }
+    }
+    return qimg;
+}
+
+/* Function to convert an OpenCV IplImage into a QImage, taking ownership of the IplImage */
+QImage* IplImage2QImageAdopt(IplImage *iplImg, int threads)
+{
+    /* Check if decoded buffer already matches ARGB32 layout */
+    if( iplImg->depth == IPL_DEPTH_8U && iplImg->nChannels == 4 && iplImg->dataOrder == IPL_DATA_ORDER_PIXEL )
+    {
+        /* Wrap decoded buffer without copy, released with the QImage */
+        return new QImage((uchar *) iplImg->imageData,
+                          iplImg->width,
+                          iplImg->height,
+                          iplImg->widthStep,
+                          QImage::Format_ARGB32,
+                          releaseWrappedIplImage,
+                          iplImg);
+    }
+
+    /* Convert image */
+    QImage *qimg = IplImage2QImage( iplImg, threads );
+
+    /* Release source image */
+    cvReleaseImage( &iplImg );
+
+    /* Return result */
+    return qimg;
+}
+
+/* Function to convert an OpenCV IplImage into a QImage, reference per-pixel implementation */
+QImage* IplImage2QImageReference(IplImage *iplImg)
 {
     /* Save image dismensions */
     int h = iplImg->height;
@@ -112,6 +198,22 @@ QImage* IplImage2QImage(IplImage *iplImg)
 
 /* Function to export an object to disk */
 void exportRect(ObjectRect *rect, image_info_struct image_info, QString destination, float zoom_level)
+{
+    /* Get selection from object's points */
+    QRect rect_sel = exportSelection( rect, zoom_level );
+
+    /* Check if rect and selection sizes are correct */
+    if( rect->getSize().width() >= 1 &&
+           rect->getSize().height() >= 1 &&
+           !rect_sel.isEmpty() )
+    {
+        /* Project and save image */
+        exportImage( rect, image_info, rect_sel, zoom_level ).save( destination );
+    }
+}
+
+/* Function to get an object export selection (in its zoomed projection view) */
+QRect exportSelection(ObjectRect* rect, float zoom_level)
 {
     /* Copy object */
     ObjectRect* rect_mapped = rect->copy();
@@ -135,40 +237,51 @@ void exportRect(ObjectRect *rect, image_info_struct image_info, QString destinat
     /* Delete temp rect */
     delete rect_mapped;
 
-    /* Create temporary destination image */
-    QImage temp_dest(rect->proj_width(), rect->proj_height(), QImage::Format_RGB32);
+    /* Return selection */
+    return rect_sel;
+}
+
+/* Function to project an object export selection */
+QImage exportImage(ObjectRect* rect, const image_info_struct &image_info, QRect selection, float zoom_level, int threads)
+{
+    /* Create destination image (selection only) */
+    QImage temp_dest(selection.size(), QImage::Format_RGB32);
 
-    /* Determine best number of threads */
-    int threads_count = QThread::idealThreadCount();
+    /* Compute selection source coordinates (one-shot, kept out of the viewer frames maps cache) */
+    QVector<qint32> coords( 2 * selection.width() * selection.height() );
+    projection_coordinates(
+        coords.data(),
+        image_info.width,
+        image_info.height,
+        rect->proj_width(),
+        rect->proj_height(),
+        selection.x(),
+        selection.y(),
+        selection.width(),
+        selection.height(),
+        rect->proj_azimuth(),
+        rect->proj_elevation(),
+        rect->proj_aperture() / zoom_level,
+        threads
+    );
 
-    /* Check if rect sizes are correct */
-    if( rect->getSize().width() >= 1 &&
-           rect->getSize().height() >= 1 )
-    {
+    /* Project gnomonic image */
+    projection_gather(
+        coords.constData(),
+        ( const QRgb * ) image_info.image->constBits(),
+        image_info.width,
+        image_info.height,
+        image_info.image->bytesPerLine() / 4,
+        ( QRgb * ) temp_dest.bits(),
+        selection.width(),
+        selection.height(),
+        temp_dest.bytesPerLine() / 4,
+        ProjectionInterpolation::Bilinear,
+        threads
+    );
 
-        /* Project gnomonic image */
-        lg_etg_apperturep(
-
-            ( inter_C8_t * ) image_info.image->bits(),
-            image_info.width,
-            image_info.height,
-            image_info.channels,
-            ( inter_C8_t * ) temp_dest.bits(),
-            rect->proj_width(),
-            rect->proj_height(),
-            image_info.channels,
-            rect->proj_azimuth(),
-            rect->proj_elevation(),
-            0.0,
-            rect->proj_aperture() / zoom_level,
-            li_bilinearf,
-            threads_count
-        );
-
-        /* Crop and save image */
-        QImage element = temp_dest.copy(rect_sel);
-        element.save( destination );
-    }
+    /* Return image */
+    return temp_dest;
 }
 
 /* Function to clamp a specified value */
@@ -0,0 +1,177 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "validationsession.h"
+
+/* Constructor */
+ValidationSession::ValidationSession()
+{
+}
+
+/* Function to open a yafdb blurring directory (state file is relative to it), returns false if invalid */
+bool ValidationSession::open(QString path, QString state_path, bool revalidate)
+{
+    /* Blurring and results directories */
+    QDir blurring( path );
+    QDir results( blurring.absoluteFilePath( ".." ) );
+
+    /* Check for YML directory */
+    if( !QFileInfo( blurring.absoluteFilePath( "yml_configs" ) ).isDir() )
+    {
+        std::cout << "[ERROR] Directory yml_configs not found in " << path.toStdString() << std::endl;
+        return false;
+    }
+
+    /* Assign state file path and read it */
+    this->state_path = blurring.absoluteFilePath( state_path );
+    this->loadState();
+
+    /* Panoramas name pattern */
+    QRegExp pattern( "result_(\\d+_\\d+)-0-25-1\\.jpeg" );
+
+    /* Reset items */
+    this->items.clear();
+
+    /* Iterate over panoramas */
+    foreach(const QString &name, results.entryList( QStringList() << "result_*-0-25-1.jpeg", QDir::Files, QDir::Name ))
+    {
+        /* Extract timestamp */
+        if( !pattern.exactMatch( name ) )
+            continue;
+
+        /* Skip validated panoramas unless revalidating */
+        if( !revalidate && this->isValidated( pattern.cap(1) ) )
+            continue;
+
+        /* Append item */
+        validation_item_struct item;
+        item.timestamp = pattern.cap(1);
+        item.image_path = results.absoluteFilePath( name );
+        item.detector_yml_path = blurring.absoluteFilePath( "yml_configs/result_" + item.timestamp + ".yml" );
+        item.destination_yml_path = blurring.absoluteFilePath( "yml_configs/result_" + item.timestamp + "_v2.yml" );
+        this->items.append( item );
+    }
+
+    /* Return result */
+    return true;
+}
+
+/* Function to get number of items to validate */
+int ValidationSession::count()
+{
+    /* Return value */
+    return this->items.size();
+}
+
+/* Function to get specified item */
+validation_item_struct ValidationSession::item(int index)
+{
+    /* Return value */
+    return this->items.at( index );
+}
+
+/* Function to check if a timestamp is marked as validated */
+bool ValidationSession::isValidated(QString timestamp)
+{
+    /* Return result */
+    return this->state.contains( timestamp );
+}
+
+/* Function to mark a timestamp as validated (state file is rewritten atomically) */
+bool ValidationSession::markValidated(QString timestamp)
+{
+    /* Skip already validated timestamps */
+    if( this->isValidated( timestamp ) )
+        return true;
+
+    /* Append timestamp */
+    this->state.append( timestamp );
+
+    /* Write state file */
+    return this->saveState();
+}
+
+/* Function to read validated timestamps from state file */
+void ValidationSession::loadState()
+{
+    /* Reset state */
+    this->state.clear();
+
+    /* Open state file (missing file means nothing is validated) */
+    QFile file( this->state_path );
+    if( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+        return;
+
+    /* Read one timestamp per line */
+    QTextStream stream( &file );
+    while( !stream.atEnd() )
+    {
+        QString line = stream.readLine().trimmed();
+        if( line.length() > 0 )
+            this->state.append( line );
+    }
+}
+
+/* Function to write validated timestamps to state file */
+bool ValidationSession::saveState()
+{
+    /* Open temporary file, renamed over the state file on commit */
+    QSaveFile file( this->state_path );
+    if( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )
+    {
+        std::cout << "[ERROR] Unable to write state file " << this->state_path.toStdString() << std::endl;
+        return false;
+    }
+
+    /* Write one timestamp per line */
+    QTextStream stream( &file );
+    foreach(const QString &timestamp, this->state)
+        stream << timestamp << "\n";
+    stream.flush();
+
+    /* Commit file */
+    if( !file.commit() )
+    {
+        std::cout << "[ERROR] Unable to write state file " << this->state_path.toStdString() << std::endl;
+        return false;
+    }
+
+    /* Return result */
+    return true;
+}
@@ -0,0 +1,182 @@
+/*
+ * yafdb-validate - Yafdb validation tool
+ *
+ * Copyright (c) 2014-2015 FOXEL SA - http://foxel.ch
+ * Please read <http://foxel.ch/license> for more information.
+ *
+ *
+ * Author(s):
+ *
+ *      Kevin Velickovic <k.velickovic@foxel.ch>
+ *
+ *
+ * This file is part of the FOXEL project <http://foxel.ch>.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Additional Terms:
+ *
+ *      You are required to preserve legal notices and author attributions in
+ *      that material or in the Appropriate Legal Notices displayed by works
+ *      containing it.
+ *
+ *      You are required to attribute the work as explained in the "Usage and
+ *      Attribution" section of <http://foxel.ch/license>.
+ */
+
+/* Includes */
+#include "ymlconverter.h"
+
+/* Constructor (image path is optional, taken from YML when empty) */
+YMLConverter::YMLConverter(QString image_path)
+{
+    /* Assign image path */
+    this->image_path = image_path;
+}
+
+/* Function to get an image size from its header only */
+QSize YMLConverter::imageSize(QString path)
+{
+    /* Read header (pixels are not decoded) */
+    QImageReader reader( path );
+
+    /* Return result */
+    return reader.size();
+}
+
+/* Function to convert detector YMLs on specified number of threads, returns number of failed conversions */
+int YMLConverter::convert(QList<yml_convert_job_struct> jobs, int threads, int* skipped)
+{
+    /* Failed / skipped conversions counters */
+    QAtomicInt failed( 0 );
+    QAtomicInt skipped_count( 0 );
+
+    /* Conversions run on the global pool (Qt5 has no blockingMap on a custom pool) */
+    QThreadPool::globalInstance()->setMaxThreadCount( qMax( 1, threads ) );
+
+    /* Convert all YMLs */
+    QtConcurrent::blockingMap( jobs, YMLConvertFunctor( this, &failed, &skipped_count ) );
+
+    /* Assign skipped count */
+    if( skipped )
+        *skipped = skipped_count.load();
+
+    /* Return result */
+    return failed.load();
+}
+
+/* Function to convert one detector YML */
+YMLConvertStatus::Type YMLConverter::convertJob(const yml_convert_job_struct &job)
+{
+    /* YML Parser */
+    YMLParser yml_parser;
+
+    /* Load rects from YML */
+    QList<ObjectRect*> loaded_rects = yml_parser.loadYML( job.source_path, YMLType::Detector );
+
+    /* Check if there is something to convert (empty YML is still written) */
+    if( loaded_rects.isEmpty() )
+    {
+        /* Write empty YML */
+        if( !yml_parser.writeYML( loaded_rects, job.destination_path ) )
+        {
+            /* Info output */
+            std::cout << "[ERROR] Unable to write " << job.destination_path.toStdString() << std::endl;
+            return YMLConvertStatus::Failed;
+        }
+
+        /* Info output */
+        std::cout << "[WARNING] No objects in " << job.source_path.toStdString() << ", empty YML written" << std::endl;
+        return YMLConvertStatus::Skipped;
+    }
+
+    /* Source image path */
+    QString path = this->image_path;
+
+    /* Take image path from YML if not specified */
+    if( path.isEmpty() )
+    {
+        /* Relative paths are relative to the YML */
+        path = QFileInfo( job.source_path ).absoluteDir().absoluteFilePath( loaded_rects.first()->getSourceImagePath() );
+    }
+
+    /* Read image size from header */
+    QSize size = YMLConverter::imageSize( path );
+
+    /* Check image size */
+    if( !size.isValid() )
+    {
+        /* Info output */
+        std::cout << "[ERROR] Unable to read image size: " << path.toStdString() << std::endl;
+
+        /* Release rects */
+        qDeleteAll( loaded_rects );
+        return YMLConvertStatus::Failed;
+    }
+
+    /* Iterate over loaded rects */
+    foreach(ObjectRect* rect, loaded_rects)
+    {
+        /* Convert spherical coordinates to local gnomonic */
+        rect->mapFromSpherical(size.width(),
+                               size.height(),
+                               1920 / 2,
+                               1080 / 2,
+                               0.0,
+                               0.0,
+                               20.0 * (LG_PI / 180.0),
+                               20.0 * (LG_PI / 180.0),
+                               120.0 * (LG_PI / 180.0));
+    }
+
+    /* Write converted items to YML */
+    bool written = yml_parser.writeYML( loaded_rects, job.destination_path );
+
+    /* Info output */
+    if( !written )
+        std::cout << "[ERROR] Unable to write " << job.destination_path.toStdString() << std::endl;
+
+    /* Release rects */
+    qDeleteAll( loaded_rects );
+
+    /* Return result */
+    return written ? YMLConvertStatus::Converted : YMLConvertStatus::Failed;
+}
+
+/* Constructor */
+YMLConvertFunctor::YMLConvertFunctor(YMLConverter* converter, QAtomicInt* failed, QAtomicInt* skipped)
+{
+    /* Assign values */
+    this->converter = converter;
+    this->failed = failed;
+    this->skipped = skipped;
+}
+
+/* Convert function */
+void YMLConvertFunctor::operator()(const yml_convert_job_struct &job)
+{
+    /* Convert YML and count failures / skips */
+    switch( this->converter->convertJob( job ) )
+    {
+    case YMLConvertStatus::Failed:
+        this->failed->fetchAndAddOrdered( 1 );
+        break;
+    case YMLConvertStatus::Skipped:
+        this->skipped->fetchAndAddOrdered( 1 );
+        break;
+    default:
+        break;
+    }
+}
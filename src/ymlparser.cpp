@@ -38,40 +38,167 @@
 
 /* Includes */
 #include "ymlparser.h"
+#include "annotationfile.h"
+#include <limits>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Function to flush a directory to disk (renamed entries survive a crash) */
+static bool syncDirectory(QString path)
+{
+    /* Open directory */
+    int descriptor = open( QFile::encodeName( path ).constData(), O_RDONLY | O_DIRECTORY );
+    if( descriptor < 0 )
+        return false;
+
+    /* Flush directory entries */
+    bool success = fsync( descriptor ) == 0;
+    close( descriptor );
+
+    /* Return result */
+    return success;
+}
 
 /* Constructor */
 YMLParser::YMLParser()
 {
+    /* Reset statistics */
+    this->load_stats.bytes = 0;
+    this->load_stats.objects = 0;
+    this->load_stats.elapsed = 0;
+    this->load_stats.streamed = false;
+    this->load_stats.binary = false;
+}
+
+/* Function to get the YML name of a manual status */
+QString YMLParser::manualStatusName(int status)
+{
+    /* Status switch */
+    switch(status)
+    {
+    case ObjectManualStatus::Valid:
+        return "Valid";
+    case ObjectManualStatus::Invalid:
+        return "Invalid";
+    default:
+        return "None";
+    }
+}
+
+/* Function to get a manual status from its YML name (case insensitive) */
+int YMLParser::manualStatusFromName(QString name)
+{
+    /* Convert value to lower case */
+    QString lower = name.toLower();
+
+    /* Return matching status */
+    if( lower == "valid" )
+        return ObjectManualStatus::Valid;
+    if( lower == "invalid" )
+        return ObjectManualStatus::Invalid;
+    return ObjectManualStatus::None;
+}
+
+/* Function to get the YML name of an automatic status */
+QString YMLParser::automaticStatusName(int status)
+{
+    /* Status switch */
+    switch(status)
+    {
+    case ObjectAutomaticStatus::Valid:
+        return "Valid";
+    case ObjectAutomaticStatus::Ratio:
+        return "Ratio";
+    case ObjectAutomaticStatus::Size:
+        return "Size";
+    case ObjectAutomaticStatus::RatioSize:
+        return "Ratio-Size";
+    case ObjectAutomaticStatus::MissingOption:
+        return "MissingOption";
+    default:
+        return "None";
+    }
+}
+
+/* Function to get an automatic status from its YML name (case insensitive, detector names are prefixed by "filtered-") */
+int YMLParser::automaticStatusFromName(QString name, int ymltype)
+{
+    /* Convert value to lower case */
+    QString lower = name.toLower();
+
+    /* Valid status is the same for both YML types */
+    if( lower == "valid" )
+        return ObjectAutomaticStatus::Valid;
+
+    /* Remove detector filters prefix */
+    if( ymltype == YMLType::Detector )
+    {
+        /* Only filtered statuses are known */
+        if( !lower.startsWith( "filtered-" ) )
+            return ObjectAutomaticStatus::None;
+
+        /* Remove prefix */
+        lower = lower.mid( 9 );
+
+    /* Validator only status */
+    } else if( lower == "missingoption" ) {
+        return ObjectAutomaticStatus::MissingOption;
+    }
+
+    /* Return matching filter status */
+    if( lower == "ratio" )
+        return ObjectAutomaticStatus::Ratio;
+    if( lower == "size" )
+        return ObjectAutomaticStatus::Size;
+    if( lower == "ratio-size" )
+        return ObjectAutomaticStatus::RatioSize;
+    return ObjectAutomaticStatus::None;
+}
+
+/* Function to write ObjectRect list to YML file on disk (atomically) */
+bool YMLParser::writeYML(QList<ObjectRect*> objects, QString path)
+{
+    /* Write objects snapshot */
+    return this->writeSnapshot( AnnotationFile::serialize( objects ), path );
 }
 
-/* Function to write ObjectRect list to YML file on disk */
-void YMLParser::writeYML(QList<ObjectRect*> objects, QString path)
+/* Function to write objects snapshot (see AnnotationFile::serialize) to YML file on disk (atomically) */
+bool YMLParser::writeSnapshot(const QByteArray &snapshot, QString path)
 {
-    /* Open storage for writing */
-    cv::FileStorage fs(path.toStdString(), cv::FileStorage::WRITE);
+    /* Trace zone */
+    TraceZone zone( "YMLParser::writeSnapshot" );
+
+    /* Parse snapshot */
+    annotation_view_struct view;
+    if( !AnnotationFile::parse( (const uchar*)snapshot.constData(), snapshot.size(), view ) )
+        return false;
+
+    /* Open in memory storage for writing */
+    cv::FileStorage fs(".yml", cv::FileStorage::WRITE + cv::FileStorage::MEMORY);
 
     /* Write source file path */
-    fs << "source_image" << objects.first()->getSourceImagePath().toStdString();
+    fs << "source_image" << view.source_image.toStdString();
 
     /* Write objects */
     fs << "objects" << "[";
 
     /* Iterate over objects */
-    foreach (ObjectRect* obj, objects) {
+    for( quint32 i = 0; i < view.header.objects; i++ ) {
 
         /* Open array element */
         fs << "{";
 
         /* Write object */
-        this->writeItem(fs, obj);
+        this->writeItem(fs, view.records[i]);
 
         /* Write childrens if present */
-        if(obj->childrens.length() > 0)
+        if(view.childrens[i].count > 0)
         {
             fs << "childrens" << "[";
-            foreach (ObjectRect* child, obj->childrens) {
+            for( quint32 j = 0; j < view.childrens[i].count; j++ ) {
                 fs << "{";
-                    this->writeItem(fs, child);
+                    this->writeItem(fs, view.records[view.header.objects + view.childrens[i].first + j]);
                 fs << "}";
             }
             fs << "]";
@@ -83,17 +210,415 @@ void YMLParser::writeYML(QList<ObjectRect*> objects, QString path)
 
     /* Close array */
     fs << "]";
+
+    /* Retrieve YML content */
+    std::string content = fs.releaseAndGetString();
+
+    /* Write to temporary file, flush it to disk and rename it over destination */
+    QSaveFile file( path );
+    if( !file.open( QIODevice::WriteOnly ) )
+        return false;
+    if( file.write( content.data(), content.size() ) != (qint64)content.size() )
+        return false;
+    if( !file.commit() )
+        return false;
+
+    /* Flush rename to disk (best effort, not all file systems sync directories) */
+    syncDirectory( QFileInfo( path ).absolutePath() );
+    return true;
 }
 
 /* Function load ObjectRect list from YML file on disk */
 QList<ObjectRect*> YMLParser::loadYML(QString path, int ymltype)
 {
+    /* Trace zone */
+    TraceZone zone( "YMLParser::loadYML" );
+
     /* Init output list */
     QList<ObjectRect*> out_list;
 
+    /* Source image path (read once) */
+    QString source_image;
+
+    /* Start timer */
+    QElapsedTimer timer;
+    timer.start();
+
+    /* Read up to date binary sidecar of validator YMLs */
+    this->load_stats.binary = ( ymltype == YMLType::Validator && AnnotationFile::isCurrent( path ) &&
+                                AnnotationFile::read( AnnotationFile::sidecarPath( path ), out_list ) );
+    this->load_stats.streamed = false;
+
+    /* Parse YML file */
+    if( !this->load_stats.binary )
+    {
+        /* Stream YML file, fallback to cv::FileStorage on unsupported content */
+        this->load_stats.streamed = this->streamYML( path, ymltype, out_list, source_image );
+        if( !this->load_stats.streamed )
+            this->storageYML( path, ymltype, out_list, source_image );
+
+        /* Assign source image path */
+        foreach(ObjectRect* object, out_list)
+            object->setSourceImagePath( source_image );
+    }
+
+    /* Update statistics */
+    this->load_stats.elapsed = timer.nsecsElapsed();
+    this->load_stats.bytes = QFileInfo( this->load_stats.binary ? AnnotationFile::sidecarPath( path ) : path ).size();
+    this->load_stats.objects = out_list.size();
+
+    /* Return results */
+    return out_list;
+}
+
+/* Function to get statistics of last loaded YML */
+yml_load_stats_struct YMLParser::loadStats()
+{
+    return this->load_stats;
+}
+
+/* Function to print statistics of last loaded YML (parse throughput) */
+void YMLParser::printLoadStats(QString path)
+{
+    /* Elapsed time in seconds */
+    double seconds = qMax( this->load_stats.elapsed, (qint64)1 ) / 1e9;
+
+    /* Info output */
+    std::cout << "Loaded " << this->load_stats.objects << " objects from " << path.toStdString()
+              << " in " << ( seconds * 1e3 ) << " ms ("
+              << ( this->load_stats.bytes / seconds / 1e6 ) << " MB/s, "
+              << ( this->load_stats.objects / seconds ) << " objects/s, "
+              << ( this->load_stats.binary ? "binary sidecar" : ( this->load_stats.streamed ? "streaming" : "FileStorage" ) ) << ")" << std::endl;
+}
+
+/* Function to mark an object loaded from invalid objects list */
+void YMLParser::setInvalid(ObjectRect* object)
+{
+    /* Assign object automatic state / status */
+    object->setObjectAutomaticState( ObjectAutomaticState::Invalid );
+    object->setAutomaticStatus( object->getAutomaticStatus() == ObjectAutomaticStatus::None ? ObjectAutomaticStatus::MissingOption : object->getAutomaticStatus() );
+}
+
+/* Function to load YML file in a single pass over memory mapped file (returns false if unsupported) */
+bool YMLParser::streamYML(QString path, int ymltype, QList<ObjectRect*> &out_list, QString &source_image)
+{
+    /* Open file */
+    QFile file( path );
+    if( !file.open( QIODevice::ReadOnly ) || file.size() <= 0 )
+        return false;
+
+    /* Map file in memory */
+    const char* data = (const char*)file.map( 0, file.size() );
+    if( !data )
+        return false;
+
+    /* End of data */
+    const char* data_end = data + file.size();
+
+    /* Loaded objects (objects, invalidObjects) */
+    QList<ObjectRect*> lists[2];
+
+    /* Current top level object tags */
+    yml_item_struct current;
+
+    /* Open blocks stack */
+    QVector<yml_frame_struct> stack;
+    yml_frame_struct root = { -1, YMLFrame::Root, 0, NULL };
+    stack.append( root );
+
+    /* Parsing status */
+    bool valid = true;
+
+    /* Iterate over lines (one more iteration at end of data closes all blocks) */
+    const char* line = data;
+    while( valid )
+    {
+        /* End of data */
+        bool eof = ( line >= data_end );
+
+        /* Find end of line */
+        const char* eol = eof ? data_end : (const char*)memchr( line, '\n', data_end - line );
+        if( !eol ) eol = data_end;
+        const char* next = eol < data_end ? eol + 1 : data_end;
+        const char* stop = eol;
+        if( stop > line && stop[-1] == '\r' ) stop--;
+
+        /* Skip indentation */
+        const char* p = line;
+        while( p < stop && *p == ' ' ) p++;
+
+        /* Tabs are not allowed as indentation */
+        if( p < stop && *p == '\t' )
+        {
+            valid = false;
+            break;
+        }
+
+        /* Skip empty lines, comments, directives and document markers */
+        if( !eof && ( p == stop || *p == '#' || *p == '%' || ( stop - p >= 3 && strncmp( p, "---", 3 ) == 0 ) ) )
+        {
+            line = next;
+            continue;
+        }
+
+        /* Line indentation (end of data closes all blocks) */
+        int indent = eof ? -1 : p - line;
+
+        /* Sequence item line */
+        bool dash = !eof && *p == '-' && ( p + 1 == stop || p[1] == ' ' );
+
+        /* Close blocks ended by this line */
+        while( stack.size() > 1 &&
+               ( stack.last().indent > indent ||
+                 ( stack.last().indent == indent && !( dash && stack.last().kind == YMLFrame::List ) ) ) )
+        {
+            /* Build top level object when its block ends */
+            if( stack.last().item == &current && stack.last().kind == YMLFrame::Item )
+            {
+                /* Convert tags to object */
+                ObjectRect* object = this->readItem( current, ymltype );
+
+                /* Invalid objects list */
+                if( stack.last().list == 1 )
+                    this->setInvalid( object );
+
+                /* Append to list */
+                lists[stack.last().list].append( object );
+            }
+
+            /* Close block */
+            stack.removeLast();
+        }
+
+        /* Stop at end of data */
+        if( eof )
+            break;
+
+        /* Current block */
+        yml_frame_struct top = stack.last();
+
+        /* Ignore content of unknown blocks */
+        if( top.kind == YMLFrame::Skip )
+        {
+            line = next;
+            continue;
+        }
+
+        /* Sequence item */
+        if( dash )
+        {
+            /* Only objects lists are expected */
+            if( top.kind != YMLFrame::List )
+            {
+                valid = false;
+                break;
+            }
+
+            /* Initialize item tags */
+            yml_item_struct* item = NULL;
+            if( top.item == NULL )
+            {
+                current = yml_item_struct();
+                item = &current;
+            } else {
+                top.item->childrens.append( yml_item_struct() );
+                item = &top.item->childrens.last();
+            }
+
+            /* Open item block */
+            yml_frame_struct frame = { indent, YMLFrame::Item, top.list, item };
+            stack.append( frame );
+            top = frame;
+
+            /* Skip dash */
+            p++;
+            while( p < stop && *p == ' ' ) p++;
+
+            /* Item keys start on next line */
+            if( p == stop )
+            {
+                line = next;
+                continue;
+            }
+        }
+
+        /* Find key separator */
+        const char* colon = p;
+        while( colon < stop && !( *colon == ':' && ( colon + 1 == stop || colon[1] == ' ' ) ) ) colon++;
+
+        /* Only mappings are expected */
+        if( colon == stop || top.kind == YMLFrame::List )
+        {
+            valid = false;
+            break;
+        }
+
+        /* Key and value bounds */
+        QByteArray key = QByteArray::fromRawData( p, colon - p );
+        const char* value = colon + 1;
+        const char* value_end = stop;
+        while( value < value_end && *value == ' ' ) value++;
+        while( value_end > value && value_end[-1] == ' ' ) value_end--;
+
+        /* Block starts on next line */
+        bool block = ( value == value_end );
+
+        /* Key column */
+        int column = p - line;
+
+        /* Block kind switch */
+        switch( top.kind )
+        {
+
+        /* Document root */
+        case YMLFrame::Root:
+
+            if( key == "source_image" && !block )
+            {
+                valid = YMLParser::parseScalar( value, value_end, source_image );
+
+            } else if( key == "objects" || key == "invalidObjects" ) {
+
+                /* Open objects list */
+                if( block )
+                {
+                    yml_frame_struct frame = { column, YMLFrame::List, key == "objects" ? 0 : 1, NULL };
+                    stack.append( frame );
+
+                /* Only empty flow lists are supported */
+                } else if( QByteArray::fromRawData( value, value_end - value ) != "[]" ) {
+                    valid = false;
+                }
+
+            } else if( block ) {
+
+                /* Ignore unknown block */
+                yml_frame_struct frame = { column, YMLFrame::Skip, 0, NULL };
+                stack.append( frame );
+            }
+            break;
+
+        /* Object */
+        case YMLFrame::Item:
+
+            if( block )
+            {
+                /* Open object sub-block */
+                yml_frame_struct frame = { column, YMLFrame::Skip, top.list, top.item };
+                if( key == "area" )
+                    frame.kind = YMLFrame::Area;
+                else if( key == "params" )
+                    frame.kind = YMLFrame::Params;
+                else if( key == "childrens" )
+                    frame.kind = YMLFrame::List;
+                stack.append( frame );
+
+            } else if( key == "className" ) {
+                valid = YMLParser::parseScalar( value, value_end, top.item->className );
+            } else if( key == "subClassName" ) {
+                valid = YMLParser::parseScalar( value, value_end, top.item->subClassName );
+            } else if( key == "autoStatus" ) {
+                valid = YMLParser::parseScalar( value, value_end, top.item->autoStatus );
+            } else if( key == "manualStatus" ) {
+                valid = YMLParser::parseScalar( value, value_end, top.item->manualStatus );
+            } else if( key == "falsePositive" ) {
+                valid = YMLParser::parseScalar( value, value_end, top.item->falsePositive );
+            } else if( key == "blurObject" ) {
+                valid = YMLParser::parseScalar( value, value_end, top.item->blurObject );
+            } else if( key == "area" || key == "params" ) {
+
+                /* Flow mappings are not supported */
+                valid = false;
+
+            } else if( key == "childrens" ) {
+
+                /* Only empty flow lists are supported */
+                valid = ( QByteArray::fromRawData( value, value_end - value ) == "[]" );
+            }
+            break;
+
+        /* Object area */
+        case YMLFrame::Area:
+
+            /* Parse area point */
+            if( key.size() == 2 && key[0] == 'p' && key[1] >= '1' && key[1] <= '4' )
+            {
+                valid = !block && YMLParser::parsePoint( value, value_end, top.item->area[key[1] - '1'] );
+
+            } else if( block ) {
+
+                /* Ignore unknown block */
+                yml_frame_struct frame = { column, YMLFrame::Skip, 0, NULL };
+                stack.append( frame );
+            }
+            break;
+
+        /* Object projection parameters */
+        case YMLFrame::Params:
+        {
+            /* Parameter destination */
+            float* parameter = NULL;
+            if( key == "azimuth" )
+                parameter = &top.item->azimuth;
+            else if( key == "elevation" )
+                parameter = &top.item->elevation;
+            else if( key == "aperture" )
+                parameter = &top.item->aperture;
+            else if( key == "width" )
+                parameter = &top.item->width;
+            else if( key == "height" )
+                parameter = &top.item->height;
+
+            /* Parse parameter */
+            if( parameter )
+            {
+                double number = 0.0;
+                valid = !block && YMLParser::parseNumber( value, value_end, number );
+                *parameter = number;
+
+            } else if( block ) {
+
+                /* Ignore unknown block */
+                yml_frame_struct frame = { column, YMLFrame::Skip, 0, NULL };
+                stack.append( frame );
+            }
+            break;
+        }
+        }
+
+        /* Next line */
+        line = next;
+    }
+
+    /* Release partially loaded objects on unsupported content */
+    if( !valid )
+    {
+        qDeleteAll( lists[0] );
+        qDeleteAll( lists[1] );
+        source_image.clear();
+        return false;
+    }
+
+    /* Assign results (objects first) */
+    out_list = lists[0] + lists[1];
+    return true;
+}
+
+/* Function to load YML file using cv::FileStorage (fallback) */
+bool YMLParser::storageYML(QString path, int ymltype, QList<ObjectRect*> &out_list, QString &source_image)
+{
     /* Read YML file */
     cv::FileStorage fs(path.toStdString(), cv::FileStorage::READ);
 
+    /* Check if file is opened */
+    if( !fs.isOpened() )
+        return false;
+
+    /* Read source image path */
+    std::string source_image_string;
+    fs["source_image"] >> source_image_string;
+    source_image = QString( source_image_string.c_str() );
+
     /* Retrieve objects node */
     cv::FileNode objectsNode = fs["objects"];
 
@@ -103,46 +628,237 @@ QList<ObjectRect*> YMLParser::loadYML(QString path, int ymltype)
     /* Iterate over objects */
     for (cv::FileNodeIterator it = objectsNode.begin(); it != objectsNode.end(); ++it) {
 
-        /* Initialize detected object */
-        ObjectRect* object = this->readItem(it, ymltype);
-
-        /* Assign source image path */
-        std::string source_image;
-        fs["source_image"] >> source_image;
-        object->setSourceImagePath( QString(source_image.c_str()) );
+        /* Read object tags */
+        yml_item_struct item;
+        this->readNode( *it, item );
 
-        /* Append to list */
-        out_list.append(object);
+        /* Initialize detected object and append to list */
+        out_list.append( this->readItem( item, ymltype ) );
     }
 
     /* Iterate over objects */
     for (cv::FileNodeIterator it = invalidObjectsNode.begin(); it != invalidObjectsNode.end(); ++it) {
 
+        /* Read object tags */
+        yml_item_struct item;
+        this->readNode( *it, item );
+
         /* Initialize detected object */
-        ObjectRect* object = this->readItem(it, ymltype);
+        ObjectRect* object = this->readItem( item, ymltype );
 
         /* Assign object automatic state / status */
-        object->setObjectAutomaticState( ObjectAutomaticState::Invalid );
-        object->setAutomaticStatus( (object->getAutomaticStatus().length() <= 0 || object->getAutomaticStatus() == "None") ? "MissingOption" : object->getAutomaticStatus() );
-
-        /* Assign source image path */
-        std::string source_image;
-        fs["source_image"] >> source_image;
-        object->setSourceImagePath( QString(source_image.c_str()) );
+        this->setInvalid( object );
 
         /* Append to list */
         out_list.append(object);
     }
 
-    /* Return results */
-    return out_list;
+    /* Return status */
+    return true;
 }
 
-/* Function to write specific ObjectRect into YML file */
-void YMLParser::writeItem(cv::FileStorage &fs, ObjectRect* obj)
+/* Function to read object tags from a cv::FileStorage node */
+void YMLParser::readNode(const cv::FileNode &node, yml_item_struct &item)
+{
+    /* Parse string tags */
+    std::string value;
+    node["falsePositive"] >> value;
+    item.falsePositive = QString( value.c_str() );
+    value.clear();
+    node["className"] >> value;
+    item.className = QString( value.c_str() );
+    value.clear();
+    node["subClassName"] >> value;
+    item.subClassName = QString( value.c_str() );
+    value.clear();
+    node["autoStatus"] >> value;
+    item.autoStatus = QString( value.c_str() );
+    value.clear();
+    node["manualStatus"] >> value;
+    item.manualStatus = QString( value.c_str() );
+    value.clear();
+    node["blurObject"] >> value;
+    item.blurObject = QString( value.c_str() );
+
+    /* Parse area points */
+    cv::FileNode areaNode = node["area"];
+    const char* names[4] = { "p1", "p2", "p3", "p4" };
+    for( int i = 0; i < 4; i++ )
+    {
+        cv::Point2d point;
+        areaNode[names[i]] >> point;
+        item.area[i] = QPointF( point.x, point.y );
+    }
+
+    /* Parse gnomonic parameters */
+    cv::FileNode paramsNode = node["params"];
+    paramsNode["azimuth"] >> item.azimuth;
+    paramsNode["elevation"] >> item.elevation;
+    paramsNode["aperture"] >> item.aperture;
+    paramsNode["width"] >> item.width;
+    paramsNode["height"] >> item.height;
+
+    /* Parse childrens */
+    cv::FileNode childNode = node["childrens"];
+    for (cv::FileNodeIterator child = childNode.begin(); child != childNode.end(); ++child) {
+        item.childrens.append( yml_item_struct() );
+        this->readNode( *child, item.childrens.last() );
+    }
+}
+
+/* Function to parse a YML scalar (plain or quoted on a single line) */
+bool YMLParser::parseScalar(const char* begin, const char* end, QString &value)
+{
+    /* Double quoted scalar */
+    if( begin < end && *begin == '"' )
+    {
+        /* Unescaped value */
+        QByteArray buffer;
+        const char* p = begin + 1;
+        while( p < end && *p != '"' )
+        {
+            /* Escaped character */
+            if( *p == '\\' && p + 1 < end )
+            {
+                p++;
+                switch( *p )
+                {
+                case 'n': buffer.append( '\n' ); break;
+                case 't': buffer.append( '\t' ); break;
+                case 'r': buffer.append( '\r' ); break;
+                default:  buffer.append( *p );   break;
+                }
+            } else {
+                buffer.append( *p );
+            }
+            p++;
+        }
+
+        /* Multi-line scalars are not supported */
+        if( p == end )
+            return false;
+
+        /* Assign value */
+        value = QString::fromUtf8( buffer );
+        return true;
+    }
+
+    /* Single quoted scalar */
+    if( begin < end && *begin == '\'' )
+    {
+        /* Unescaped value */
+        QByteArray buffer;
+        const char* p = begin + 1;
+        while( p < end )
+        {
+            /* Quote (doubled quotes are escaped quotes) */
+            if( *p == '\'' )
+            {
+                if( p + 1 < end && p[1] == '\'' )
+                    p++;
+                else
+                    break;
+            }
+            buffer.append( *p );
+            p++;
+        }
+
+        /* Multi-line scalars are not supported */
+        if( p == end )
+            return false;
+
+        /* Assign value */
+        value = QString::fromUtf8( buffer );
+        return true;
+    }
+
+    /* Flow collections, block scalars, anchors, aliases and tags are not supported */
+    if( begin < end && strchr( "[]{}|>&*!", *begin ) )
+        return false;
+
+    /* Remove trailing comment */
+    for( const char* p = begin; p < end; p++ )
+    {
+        if( *p == '#' && p > begin && p[-1] == ' ' )
+        {
+            end = p;
+            while( end > begin && end[-1] == ' ' ) end--;
+            break;
+        }
+    }
+
+    /* Assign plain value */
+    value = QString::fromUtf8( begin, end - begin );
+    return true;
+}
+
+/* Function to parse a YML number (locale independent) */
+bool YMLParser::parseNumber(const char* begin, const char* end, double &value)
+{
+    /* Number text */
+    QByteArray number = QByteArray::fromRawData( begin, end - begin );
+
+    /* Special values */
+    if( number == ".Inf" || number == ".inf" || number == "+.Inf" )
+    {
+        value = std::numeric_limits<double>::infinity();
+        return true;
+    }
+    if( number == "-.Inf" || number == "-.inf" )
+    {
+        value = -std::numeric_limits<double>::infinity();
+        return true;
+    }
+    if( number == ".Nan" || number == ".NaN" || number == ".nan" )
+    {
+        value = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+
+    /* Parse number */
+    bool ok = false;
+    value = number.toDouble( &ok );
+    return ok;
+}
+
+/* Function to parse a YML point (flow sequence of two numbers) */
+bool YMLParser::parsePoint(const char* begin, const char* end, QPointF &value)
+{
+    /* Check flow sequence delimiters */
+    if( end - begin < 2 || *begin != '[' || end[-1] != ']' )
+        return false;
+
+    /* Find separator */
+    const char* comma = (const char*)memchr( begin, ',', end - begin );
+    if( !comma || memchr( comma + 1, ',', end - comma - 1 ) )
+        return false;
+
+    /* Coordinates bounds */
+    const char* x_begin = begin + 1;
+    const char* x_end = comma;
+    const char* y_begin = comma + 1;
+    const char* y_end = end - 1;
+    while( x_begin < x_end && *x_begin == ' ' ) x_begin++;
+    while( x_end > x_begin && x_end[-1] == ' ' ) x_end--;
+    while( y_begin < y_end && *y_begin == ' ' ) y_begin++;
+    while( y_end > y_begin && y_end[-1] == ' ' ) y_end--;
+
+    /* Parse coordinates */
+    double x = 0.0;
+    double y = 0.0;
+    if( !YMLParser::parseNumber( x_begin, x_end, x ) || !YMLParser::parseNumber( y_begin, y_end, y ) )
+        return false;
+
+    /* Assign value */
+    value = QPointF( x, y );
+    return true;
+}
+
+/* Function to write specific object record into YML file */
+void YMLParser::writeItem(cv::FileStorage &fs, const annotation_record_struct &record)
 {
     /* Write type */
-    switch(obj->getObjectType())
+    switch(record.type)
     {
     case ObjectType::Face:
         fs << "className" << "Face";
@@ -159,7 +875,7 @@ void YMLParser::writeItem(cv::FileStorage &fs, ObjectRect* obj)
     }
 
     /* Write sub-type */
-    switch(obj->getObjectSubType())
+    switch(record.sub_type)
     {
     case ObjectSubType::None:
         fs << "subClassName" << "None";
@@ -183,49 +899,37 @@ void YMLParser::writeItem(cv::FileStorage &fs, ObjectRect* obj)
 
     /* Write square area coodinates */
     fs << "area" << "{";
-        fs << "p1" << cv::Point2d(obj->proj_point_1().x(), obj->proj_point_1().y());
-        fs << "p2" << cv::Point2d(obj->proj_point_2().x(), obj->proj_point_2().y());
-        fs << "p3" << cv::Point2d(obj->proj_point_3().x(), obj->proj_point_3().y());
-        fs << "p4" << cv::Point2d(obj->proj_point_4().x(), obj->proj_point_4().y());
+        fs << "p1" << cv::Point2d(record.points[0], record.points[1]);
+        fs << "p2" << cv::Point2d(record.points[2], record.points[3]);
+        fs << "p3" << cv::Point2d(record.points[4], record.points[5]);
+        fs << "p4" << cv::Point2d(record.points[6], record.points[7]);
     fs << "}";
 
     /* Write projection parameters */
     fs << "params" << "{";
-        fs << "azimuth" << obj->proj_azimuth();
-        fs << "elevation" << obj->proj_elevation();
-        fs << "aperture" << obj->proj_aperture();
-        fs << "width" << obj->proj_width();
-        fs << "height" << obj->proj_height();
+        fs << "azimuth" << record.params[0];
+        fs << "elevation" << record.params[1];
+        fs << "aperture" << record.params[2];
+        fs << "width" << record.params[3];
+        fs << "height" << record.params[4];
     fs << "}";
 
     /* Write status tags */
-    fs << "autoStatus" << obj->getAutomaticStatus().toStdString();
-    fs << "manualStatus" << obj->getManualStatus().toStdString();
-    fs << "blurObject" << (obj->isBlurred() ? "Yes" : "No");
+    fs << "autoStatus" << YMLParser::automaticStatusName( record.automatic_status ).toStdString();
+    fs << "manualStatus" << YMLParser::manualStatusName( record.manual_status ).toStdString();
+    fs << "blurObject" << (record.blurred ? "Yes" : "No");
 }
 
-/* Function to read specific ObjectRect from YML file */
-ObjectRect* YMLParser::readItem(cv::FileNodeIterator iterator, int ymltype)
+/* Function to read specific ObjectRect from its tags */
+ObjectRect* YMLParser::readItem(const yml_item_struct &item, int ymltype)
 {
     /* Initialize detected object */
     ObjectRect* object = new ObjectRect;
 
-    /* Parse falsePositive tag */
-    std::string falsePositive;
-    (*iterator)["falsePositive"] >> falsePositive;
-    QString lowerFalsePositive = QString( falsePositive.c_str() ).toLower();
-
-    /* Parse class name */
-    std::string className;
-    (*iterator)["className"] >> className;
-
-    /* Parse sub class name */
-    std::string subClassName;
-    (*iterator)["subClassName"] >> subClassName;
-
     /* Convert values to lower case */
-    QString lowerClassName = QString( className.c_str() ).toLower();
-    QString lowerSubClassName = QString( subClassName.c_str() ).toLower();
+    QString lowerFalsePositive = item.falsePositive.toLower();
+    QString lowerClassName = item.className.toLower();
+    QString lowerSubClassName = item.subClassName.toLower();
 
     /* Assign object type */
     if(lowerClassName == "face")
@@ -261,68 +965,49 @@ ObjectRect* YMLParser::readItem(cv::FileNodeIterator iterator, int ymltype)
         object->setObjectSubType( ObjectSubType::Eyes );
     }
 
-    /* Parse area points */
-    cv::FileNode areaNode = (*iterator)["area"];
-    cv::Point2d pt_1;
-    cv::Point2d pt_2;
-    cv::Point2d pt_3;
-    cv::Point2d pt_4;
+    /* Area points */
+    QPointF pt_1;
+    QPointF pt_2;
+    QPointF pt_3;
+    QPointF pt_4;
 
     /* Read coordinates */
     switch(ymltype)
     {
     case YMLType::Detector:
 
-        /* Parse square edges points */
-        areaNode["p1"] >> pt_1;
-        areaNode["p2"] >> pt_3;
+        /* Square edges points */
+        pt_1 = item.area[0];
+        pt_3 = item.area[1];
         break;
     case YMLType::Validator:
 
-        /* Parse polygon points */
-        areaNode["p1"] >> pt_1;
-        areaNode["p2"] >> pt_2;
-        areaNode["p3"] >> pt_3;
-        areaNode["p4"] >> pt_4;
+        /* Polygon points */
+        pt_1 = item.area[0];
+        pt_2 = item.area[1];
+        pt_3 = item.area[2];
+        pt_4 = item.area[3];
         break;
     }
 
     /* Set object coordinates */
-    object->setPoints(QPointF(pt_1.x, pt_1.y),
-                      QPointF(pt_2.x, pt_2.y),
-                      QPointF(pt_3.x, pt_3.y),
-                      QPointF(pt_4.x, pt_4.y));
-
-    /* Parse gnomonic parameters */
-    cv::FileNode paramsNode = (*iterator)["params"];
-    float azimuth = 0.0;
-    float elevation = 0.0;
-    float aperture = 0.0;
-    float width = 0.0;
-    float height = 0.0;
-
-    paramsNode["azimuth"] >> azimuth;
-    paramsNode["elevation"] >> elevation;
-    paramsNode["aperture"] >> aperture;
-    paramsNode["width"] >> width;
-    paramsNode["height"] >> height;
+    object->setPoints(pt_1,
+                      pt_2,
+                      pt_3,
+                      pt_4);
 
     /* Set object projection parameters */
-    object->setProjectionParametters(azimuth,
-                                    elevation,
-                                    aperture,
-                                    width,
-                                    height);
+    object->setProjectionParametters(item.azimuth,
+                                    item.elevation,
+                                    item.aperture,
+                                    item.width,
+                                    item.height);
 
     /* Set object projection points */
     object->setProjectionPoints();
 
-    /* Parse auto status */
-    std::string autoStatus;
-    (*iterator)["autoStatus"] >> autoStatus;
-
-    /* Convert values to lower case */
-    QString lowerAutoStatus = QString( autoStatus.c_str() ).toLower();
+    /* Convert auto status to lower case */
+    QString lowerAutoStatus = item.autoStatus.toLower();
     lowerAutoStatus = lowerAutoStatus.length() > 0 ? lowerAutoStatus : "none";
 
     /* Check presence of auto status */
@@ -333,7 +1018,7 @@ ObjectRect* YMLParser::readItem(cv::FileNodeIterator iterator, int ymltype)
         {
             /* Set values */
             object->setObjectAutomaticState( ObjectAutomaticState::Valid );
-            object->setAutomaticStatus( "Valid" );
+            object->setAutomaticStatus( ObjectAutomaticStatus::Valid );
 
             /* Tag object for blurring */
             if( ymltype == YMLType::Detector )
@@ -344,49 +1029,15 @@ ObjectRect* YMLParser::readItem(cv::FileNodeIterator iterator, int ymltype)
             /* Set automatic state as invalid */
             object->setObjectAutomaticState( ObjectAutomaticState::Invalid );
 
-            /* Restore automatic status */
-            switch(ymltype)
-            {
-            case YMLType::Detector:
-
-                /* Assign proper automatic filtering flag */
-                if( lowerAutoStatus == "filtered-ratio" )
-                {
-                   object->setAutomaticStatus( "Ratio" );
-                } else if( lowerAutoStatus == "filtered-size" ){
-                   object->setAutomaticStatus( "Size" );
-                } else if( lowerAutoStatus == "filtered-ratio-size" ){
-                    object->setAutomaticStatus( "Ratio-Size" );
-                }
-                break;
-            case YMLType::Validator:
-
-                /* Assign proper automatic filtering flag */
-                if( lowerAutoStatus == "ratio" )
-                {
-                   object->setAutomaticStatus( "Ratio" );
-                } else if( lowerAutoStatus == "size" ){
-                   object->setAutomaticStatus( "Size" );
-                } else if( lowerAutoStatus == "ratio-size" ){
-                    object->setAutomaticStatus( "Ratio-Size" );
-                } else if( lowerAutoStatus == "missingoption" ){
-                    object->setAutomaticStatus( "MissingOption" );
-                }
-                break;
-            }
+            /* Restore automatic filtering flag */
+            object->setAutomaticStatus( YMLParser::automaticStatusFromName( item.autoStatus, ymltype ) );
         }
     } else {
         object->setObjectAutomaticState( ObjectAutomaticState::Manual );
     }
 
-    /* Set automatic status to none if null */
-    object->setAutomaticStatus( (object->getAutomaticStatus().length() > 0 ? object->getAutomaticStatus() : "None") );
-
-    /* Parse manual status */
-    std::string manualStatus;
-    (*iterator)["manualStatus"] >> manualStatus;
-    object->setManualStatus( QString(manualStatus.c_str()) );
-    object->setManualStatus( (object->getManualStatus().length() > 0 ? object->getManualStatus() : "None") );
+    /* Restore manual status */
+    object->setManualStatus( YMLParser::manualStatusFromName( item.manualStatus ) );
 
     /* Restore manual status tag */
     /* Check if object is tagged as falsePositive */
@@ -395,11 +1046,11 @@ ObjectRect* YMLParser::readItem(cv::FileNodeIterator iterator, int ymltype)
         /* CHeck if object is manual */
         if(lowerAutoStatus == "none")
         {
-            object->setManualStatus("Valid");
+            object->setManualStatus( ObjectManualStatus::Valid );
         }
     } else if( lowerFalsePositive == "yes" )
     {
-        object->setManualStatus("Invalid");
+        object->setManualStatus( ObjectManualStatus::Invalid );
     }
 
     /* Restore manual state */
@@ -410,10 +1061,10 @@ ObjectRect* YMLParser::readItem(cv::FileNodeIterator iterator, int ymltype)
     } else {
 
         /* Check if object is manual */
-        if(object->getManualStatus() != "None")
+        if(object->getManualStatus() != ObjectManualStatus::None)
         {
             /* CHeck if object manual state is valid */
-            if(object->getManualStatus() == "Valid")
+            if(object->getManualStatus() == ObjectManualStatus::Valid)
             {
                 object->setObjectManualState( ObjectManualState::Valid );
             } else {
@@ -428,18 +1079,15 @@ ObjectRect* YMLParser::readItem(cv::FileNodeIterator iterator, int ymltype)
     /* Restore blur tag */
     if( ymltype == YMLType::Validator )
     {
-        /* Read blur tag */
-        std::string blurObject;
-        (*iterator)["blurObject"] >> blurObject;
-        QString blurObject_lower = QString( blurObject.c_str() ).toLower();
+        /* Convert blur tag to lower case */
+        QString blurObject_lower = item.blurObject.toLower();
 
         /* Set blur tag */
         object->setBlurred( blurObject_lower == "yes" ? true : false );
     }
 
     /* Load childrens */
-    cv::FileNode childNode = (*iterator)["childrens"];
-    for (cv::FileNodeIterator child = childNode.begin(); child != childNode.end(); ++child) {
+    foreach(const yml_item_struct &child, item.childrens) {
         object->childrens.append( this->readItem( child ) );
     }
 
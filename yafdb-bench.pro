@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# Headless benchmarks of yafdb-validate hot paths
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
+
+TARGET = yafdb-bench
+TEMPLATE = app
+CONFIG += console
+
+# Shared sources, flags and libraries
+include(yafdb-validate.pri)
+
+# Include directories
+INCLUDEPATH += $$PWD/bench/
+
+# Source files
+SOURCES += bench/main.cpp \
+    bench/benchmarkreport.cpp
+
+HEADERS  += bench/benchmarkreport.h
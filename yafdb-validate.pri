@@ -0,0 +1,116 @@
+#-------------------------------------------------
+#
+# Shared by yafdb-validate and yafdb-bench
+#
+#-------------------------------------------------
+
+# Libgnomonic settings
+libgnomonic.commands = make -j -C $$PWD/libs/libgnomonic/
+
+QMAKE_EXTRA_TARGETS += libgnomonic
+PRE_TARGETDEPS += libgnomonic
+
+# Include directories
+INCLUDEPATH += $$PWD/include/ \
+    $$PWD/libs/libgnomonic/lib/libinter/src/ \
+    $$PWD/libs/libgnomonic/src/
+
+# Source files
+SOURCES += src/mainwindow.cpp \
+    src/panoramaviewer.cpp \
+    src/batchview.cpp \
+    src/objectitem.cpp \
+    src/objectgrid.cpp \
+    src/ymlparser.cpp \
+    src/annotationfile.cpp \
+    src/annotationsaver.cpp \
+    src/g2g_point.cpp \
+    src/cornermapper.cpp \
+    src/objectindex.cpp \
+    src/objectrect.cpp \
+    src/objectstats.cpp \
+    src/editview.cpp \
+    src/etg_point.cpp \
+    src/utils.cpp \
+    src/exporter.cpp \
+    src/batchexporter.cpp \
+    src/ymlconverter.cpp \
+    src/projection.cpp \
+    src/projectionmap.cpp \
+    src/panoramacache.cpp \
+    src/panoramarenderer.cpp \
+    src/panoramaprefetcher.cpp \
+    src/validationsession.cpp \
+    src/thumbnailloader.cpp \
+    src/imageconvert.cpp \
+    src/trace.cpp \
+    src/jpegdecoder.cpp \
+    src/decodecache.cpp
+
+HEADERS  += include/mainwindow.h \
+    include/panoramaviewer.h \
+    include/batchview.h \
+    include/objectitem.h \
+    include/objectgrid.h \
+    include/ymlparser.h \
+    include/annotationfile.h \
+    include/annotationsaver.h \
+    include/g2g_point.h \
+    include/cornermapper.h \
+    include/objectindex.h \
+    include/objectrect.h \
+    include/objectstats.h \
+    include/editview.h \
+    include/etg_point.h \
+    include/utils.h \
+    include/exporter.h \
+    include/batchexporter.h \
+    include/ymlconverter.h \
+    include/projection.h \
+    include/projectionmap.h \
+    include/panoramacache.h \
+    include/panoramarenderer.h \
+    include/panoramaprefetcher.h \
+    include/validationsession.h \
+    include/thumbnailloader.h \
+    include/imageconvert.h \
+    include/trace.h \
+    include/jpegdecoder.h \
+    include/decodecache.h
+
+# Ui forms
+FORMS    += ui/mainwindow.ui \
+    ui/batchview.ui \
+    ui/editview.ui
+
+# Compiler flags
+QMAKE_CXXFLAGS += -fopenmp
+
+# SIMD flags (SSSE3 rows conversion)
+contains(QT_ARCH, x86_64)|contains(QT_ARCH, i386) {
+    QMAKE_CXXFLAGS += -mssse3
+}
+
+# Libraries
+LIBS += $$PWD/libs/libgnomonic/lib/libinter/bin/libinter.a \
+    $$PWD/libs/libgnomonic/bin/libgnomonic.a \
+    -fopenmp \
+    -ljpeg \
+    -lopencv_calib3d \
+    -lopencv_contrib \
+    -lopencv_core \
+    -lopencv_features2d \
+    -lopencv_flann \
+    -lopencv_gpu \
+    -lopencv_highgui \
+    -lopencv_imgproc \
+    -lopencv_legacy \
+    -lopencv_ml \
+    -lopencv_objdetect \
+    -lopencv_ocl \
+    -lopencv_photo \
+    -lopencv_stitching \
+    -lopencv_superres \
+    -lopencv_ts \
+    -lopencv_video \
+    -lopencv_videostab